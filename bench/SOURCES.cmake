@@ -0,0 +1,12 @@
+# automatically generated by `glob_sources()`
+set(
+    SOURCES
+    corpus.cpp
+    corpus.h
+    diagnostic/print.cpp
+    lex/keywords.cpp
+    lex/tokenize.cpp
+    syntax/parse.cpp
+    util/small_vector.cpp
+    PARENT_SCOPE
+)
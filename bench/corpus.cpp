@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "corpus.h"
+
+namespace fp::bench {
+
+std::string repeat(std::string_view snippet, size_t size) {
+    std::string result;
+    result.reserve(size + snippet.size());
+    while (result.size() < size) { result += snippet; }
+    return result;
+}
+
+/// Returns random bytes (like a binary file given as source code).
+static std::string random_bytes() {
+    std::mt19937 random(1);
+    std::string content(corpus_size, '\0');
+    for (char& c : content) { c = char(random()); }
+    return content;
+}
+
+/// Returns the content of all source files in the `example/` directory.
+static std::string read_examples() {
+    std::vector<std::filesystem::path> paths;
+    for (
+        const auto& entry :
+        std::filesystem::recursive_directory_iterator(FP_EXAMPLE_DIR)
+    ) {
+        if (entry.path().extension() == ".fp") {
+            paths.push_back(entry.path());
+        }
+    }
+    // directory iteration order is unspecified
+    std::sort(paths.begin(), paths.end());
+
+    std::string content;
+    for (const auto& path : paths) {
+        std::ifstream file(path);
+        std::ostringstream ss;
+        ss << file.rdbuf();
+        content += ss.str();
+        content += '\n';
+    }
+    return content;
+}
+
+const std::vector<corpus>& corpora() {
+    static const std::vector<corpus> corpora = {
+        {
+            "identifiers",
+            repeat(
+                "if is_valid and not done { count = count + 1 } "
+                "else { result = make_node(left_child, right_child) }\n"
+            )
+        },
+        {
+            "numbers",
+            repeat("0 42 1234567 0x1F 0b1010 0o17 3.14 1.5e10 6.02e-23 1e9\n")
+        },
+        {
+            "strings",
+            repeat(
+                "\"hello, {\"from the other {\"side of the plant\"}...\"}\" "
+                "\"x = {x}, y = {y}, sum = {x + y}\"\n"
+            )
+        },
+        {
+            "interpolations",
+            repeat(
+                "\"look, {\"a wild brace:\" { 3 { 4 } 1 + 1 } \"bla\" }\" "
+                "\"{\"{\"{\"{\"{\"{\"six levels deep\"}\"}\"}\"}\"}\"}\" "
+                "\"{a}{b}{c}{d}{e}{f}{g}{h}\"\n"
+            )
+        },
+        {
+            "errors",
+            repeat("x $ y ` z \x01 \xCE\xBB 12z4 '' \"\\q\"\n")
+        },
+        {
+            "binary",
+            random_bytes()
+        },
+        {
+            "examples",
+            repeat(read_examples())
+        }
+    };
+    return corpora;
+}
+
+} // namespace fp::bench
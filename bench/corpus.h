@@ -0,0 +1,61 @@
+#pragma once
+
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace fp::bench {
+
+/// A named piece of source code that benchmarks run on.
+struct corpus {
+    std::string name;
+    std::string content;
+};
+
+/// The size (in bytes) of each of the benchmarked corpora.
+constexpr size_t corpus_size = 256 * 1024;
+
+/// Repeats the given `snippet` until reaching (at least) `size` bytes.
+std::string repeat(std::string_view snippet, size_t size = corpus_size);
+
+/**
+ * Returns the corpora that tokenization is benchmarked on:
+ *  - "identifiers": mostly identifiers and keywords.
+ *  - "numbers": mostly integer and floating-point literals.
+ *  - "strings": nested string interpolations.
+ *  - "interpolations": many, and deeply nested, string interpolations.
+ *  - "errors": mostly invalid tokens (stray and unicode characters).
+ *  - "binary": random bytes (like a binary file given by mistake).
+ *  - "examples": the source files of the `example/` directory.
+ */
+const std::vector<corpus>& corpora();
+
+/**
+ * Reports the throughput of a benchmark that processes `bytes` bytes of source
+ * code and `tokens` tokens in each iteration (as bytes/sec and tokens/sec).
+ */
+inline void set_throughput(
+    benchmark::State& state,
+    size_t bytes,
+    size_t tokens
+) {
+    state.SetBytesProcessed(int64_t(state.iterations() * bytes));
+    state.counters["tokens"] = benchmark::Counter(
+        double(state.iterations() * tokens),
+        benchmark::Counter::kIsRate
+    );
+}
+
+/// A stream buffer that discards everything written to it.
+struct null_buffer : std::streambuf {
+    int_type overflow(int_type c) override { return c; }
+
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        return n;
+    }
+};
+
+} // namespace fp::bench
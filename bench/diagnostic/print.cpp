@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <ostream>
+
+#include <benchmark/benchmark.h>
+
+#include <fp/diagnostic/print/to_terminal.h>
+#include <fp/lex/tokenize.h>
+#include <fp/source_map.h>
+
+#include "../corpus.h"
+
+namespace fp::diagnostic {
+
+/**
+ * Prints the problems reported when tokenizing the "errors" corpus.
+ *
+ * If `generated`, the corpus is treated as a generated file, with a source
+ * map segment for each of its lines (all of them mapped to a one-line
+ * template), so the problems are printed at their original locations.
+ */
+template <bool generated>
+static void print_report_to_terminal(benchmark::State& state) {
+    const auto& corpora = bench::corpora();
+    const bench::corpus& errors = *std::find_if(
+        corpora.begin(), corpora.end(),
+        [](const bench::corpus& c) { return c.name == "errors"; }
+    );
+    source_file file("", errors.content);
+    diagnostic::report report;
+    symbol_table symbols;
+    report.set_error_budget(std::numeric_limits<size_t>::max());
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+
+    std::string_view content = errors.content;
+    source_file template_file(
+        "template.fp",
+        content.substr(0, content.find('\n') + 1)
+    );
+    if constexpr (generated) {
+        auto map = std::make_unique<source_map>();
+        size_t line_size = template_file.content.size();
+        for (size_t i = 0; i + line_size <= content.size(); i += line_size) {
+            map->add(i, line_size, template_file, 0);
+        }
+        file.set_origin(std::move(map));
+    }
+
+    bench::null_buffer buffer;
+    std::ostream os(&buffer);
+    for (auto _ : state) {
+        print::to_terminal(os, report);
+    }
+    state.SetItemsProcessed(
+        int64_t(state.iterations() * report.errors().size())
+    );
+    bench::set_throughput(state, errors.content.size(), tokens.size());
+}
+BENCHMARK(print_report_to_terminal<false>);
+BENCHMARK(print_report_to_terminal<true>);
+
+} // namespace fp::diagnostic
@@ -0,0 +1,57 @@
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <fp/lex/keywords.h>
+
+namespace fp::lex {
+
+/// A mix of keywords and (mostly keyword-like) identifiers.
+static std::vector<std::string> words() {
+    const std::string_view identifiers[] = {
+        "x", "i", "f", "iff", "form", "value", "count", "define", "node",
+        "tokens", "result", "parse_expression"
+    };
+    std::mt19937 random(1);
+    std::vector<std::string> words;
+    for (size_t i = 0; i < 4096; ++i) {
+        if (random() % 4 == 0) {
+            words.emplace_back(keywords[random() % keywords.size()].name);
+        } else {
+            words.emplace_back(identifiers[random() % std::size(identifiers)]);
+        }
+    }
+    return words;
+}
+
+/// Looks up keywords using lex::find_keyword (a compile-time perfect hash).
+static void find_keyword_perfect_hash(benchmark::State& state) {
+    std::vector<std::string> words = lex::words();
+    for (auto _ : state) {
+        for (const std::string& word : words) {
+            benchmark::DoNotOptimize(find_keyword(word));
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * words.size()));
+}
+BENCHMARK(find_keyword_perfect_hash);
+
+/// Looks up keywords in an std::unordered_map (as a baseline).
+static void find_keyword_unordered_map(benchmark::State& state) {
+    std::unordered_map<std::string_view, token> map;
+    for (const keyword& k : keywords) { map.emplace(k.name, k.token); }
+    std::vector<std::string> words = lex::words();
+    for (auto _ : state) {
+        for (const std::string& word : words) {
+            benchmark::DoNotOptimize(map.find(word));
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * words.size()));
+}
+BENCHMARK(find_keyword_unordered_map);
+
+} // namespace fp::lex
@@ -0,0 +1,190 @@
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <fp/lex/token_cursor.h>
+#include <fp/lex/tokenize.h>
+
+#include "../corpus.h"
+
+namespace fp::lex {
+
+/**
+ * Returns a report without an error budget, so that corpora with many errors
+ * are still tokenized entirely.
+ */
+static diagnostic::report unlimited_report() {
+    diagnostic::report report;
+    report.set_error_budget(std::numeric_limits<size_t>::max());
+    return report;
+}
+
+/// Benchmarks lex::tokenize on the given source code.
+static void tokenize_benchmark(
+    benchmark::State& state,
+    const std::string& content
+) {
+    source_file file("", content);
+    symbol_table symbols;
+    size_t tokens = 0;
+    for (auto _ : state) {
+        diagnostic::report report = unlimited_report();
+        tokenized_list list = tokenize(file, report, symbols);
+        tokens = list.size();
+        benchmark::DoNotOptimize(list.data());
+    }
+    bench::set_throughput(state, content.size(), tokens);
+}
+
+/// Benchmarks lex::tokenize along with its lex::bracket_index.
+static void tokenize_with_brackets_benchmark(
+    benchmark::State& state,
+    const std::string& content
+) {
+    source_file file("", content);
+    symbol_table symbols;
+    size_t tokens = 0;
+    for (auto _ : state) {
+        diagnostic::report report = unlimited_report();
+        bracket_index brackets;
+        tokenized_list list = tokenize(file, report, brackets, symbols);
+        tokens = list.size();
+        benchmark::DoNotOptimize(list.data());
+        benchmark::DoNotOptimize(brackets);
+    }
+    bench::set_throughput(state, content.size(), tokens);
+}
+
+/**
+ * Benchmarks lex::tokenize_parallel on the given source code (in chunks of
+ * 64KiB, using all hardware threads).
+ */
+static void tokenize_parallel_benchmark(
+    benchmark::State& state,
+    const std::string& content
+) {
+    source_file file("", content);
+    symbol_table symbols;
+    size_t tokens = 0;
+    for (auto _ : state) {
+        diagnostic::report report = unlimited_report();
+        tokenized_list list = tokenize_parallel(
+            file, report, symbols, {.min_chunk_size = 64 * 1024}
+        );
+        tokens = list.size();
+        benchmark::DoNotOptimize(list.data());
+    }
+    bench::set_throughput(state, content.size(), tokens);
+}
+
+/// Benchmarks iterating over a lex::token_cursor on the given source code.
+static void token_cursor_benchmark(
+    benchmark::State& state,
+    const std::string& content
+) {
+    source_file file("", content);
+    symbol_table symbols;
+    size_t tokens = 0;
+    for (auto _ : state) {
+        diagnostic::report report = unlimited_report();
+        tokens = 0;
+        token_cursor cursor(file, report, symbols);
+        for (const tokenized_token& t : cursor) {
+            benchmark::DoNotOptimize(&t);
+            ++tokens;
+        }
+    }
+    bench::set_throughput(state, content.size(), tokens);
+}
+
+/**
+ * Benchmarks lex::tokenize on the given source code, with the default error
+ * budget (after which the rest of the source code is skipped).
+ */
+static void tokenize_with_error_budget_benchmark(
+    benchmark::State& state,
+    const std::string& content
+) {
+    source_file file("", content);
+    symbol_table symbols;
+    size_t tokens = 0;
+    for (auto _ : state) {
+        diagnostic::report report;
+        tokenized_list list = tokenize(file, report, symbols);
+        tokens = list.size();
+        benchmark::DoNotOptimize(list.data());
+    }
+    bench::set_throughput(state, content.size(), tokens);
+}
+
+/**
+ * Snippets of source code that are (almost) entirely handled by each of the
+ * tokenizers of detail::tokenizers_table. Each tokenizer is benchmarked by
+ * tokenizing its repeated snippet (with lex::tokenize, as tokenizers are only
+ * meant to be called from it).
+ */
+static const std::vector<std::pair<std::string, std::string>> tokenizers = {
+    {"skip_whitespace",                     " \t\n  \r\n  "},
+    {"tokenize_character",                  "'a' '\\n' "},
+    {"tokenize_double_quote",               "\"a plain string\" "},
+    {"tokenize_left_brace/right_brace",     "{ } "},
+    {"tokenize_number_with_zero_prefix",    "0x1F 0 0.5 0e3 "},
+    {"tokenize_number_with_no_zero_prefix", "42 3.14 1e9 7 "},
+    {"tokenize_keyword_or_identifier",      "identifier while x "},
+    {"tokenize_plus",                       "+ += ++ "},
+    {"tokenize_minus_or_type_arrow",        "- -= -- -> "},
+    {"tokenize_binary_op",                  "* /= % ^ & |= "},
+    {"tokenize_lt_or_shl",                  "< <= << <<= "},
+    {"tokenize_gt_or_shr",                  "> >= >> >>= "},
+    {"tokenize_eq_or_lambda_arrow",         "= == => "},
+    {"tokenize_not_eq",                     "!= "},
+    {"consume_and_push",                    "( ) [ ] ; , ? @ ~ "},
+    {"tokenize_colon",                      ": :: "},
+    {"tokenize_comment",                    "# a comment\n"},
+    {"tokenize_period",                     ". .. ... "},
+    {"stray_character",                     "$ ` $$\\ "},
+    {"unicode_character",                   "\xCE\xBB "},
+};
+
+static const bool registered = [] {
+    for (const auto& [name, snippet] : tokenizers) {
+        benchmark::RegisterBenchmark(
+            ("tokenizer/" + name).c_str(),
+            tokenize_benchmark,
+            bench::repeat(snippet, 64 * 1024)
+        );
+    }
+    for (const bench::corpus& corpus : bench::corpora()) {
+        benchmark::RegisterBenchmark(
+            ("tokenize/" + corpus.name).c_str(),
+            tokenize_benchmark,
+            corpus.content
+        );
+        benchmark::RegisterBenchmark(
+            ("tokenize_with_brackets/" + corpus.name).c_str(),
+            tokenize_with_brackets_benchmark,
+            corpus.content
+        );
+        benchmark::RegisterBenchmark(
+            ("tokenize_parallel/" + corpus.name).c_str(),
+            tokenize_parallel_benchmark,
+            corpus.content
+        );
+        benchmark::RegisterBenchmark(
+            ("token_cursor/" + corpus.name).c_str(),
+            token_cursor_benchmark,
+            corpus.content
+        );
+        benchmark::RegisterBenchmark(
+            ("tokenize_with_error_budget/" + corpus.name).c_str(),
+            tokenize_with_error_budget_benchmark,
+            corpus.content
+        );
+    }
+    return true;
+}();
+
+} // namespace fp::lex
@@ -0,0 +1,117 @@
+#include <ostream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <fp/lex/bracket_index.h>
+#include <fp/lex/tokenize.h>
+#include <fp/syntax/parse.h>
+#include <fp/syntax/ast/print/to_terminal.h>
+
+#include "../corpus.h"
+
+namespace fp::syntax {
+
+/// Semicolon-separated statements, using most of the supported syntax.
+static const std::string statements = bench::repeat(
+    "a = -b * c++ + d; e = {f; g - h / 2}; i ^= j << 2 | k;\n"
+    "l = m.n > 0x1F & -p; q += 'q' + 1.5e3;\n"
+);
+
+/**
+ * Returns a statement of blocks, prefix operators and right-associative binary
+ * operators that are nested `depth` times.
+ */
+static std::string nested_statement(size_t depth) {
+    std::string s;
+    for (size_t i = 0; i < depth; ++i) { s += "{x; a = -"; }
+    s += "b";
+    for (size_t i = 0; i < depth; ++i) { s += "}"; }
+    return s + ";\n";
+}
+
+/// Deeply nested statements (like machine-generated code).
+static const std::string nested = bench::repeat(nested_statement(100));
+
+/// Benchmarks syntax::parse on the given source code.
+static void parse_benchmark(
+    benchmark::State& state,
+    const std::string& content,
+    parsing_options options = {}
+) {
+    source_file file("", content);
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::bracket_index brackets;
+    lex::tokenized_list tokens =
+        lex::tokenize(file, report, brackets, symbols);
+    options.brackets = &brackets;
+    for (auto _ : state) {
+        diagnostic::report report;
+        ast::arena arena;
+        ast::node root = parse(tokens, arena, report, options);
+        benchmark::DoNotOptimize(root);
+    }
+    bench::set_throughput(state, content.size(), tokens.size());
+}
+
+static void parse_statements(benchmark::State& state) {
+    parse_benchmark(state, statements);
+}
+BENCHMARK(parse_statements);
+
+static void parse_nested_statements(benchmark::State& state) {
+    parse_benchmark(state, nested);
+}
+BENCHMARK(parse_nested_statements);
+
+/// Benchmarks parsing only the outline (see parsing_options::outline).
+static void parse_outline_statements(benchmark::State& state) {
+    parse_benchmark(state, statements, {.outline = true});
+}
+BENCHMARK(parse_outline_statements);
+
+static void parse_outline_nested_statements(benchmark::State& state) {
+    parse_benchmark(state, nested, {.outline = true});
+}
+BENCHMARK(parse_outline_nested_statements);
+
+/**
+ * Benchmarks syntax::parse_parallel on the statements (in segments of 16K
+ * tokens, using all hardware threads).
+ */
+static void parse_parallel_statements(benchmark::State& state) {
+    source_file file("", statements);
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+    for (auto _ : state) {
+        diagnostic::report report;
+        ast::arena arena;
+        ast::node root = parse_parallel(
+            tokens, arena, report, {.min_segment_size = 16 * 1024}
+        );
+        benchmark::DoNotOptimize(root);
+    }
+    bench::set_throughput(state, statements.size(), tokens.size());
+}
+BENCHMARK(parse_parallel_statements);
+
+static void print_ast_to_terminal(benchmark::State& state) {
+    source_file file("", statements);
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+    ast::arena arena;
+    ast::node root = parse(tokens, arena, report);
+
+    bench::null_buffer buffer;
+    std::ostream os(&buffer);
+    for (auto _ : state) {
+        ast::print::to_terminal(os, root);
+    }
+    bench::set_throughput(state, statements.size(), tokens.size());
+}
+BENCHMARK(print_ast_to_terminal);
+
+} // namespace fp::syntax
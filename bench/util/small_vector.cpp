@@ -0,0 +1,28 @@
+#include <deque>
+
+#include <benchmark/benchmark.h>
+
+#include <fp/util/small_vector.h>
+
+namespace fp::util {
+
+/**
+ * Pushes and pops `state.range(0)` elements, in a fresh stack each time (like
+ * the string_interpolation_stack of each tokenization).
+ */
+template <class Stack>
+static void stack_push_pop(benchmark::State& state) {
+    const int depth = int(state.range(0));
+    for (auto _ : state) {
+        Stack stack;
+        for (int i = 0; i < depth; ++i) { stack.push_back(i); }
+        while (!stack.empty()) {
+            benchmark::DoNotOptimize(stack.back());
+            stack.pop_back();
+        }
+    }
+}
+BENCHMARK(stack_push_pop<small_vector<int, 4>>)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(stack_push_pop<std::deque<int>>)->Arg(1)->Arg(4)->Arg(16);
+
+} // namespace fp::util
@@ -0,0 +1,190 @@
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <variant>
+
+#include <fp/source_code.h>
+#include <fp/symbol_table.h>
+#include <fp/diagnostic/report.h>
+#include <fp/lex/tokenize.h>
+#include <fp/util/assert.h>
+
+#include "reference_tokenizer.h"
+
+namespace fp::fuzz {
+
+/// Returns a report without an error budget (like fuzz::reference_tokenize).
+static diagnostic::report unlimited_report() {
+    diagnostic::report report;
+    report.set_error_budget(std::numeric_limits<size_t>::max());
+    return report;
+}
+
+/// Returns the offset of `chars` in `file`, for failure messages.
+static size_t offset(const source_file& file, source_view chars) {
+    return size_t(chars.data() - file.content.data());
+}
+
+/// Asserts that the attribute of `t` has the value computed by `expected`.
+static void assert_same_attribute(
+    const lex::tokenized_token& t,
+    const reference_token& expected,
+    const symbol_table& symbols,
+    size_t i
+) {
+    switch (t.token) {
+        case lex::token::IDENTIFIER:
+        case lex::token::STRING: {
+            std::string_view text = symbols[std::get<symbol_id>(t.attribute)];
+            FP_ASSERT(
+                text == expected.text,
+                "token " << i << ": `" << text << "` instead of `" <<
+                expected.text << "`"
+            );
+            return;
+        }
+        case lex::token::COMMENT:
+            FP_ASSERT(
+                std::get<source_view>(t.attribute) == expected.text,
+                "token " << i << ": wrong comment"
+            );
+            return;
+        case lex::token::CHAR:
+            FP_ASSERT(
+                std::get<char_t>(t.attribute) == expected.character,
+                "token " << i << ": U+" << std::hex <<
+                uint32_t(std::get<char_t>(t.attribute)) << " instead of U+" <<
+                uint32_t(expected.character)
+            );
+            return;
+        case lex::token::NUMBER: {
+            const number_t& value = std::get<number_t>(t.attribute);
+            const number_t& other = expected.number;
+            FP_ASSERT(
+                value.is_float == other.is_float && value.kind == other.kind,
+                "token " << i << ": wrong number type"
+            );
+            FP_ASSERT(
+                value.is_float
+                    ? std::bit_cast<uint64_t>(value.floating) ==
+                        std::bit_cast<uint64_t>(other.floating)
+                    : value.integer == other.integer,
+                "token " << i << ": wrong number value"
+            );
+            FP_ASSERT(
+                value.is_float || (value.big != nullptr) == expected.overflow,
+                "token " << i << ": wrong number overflow"
+            );
+            return;
+        }
+        default:
+            FP_ASSERT(
+                std::holds_alternative<std::monostate>(t.attribute),
+                "token " << i << ": unexpected attribute"
+            );
+    }
+}
+
+/**
+ * Asserts that lex::tokenize has the same result as fuzz::reference_tokenize:
+ * the same tokens (with the same characters and attributes), and the same
+ * errors in the same order.
+ */
+static void assert_same_as_reference(const source_file& file) {
+    symbol_table symbols;
+    diagnostic::report report = unlimited_report();
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+    reference_tokenization expected = reference_tokenize(file.content);
+
+    FP_ASSERT(
+        tokens.size() == expected.tokens.size(),
+        tokens.size() << " tokens instead of " << expected.tokens.size()
+    );
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const lex::tokenized_token& t = tokens[i];
+        const reference_token& e = expected.tokens[i];
+        source_view chars = t.source_location.chars;
+        FP_ASSERT(
+            t.token == e.token && t.dummy == e.dummy,
+            "token " << i << " at " << offset(file, chars) << ": " <<
+            (t.dummy ? "dummy " : "") << t.token << " instead of " <<
+            (e.dummy ? "dummy " : "") << e.token
+        );
+        FP_ASSERT(
+            chars.data() == e.chars.data() && chars.size() == e.chars.size(),
+            "token " << i << ": characters [" << offset(file, chars) << ", +" <<
+            chars.size() << ") instead of [" << offset(file, e.chars) <<
+            ", +" << e.chars.size() << ")"
+        );
+        if (!t.dummy) { assert_same_attribute(t, e, symbols, i); }
+    }
+
+    FP_ASSERT(
+        report.errors().size() == expected.errors.size(),
+        report.errors().size() << " errors instead of " <<
+        expected.errors.size()
+    );
+    size_t i = 0;
+    for (const diagnostic::problem& error : report.errors()) {
+        const error::code* code = expected.errors[i];
+        FP_ASSERT(
+            error.error_code() == code,
+            "error " << i << ": " << error.error_code()->code <<
+            " instead of " << code->code
+        );
+        ++i;
+    }
+}
+
+/**
+ * Asserts that lex::tokenize_parallel (with chunks small enough to split even
+ * small inputs) has the same result as lex::tokenize.
+ */
+static void assert_parallel_same_as_sequential(const source_file& file) {
+    symbol_table symbols;
+    diagnostic::report report = unlimited_report();
+    lex::tokenized_list expected = lex::tokenize(file, report, symbols);
+
+    symbol_table parallel_symbols;
+    diagnostic::report parallel_report = unlimited_report();
+    lex::tokenized_list tokens = lex::tokenize_parallel(
+        file,
+        parallel_report,
+        parallel_symbols,
+        {.jobs = 4, .min_chunk_size = 16}
+    );
+
+    FP_ASSERT(
+        tokens.size() == expected.size(),
+        "tokenize_parallel: " << tokens.size() << " tokens instead of " <<
+        expected.size()
+    );
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const lex::tokenized_token& t = tokens[i];
+        const lex::tokenized_token& e = expected[i];
+        FP_ASSERT(
+            t.token == e.token && t.dummy == e.dummy &&
+            t.attribute == e.attribute &&
+            t.source_location.chars.data() == e.source_location.chars.data() &&
+            t.source_location.chars.size() == e.source_location.chars.size(),
+            "tokenize_parallel: token " << i << " differs"
+        );
+    }
+    FP_ASSERT(
+        parallel_report.errors().size() == report.errors().size(),
+        "tokenize_parallel: " << parallel_report.errors().size() <<
+        " errors instead of " << report.errors().size()
+    );
+}
+
+} // namespace fp::fuzz
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    auto chars = reinterpret_cast<const char*>(data);
+    fp::source_file file("", std::string_view(chars, size));
+    fp::fuzz::assert_same_as_reference(file);
+    fp::fuzz::assert_parallel_same_as_sequential(file);
+    return 0;
+}
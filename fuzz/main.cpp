@@ -0,0 +1,65 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/**
+ * A standalone driver for the fuzz targets, which is linked in when they are
+ * not built with a fuzzing engine (see FP_FUZZ_ENGINE in fuzz/CMakeLists.txt).
+ *
+ * It runs the target once on each of the given files, and on each file in the
+ * given directories (recursively), or on the standard input if no files are
+ * given. Arguments that begin with `-` (the flags of libFuzzer) are ignored, so
+ * that corpora can be replayed with the same command line either way, and the
+ * targets can be run by AFL (with `@@` or with the standard input).
+ */
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace fs = std::filesystem;
+
+/// Runs the fuzz target on the given input.
+static void run(const std::string& input) {
+    LLVMFuzzerTestOneInput(
+        reinterpret_cast<const uint8_t*>(input.data()),
+        input.size()
+    );
+}
+
+static std::string read(std::istream& in) {
+    return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+int main(int argc, char** argv) {
+    std::vector<fs::path> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.starts_with("-")) { continue; }
+        if (!fs::is_directory(arg)) {
+            files.push_back(arg);
+            continue;
+        }
+        for (const auto& entry : fs::recursive_directory_iterator(arg)) {
+            if (entry.is_regular_file()) { files.push_back(entry.path()); }
+        }
+    }
+
+    if (files.empty()) {
+        run(read(std::cin));
+        return 0;
+    }
+    for (const fs::path& path : files) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            std::cerr << "cannot read " << path << "\n";
+            return 1;
+        }
+        run(read(in));
+    }
+    std::cerr << "ran " << files.size() << " inputs\n";
+    return 0;
+}
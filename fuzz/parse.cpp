@@ -0,0 +1,31 @@
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include <fp/compilation_error.h>
+#include <fp/source_code.h>
+#include <fp/symbol_table.h>
+#include <fp/diagnostic/report.h>
+#include <fp/lex/tokenize.h>
+#include <fp/syntax/parse.h>
+
+/**
+ * Tokenizes and parses the input. Any syntax error is fine (and is expected on
+ * most inputs), but the parser must neither crash nor hang, and may only throw
+ * an fp::compilation_error.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    auto chars = reinterpret_cast<const char*>(data);
+    fp::source_file file("", std::string_view(chars, size));
+    fp::symbol_table symbols;
+    fp::diagnostic::report report;
+    report.set_error_budget(std::numeric_limits<size_t>::max());
+    fp::lex::tokenized_list tokens = fp::lex::tokenize(file, report, symbols);
+    fp::syntax::ast::arena arena;
+    try {
+        fp::syntax::parse(tokens, arena, report);
+    } catch (const fp::compilation_error&) {
+    }
+    return 0;
+}
@@ -0,0 +1,676 @@
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+
+#include <fp/lex/keywords.h>
+#include <fp/lex/detail/utf8.h>
+
+#include "reference_tokenizer.h"
+
+namespace fp::fuzz {
+
+using lex::token;
+
+static bool is_letter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+static bool is_identifier_char(char c) {
+    return is_letter(c) || is_digit(c) || c == '_';
+}
+
+static bool is_whitespace(char c) {
+    return
+        c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+        c == '\r';
+}
+
+static bool is_line_break(char c) { return c == '\n' || c == '\r'; }
+
+static bool is_ascii(char c) { return (c & 0x80) == 0; }
+
+/// Returns the value of a hexadecimal digit, or -1 if `c` isn't one.
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') { return c - '0'; }
+    if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+    if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+    return -1;
+}
+
+/// Returns `true` if `c` is a digit in the given `base` (2, 8, 10 or 16).
+static bool is_base_digit(char c, int base) {
+    int value = hex_value(c);
+    return value >= 0 && value < base;
+}
+
+/// A decoded UTF-8 sequence (see decode).
+struct code_point {
+    char_t value;
+    size_t size;
+    bool   valid;
+};
+
+/**
+ * Decodes the UTF-8 sequence at `content[i]`, following the table of
+ * well-formed byte sequences of the Unicode standard (table 3-7). An invalid
+ * sequence is as long as its longest valid prefix (and at least one byte).
+ */
+static code_point decode(source_view content, size_t i) {
+    uint8_t lead = uint8_t(content[i]);
+    if (lead <= 0x7F) { return {lead, 1, true}; }
+
+    // the valid ranges of each of the bytes after the lead byte
+    struct range { uint8_t min, max; };
+    std::vector<range> ranges;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        ranges = {{0x80, 0xBF}};
+    } else if (lead == 0xE0) {
+        ranges = {{0xA0, 0xBF}, {0x80, 0xBF}};
+    } else if ((lead >= 0xE1 && lead <= 0xEC) || lead == 0xEE || lead == 0xEF) {
+        ranges = {{0x80, 0xBF}, {0x80, 0xBF}};
+    } else if (lead == 0xED) {
+        ranges = {{0x80, 0x9F}, {0x80, 0xBF}};
+    } else if (lead == 0xF0) {
+        ranges = {{0x90, 0xBF}, {0x80, 0xBF}, {0x80, 0xBF}};
+    } else if (lead >= 0xF1 && lead <= 0xF3) {
+        ranges = {{0x80, 0xBF}, {0x80, 0xBF}, {0x80, 0xBF}};
+    } else if (lead == 0xF4) {
+        ranges = {{0x80, 0x8F}, {0x80, 0xBF}, {0x80, 0xBF}};
+    } else {
+        return {0, 1, false};
+    }
+
+    // the payload bits of the lead byte
+    char_t value = lead & (0x7F >> (ranges.size() + 1));
+    for (size_t n = 0; n < ranges.size(); ++n) {
+        size_t j = i + 1 + n;
+        if (j >= content.size()) { return {0, n + 1, false}; }
+        uint8_t byte = uint8_t(content[j]);
+        if (byte < ranges[n].min || byte > ranges[n].max) {
+            return {0, n + 1, false};
+        }
+        value = (value << 6) | (byte & 0x3F);
+    }
+    return {value, ranges.size() + 1, true};
+}
+
+static void encode(char_t c, std::string& out) {
+    if (c < 0x80) {
+        out += char(c);
+    } else if (c < 0x800) {
+        out += char(0xC0 | (c >> 6));
+        out += char(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        out += char(0xE0 | (c >> 12));
+        out += char(0x80 | ((c >> 6) & 0x3F));
+        out += char(0x80 | (c & 0x3F));
+    } else {
+        out += char(0xF0 | (c >> 18));
+        out += char(0x80 | ((c >> 12) & 0x3F));
+        out += char(0x80 | ((c >> 6) & 0x3F));
+        out += char(0x80 | (c & 0x3F));
+    }
+}
+
+/// The operators, longest first (so that the first match is the longest).
+static const std::pair<std::string_view, token> operators[] = {
+    {"<<=", token::SHL_ASSIGN},
+    {">>=", token::SHR_ASSIGN},
+    {"++",  token::INC},
+    {"--",  token::DEC},
+    {"->",  token::TYPE_ARROW},
+    {"=>",  token::LAMBDA_ARROW},
+    {"+=",  token::ADD_ASSIGN},
+    {"-=",  token::SUB_ASSIGN},
+    {"*=",  token::MUL_ASSIGN},
+    {"/=",  token::DIV_ASSIGN},
+    {"%=",  token::MOD_ASSIGN},
+    {"^=",  token::POW_ASSIGN},
+    {"&=",  token::BIT_AND_ASSIGN},
+    {"|=",  token::BIT_OR_ASSIGN},
+    {"<<",  token::SHL},
+    {">>",  token::SHR},
+    {"<=",  token::LTE},
+    {">=",  token::GTE},
+    {"==",  token::EQ},
+    {"!=",  token::NE},
+    {"::",  token::SCOPE},
+    {"+",   token::ADD},
+    {"-",   token::SUB},
+    {"*",   token::MUL},
+    {"/",   token::DIV},
+    {"%",   token::MOD},
+    {"^",   token::POW},
+    {"&",   token::BIT_AND},
+    {"|",   token::BIT_OR},
+    {"<",   token::LT},
+    {">",   token::GT},
+    {"=",   token::ASSIGN},
+    {"(",   token::L_PAREN},
+    {")",   token::R_PAREN},
+    {"[",   token::L_BRACKET},
+    {"]",   token::R_BRACKET},
+    {";",   token::SEMICOLON},
+    {",",   token::COMMA},
+    {"?",   token::OPTIONAL},
+    {"@",   token::DECORATOR},
+    {"~",   token::BIT_NOT},
+    {":",   token::ANNOTATION},
+    {".",   token::MEMBER_ACCESS},
+};
+
+/// The type suffixes of number literals.
+static const std::pair<std::string_view, number_kind> type_suffixes[] = {
+    {"i8",  number_kind::I8},
+    {"i16", number_kind::I16},
+    {"i32", number_kind::I32},
+    {"i64", number_kind::I64},
+    {"u8",  number_kind::U8},
+    {"u16", number_kind::U16},
+    {"u32", number_kind::U32},
+    {"u64", number_kind::U64},
+    {"u",   number_kind::U64},
+    {"f32", number_kind::F32},
+    {"f64", number_kind::F64},
+    {"f",   number_kind::F64},
+};
+
+namespace {
+
+struct reference_tokenizer {
+    source_view content;
+    size_t      pos = 0;
+
+    reference_tokenization result;
+
+    /**
+     * The string interpolation stack: the number of open left-braces in each
+     * string (0 while tokenizing the characters of the string).
+     */
+    std::vector<size_t> strings;
+
+    char at(size_t i) const { return i < content.size() ? content[i] : '\0'; }
+
+    bool starts_with(size_t i, std::string_view s) const {
+        return content.substr(i).starts_with(s);
+    }
+
+    source_view chars(size_t begin) const {
+        return content.substr(begin, pos - begin);
+    }
+
+    reference_token& push(token t, size_t begin, bool dummy = false) {
+        result.tokens.push_back({.token = t, .dummy = dummy,
+                                 .chars = chars(begin)});
+        return result.tokens.back();
+    }
+
+    void error(const error::code& code) { result.errors.push_back(&code); }
+
+    /// Returns `true` if a stray character (or invalid UTF-8) is at `i`.
+    bool is_stray(size_t i, size_t& size) const {
+        char c = content[i];
+        size = 1;
+        if (is_ascii(c)) {
+            static constexpr std::string_view token_chars =
+                "'\"{}+-*/%^&|<>=!()[];,?@~:#.";
+            return
+                !is_whitespace(c) && !is_identifier_char(c) &&
+                token_chars.find(c) == token_chars.npos;
+        }
+        code_point cp = decode(content, i);
+        size = cp.size;
+        return !cp.valid || !lex::detail::is_xid_start(cp.value);
+    }
+
+    void tokenize() {
+        while (pos < content.size()) {
+            size_t begin = pos;
+            char c = content[pos];
+            size_t stray_size;
+            if (is_whitespace(c)) {
+                ++pos;
+            } else if (c == '#') {
+                comment(begin);
+            } else if (is_letter(c) || c == '_') {
+                identifier(begin, 1);
+            } else if (is_digit(c)) {
+                number(begin);
+            } else if (c == '\'') {
+                character(begin);
+            } else if (c == '"') {
+                ++pos;
+                if (!strings.empty() && strings.back() == 0) {
+                    strings.pop_back();
+                    push(token::QUOTE, begin);
+                } else {
+                    strings.push_back(0);
+                    push(token::QUOTE, begin);
+                    string_section();
+                }
+            } else if (c == '{') {
+                ++pos;
+                push(token::L_BRACE, begin);
+                if (!strings.empty()) { strings.back() += 1; }
+            } else if (c == '}') {
+                ++pos;
+                push(token::R_BRACE, begin);
+                if (!strings.empty()) {
+                    strings.back() -= 1;
+                    if (strings.back() == 0) { string_section(); }
+                }
+            } else if (c == '!' && at(pos + 1) != '=') {
+                ++pos;
+                error(error::E0009_stray_exclamation_mark);
+                push(token::ERROR, begin, true);
+            } else if (is_stray(pos, stray_size)) {
+                stray_run(begin);
+            } else if (!is_ascii(c)) {
+                identifier(begin, stray_size);
+            } else {
+                for (const auto& [text, t] : operators) {
+                    if (starts_with(pos, text)) {
+                        pos += text.size();
+                        push(t, begin);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    /// An identifier or keyword, whose first character is `first_size` long.
+    void identifier(size_t begin, size_t first_size) {
+        pos += first_size;
+        while (pos < content.size()) {
+            if (is_identifier_char(content[pos])) {
+                ++pos;
+                continue;
+            }
+            if (is_ascii(content[pos])) { break; }
+            code_point cp = decode(content, pos);
+            if (!cp.valid || !lex::detail::is_xid_continue(cp.value)) {
+                break;
+            }
+            pos += cp.size;
+        }
+        for (const lex::keyword& k : lex::keywords) {
+            if (k.name == chars(begin)) {
+                push(k.token, begin);
+                return;
+            }
+        }
+        push(token::IDENTIFIER, begin).text = chars(begin);
+    }
+
+    void comment(size_t begin) {
+        // each run of invalid UTF-8 sequences is an error
+        bool invalid_run = false;
+        while (pos < content.size() && !is_line_break(content[pos])) {
+            if (is_ascii(content[pos])) {
+                invalid_run = false;
+                ++pos;
+                continue;
+            }
+            code_point cp = decode(content, pos);
+            if (!cp.valid && !invalid_run) {
+                error(error::E0012_invalid_utf8);
+            }
+            invalid_run = !cp.valid;
+            pos += cp.size;
+        }
+        push(token::COMMENT, begin).text = chars(begin);
+    }
+
+    void stray_run(size_t begin) {
+        size_t count = 0;
+        size_t invalid = 0;
+        size_t size;
+        while (pos < content.size() && is_stray(pos, size)) {
+            if (!is_ascii(content[pos]) && !decode(content, pos).valid) {
+                ++invalid;
+            }
+            ++count;
+            pos += size;
+        }
+        push(token::ERROR, begin);
+        error(invalid == count ?
+              error::E0012_invalid_utf8 :
+              error::E0001_stray_character);
+    }
+
+    /**
+     * Returns the end of the quoted content that begins at `i`: the first
+     * line-break, or the first terminator that is not escaped by a backslash.
+     */
+    size_t quoted_end(size_t i, char quote) const {
+        while (i < content.size()) {
+            char c = content[i];
+            if (is_line_break(c)) { break; }
+            if (c == quote || (quote == '"' && c == '{')) { break; }
+            if (c == '\\' && starts_with(i + 1, "u{")) {
+                i += 3;
+            } else if (
+                c == '\\' &&
+                i + 1 < content.size() &&
+                !is_line_break(content[i + 1])
+            ) {
+                i += 2;
+            } else {
+                i += 1;
+            }
+        }
+        return i;
+    }
+
+    /**
+     * Decodes the first (possibly escaped) character of the quoted content
+     * `q`, and returns it (and sets `size` to its size), or reports an error
+     * and returns std::nullopt.
+     */
+    std::optional<char_t> quoted_char(source_view q, char quote, size_t& size) {
+        if (!is_ascii(q[0])) {
+            code_point cp = decode(q, 0);
+            size = cp.size;
+            if (!cp.valid) {
+                error(error::E0012_invalid_utf8);
+                return std::nullopt;
+            }
+            return cp.value;
+        }
+        size = 1;
+        if (q[0] != '\\') { return char_t(q[0]); }
+
+        size = 2;
+        char escaped = q[1];
+        if (escaped == quote) { return char_t(quote); }
+        if (escaped == '{' && quote == '"') { return '{'; }
+        if (escaped == '\\') { return '\\'; }
+        if (escaped == 'n') { return '\n'; }
+        if (escaped == 'r') { return '\r'; }
+        if (escaped == 't') { return '\t'; }
+        if (escaped == '0') { return '\0'; }
+        if (escaped != 'u' || q.size() < 3 || q[2] != '{') {
+            error(error::E0005_invalid_escape_sequence);
+            return std::nullopt;
+        }
+
+        // `\u{...}`: 1 to 6 hexadecimal digits of a valid code point
+        size_t digits_begin = 3;
+        size_t digits_end = digits_begin;
+        while (digits_end < q.size() && hex_value(q[digits_end]) >= 0) {
+            ++digits_end;
+        }
+        size_t n_digits = digits_end - digits_begin;
+        char_t value = 0;
+        for (size_t i = digits_begin; i < digits_end && i < 9; ++i) {
+            value = value * 16 + hex_value(q[i]);
+        }
+        bool valid =
+            digits_end < q.size() && q[digits_end] == '}' &&
+            n_digits >= 1 && n_digits <= 6 &&
+            value <= 0x10FFFF && !(value >= 0xD800 && value <= 0xDFFF);
+        if (!valid) {
+            error(error::E0005_invalid_escape_sequence);
+            return std::nullopt;
+        }
+        size = digits_end + 1;
+        return value;
+    }
+
+    void character(size_t begin) {
+        size_t content_begin = begin + 1;
+        pos = quoted_end(content_begin, '\'');
+        source_view q = content.substr(content_begin, pos - content_begin);
+        if (at(pos) != '\'' || pos == content.size()) {
+            error(error::E0002_missing_terminating_single_quote);
+            push(token::CHAR, begin, true);
+            return;
+        }
+        ++pos;
+        if (q.empty()) {
+            error(error::E0004_empty_character_literal);
+            push(token::CHAR, begin, true);
+            return;
+        }
+        size_t size;
+        std::optional<char_t> c = quoted_char(q, '\'', size);
+        if (!c) {
+            push(token::CHAR, begin, true);
+            return;
+        }
+        if (size != q.size()) {
+            error(error::E0006_character_literal_with_more_than_one);
+            push(token::CHAR, begin, true);
+            return;
+        }
+        push(token::CHAR, begin).character = *c;
+    }
+
+    /// The characters of a string, up to its closing quote or a left-brace.
+    void string_section() {
+        size_t begin = pos;
+        pos = quoted_end(begin, '"');
+        source_view q = chars(begin);
+        bool terminated =
+            pos < content.size() &&
+            (content[pos] == '"' || content[pos] == '{');
+        if (!terminated) {
+            error(error::E0003_missing_terminating_double_quote);
+            if (!q.empty()) { push(token::STRING, begin, true); }
+            return;
+        }
+        if (q.empty()) { return; }
+
+        std::string value;
+        while (!q.empty()) {
+            size_t size;
+            std::optional<char_t> c = quoted_char(q, '"', size);
+            if (!c) {
+                push(token::STRING, begin, true);
+                return;
+            }
+            encode(*c, value);
+            q.remove_prefix(size);
+        }
+        push(token::STRING, begin).text = value;
+    }
+
+    void number(size_t begin) {
+        int base = 10;
+        std::string_view exponent_chars = "eE";
+        if (starts_with(pos, "0x")) {
+            base = 16;
+            exponent_chars = "pP";
+        } else if (starts_with(pos, "0o")) {
+            base = 8;
+            exponent_chars = "";
+        } else if (starts_with(pos, "0b")) {
+            base = 2;
+            exponent_chars = "";
+        }
+        if (base != 10) { pos += 2; }
+
+        // the digits, and the exponent (from its `e` or `p`)
+        size_t number_begin = pos;
+        std::optional<size_t> exponent_begin;
+        while (pos < content.size()) {
+            char c = content[pos];
+            bool is_exponent = exponent_chars.find(c) != exponent_chars.npos;
+            if (!exponent_begin && is_exponent) {
+                exponent_begin = pos;
+                ++pos;
+                while (at(pos) == '\'') { ++pos; }
+                if (at(pos) == '+' || at(pos) == '-') { ++pos; }
+            } else if (is_identifier_char(c) || c == '.' || c == '\'') {
+                ++pos;
+            } else {
+                break;
+            }
+        }
+        size_t number_end = exponent_begin.value_or(pos);
+        source_view n = content.substr(number_begin, number_end - number_begin);
+        source_view x = content.substr(number_end, pos - number_end);
+
+        // the type suffix (after a backtick)
+        source_view suffix;
+        if (at(pos) == '`' && is_letter(at(pos + 1))) {
+            size_t suffix_begin = ++pos;
+            while (pos < content.size() && is_identifier_char(content[pos])) {
+                ++pos;
+            }
+            suffix = chars(suffix_begin);
+        }
+
+        auto invalid = [&](const error::code& code) {
+            error(code);
+            push(token::NUMBER, begin, true);
+        };
+        if (!is_valid_number(n, x, base)) {
+            return invalid(error::E0007_invalid_number_literal);
+        }
+        std::optional<number_kind> kind;
+        if (!suffix.empty()) {
+            for (const auto& [name, k] : type_suffixes) {
+                if (name == suffix) { kind = k; }
+            }
+            if (!kind) { return invalid(error::E0010_invalid_number_suffix); }
+        }
+        bool float_kind =
+            kind == number_kind::F32 || kind == number_kind::F64;
+        bool float_syntax = !x.empty() || n.find('.') != n.npos;
+        bool is_float = float_syntax || float_kind;
+        if (is_float && (base == 2 || base == 8)) {
+            return invalid(error::E0008_unsupported_float_base);
+        }
+        if (float_syntax && kind && !float_kind) {
+            return invalid(error::E0010_invalid_number_suffix);
+        }
+
+        number_t value;
+        value.is_float = is_float;
+        value.kind = kind.value_or(
+            is_float ? number_kind::FLOAT : number_kind::INTEGER
+        );
+        bool overflow = false;
+        if (is_float) {
+            std::string text = base == 16 ? "0x" : "";
+            for (char c : content.substr(number_begin, pos - number_begin)) {
+                if (c == '`') { break; }
+                if (c != '\'') { text += c; }
+            }
+            value.floating = std::strtod(text.c_str(), nullptr);
+        } else {
+            for (char c : n) {
+                if (c == '\'') { continue; }
+                uint64_t digit = hex_value(c);
+                if (value.integer > (UINT64_MAX - digit) / base) {
+                    overflow = true;
+                }
+                value.integer = value.integer * base + digit;
+            }
+        }
+        if (!in_range(value, overflow)) {
+            return invalid(error::E0011_number_out_of_range);
+        }
+        reference_token& t = push(token::NUMBER, begin);
+        t.number = value;
+        t.overflow = overflow;
+    }
+
+    /**
+     * Returns `true` if the digits `n` and the exponent `x` (including its `e`
+     * or `p`) of a number literal in the given `base` are valid.
+     */
+    static bool is_valid_number(source_view n, source_view x, int base) {
+        auto is_separator = [](char c) { return c == '\''; };
+        auto is_sign = [](char c) { return c == '+' || c == '-'; };
+
+        if (n.empty()) { return false; }
+        size_t decimal_points = 0;
+        for (size_t i = 0; i < n.size(); ++i) {
+            if (n[i] == '.') {
+                ++decimal_points;
+                continue;
+            }
+            if (is_separator(n[i])) {
+                // not after another separator, and not next to a decimal
+                // point (unless it's the first or last character)
+                if (i > 0 && is_separator(n[i - 1])) { return false; }
+                bool inner = i > 0 && i + 1 < n.size();
+                if (inner && (n[i - 1] == '.' || n[i + 1] == '.')) {
+                    return false;
+                }
+                continue;
+            }
+            if (!is_base_digit(n[i], base)) { return false; }
+        }
+        if (decimal_points > 1) { return false; }
+
+        if (!x.empty()) {
+            // the exponent character, an optional sign, and decimal digits
+            // (possibly with separators, but not right after the exponent
+            // character or the sign)
+            size_t digits_begin = x.size() > 1 && is_sign(x[1]) ? 2 : 1;
+            bool has_digits = false;
+            for (size_t i = 1; i < x.size(); ++i) {
+                if (is_separator(x[i])) {
+                    if (is_separator(x[i - 1])) { return false; }
+                    continue;
+                }
+                if (is_digit(x[i])) {
+                    has_digits = true;
+                } else if (i >= digits_begin || !is_sign(x[i])) {
+                    return false;
+                }
+            }
+            if (!has_digits) { return false; }
+            if (is_separator(n.back())) { return false; }
+            if (x.size() > 1 && is_separator(x[1])) { return false; }
+            if (x.size() > 2 && is_sign(x[1]) && is_separator(x[2])) {
+                return false;
+            }
+        }
+
+        source_view last = x.empty() ? n : x;
+        return !is_separator(last.back());
+    }
+
+    /// Returns `true` if an evaluated number literal fits in its type.
+    static bool in_range(const number_t& value, bool overflow) {
+        auto fits = [&](uint64_t max) {
+            return !overflow && value.integer <= max;
+        };
+        switch (value.kind) {
+            case number_kind::INTEGER: return true;
+            case number_kind::FLOAT:   return true;
+            case number_kind::I8:      return fits(INT8_MAX);
+            case number_kind::I16:     return fits(INT16_MAX);
+            case number_kind::I32:     return fits(INT32_MAX);
+            case number_kind::I64:     return fits(INT64_MAX);
+            case number_kind::U8:      return fits(UINT8_MAX);
+            case number_kind::U16:     return fits(UINT16_MAX);
+            case number_kind::U32:     return fits(UINT32_MAX);
+            case number_kind::U64:     return fits(UINT64_MAX);
+            case number_kind::F32:
+                return !std::isinf(float(value.floating));
+            case number_kind::F64:     return !std::isinf(value.floating);
+        }
+        return false;
+    }
+};
+
+} // namespace
+
+reference_tokenization reference_tokenize(source_view content) {
+    reference_tokenizer tokenizer{.content = content};
+    tokenizer.tokenize();
+    return std::move(tokenizer.result);
+}
+
+} // namespace fp::fuzz
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <fp/error_codes.h>
+#include <fp/literal_types.h>
+#include <fp/source_code.h>
+#include <fp/lex/token.h>
+
+namespace fp::fuzz {
+
+/// A token produced by fuzz::reference_tokenize.
+struct reference_token {
+    lex::token  token;
+    bool        dummy = false;
+    source_view chars;
+
+    /// The value of (non-dummy) identifiers, strings and comments.
+    std::string text;
+
+    /// The value of (non-dummy) character literals.
+    char_t character = 0;
+
+    /**
+     * The value of (non-dummy) number literals, without an fp::big_number:
+     * only the lowest 64 bits of integers that overflow are kept, and
+     * `overflow` is set.
+     */
+    number_t number;
+    bool     overflow = false;
+};
+
+/// The result of fuzz::reference_tokenize.
+struct reference_tokenization {
+    std::vector<reference_token> tokens;
+
+    /// The codes of the reported errors, in order.
+    std::vector<const error::code*> errors;
+};
+
+/**
+ * Tokenizes `content` just like lex::tokenize (without an error budget), in
+ * the slowest and most straightforward way: one character at a time, with
+ * none of the scan kernels, dispatch tables and fast paths of the lexer.
+ *
+ * It is only used to test the lexer against (see fuzz/lex.cpp), so that each
+ * of its rules should be obviously correct when read on its own. Only the
+ * data tables of the lexer are shared (keywords and Unicode properties).
+ */
+reference_tokenization reference_tokenize(source_view content);
+
+} // namespace fp::fuzz
@@ -8,9 +8,17 @@ set(
     diagnostic/problem.h
     diagnostic/report.cpp
     diagnostic/report.h
+    driver/driver.cpp
+    driver/driver.h
+    driver/options.cpp
+    driver/options.h
     error_codes.h
     lex/attribute.h
+    lex/bracket_index.cpp
+    lex/bracket_index.h
     lex/detail/characters_range.h
+    lex/detail/scan.cpp
+    lex/detail/scan.h
     lex/detail/string_interpolation_stack.h
     lex/detail/tokenization_state.h
     lex/detail/tokenizers/character_and_string.cpp
@@ -26,10 +34,19 @@ set(
     lex/detail/tokenizers/unicode_character.h
     lex/detail/tokenizers/whitespace.h
     lex/detail/tokenizers_table.h
+    lex/detail/utf8.cpp
+    lex/detail/utf8.h
+    lex/keywords.h
     lex/print/to_terminal.cpp
     lex/print/to_terminal.h
+    lex/retokenize.cpp
+    lex/retokenize.h
     lex/token.cpp
     lex/token.h
+    lex/token_cursor.cpp
+    lex/token_cursor.h
+    lex/token_stream.cpp
+    lex/token_stream.h
     lex/tokenize.cpp
     lex/tokenize.h
     lex/tokenized_list.cpp
@@ -37,6 +54,12 @@ set(
     literal_types.h
     source_code.cpp
     source_code.h
+    source_map.cpp
+    source_map.h
+    symbol_table.cpp
+    symbol_table.h
+    syntax/ast/arena.cpp
+    syntax/ast/arena.h
     syntax/ast/detail/base_node.h
     syntax/ast/detail/base_sequence.h
     syntax/ast/detail/variant_node.h
@@ -55,6 +78,7 @@ set(
     syntax/detail/parsers/single_token.h
     syntax/detail/parsing_state.h
     syntax/detail/precedence.h
+    syntax/detail/recovery.h
     syntax/detail/token_table_t.h
     syntax/parse.cpp
     syntax/parse.h
@@ -67,7 +91,10 @@ set(
     util/context_value.h
     util/match.h
     util/overloaded.h
+    util/small_vector.h
     util/table.h
+    util/thread_pool.cpp
+    util/thread_pool.h
     util/to_string.h
     util/type_name.h
     util/with.h
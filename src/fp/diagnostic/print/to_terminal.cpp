@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <optional>
 #include <iomanip>
 
+#include <fp/source_map.h>
 #include <fp/util/match.h>
 #include <fp/util/ansi/codes.h>
 
@@ -32,7 +34,7 @@ struct sorted_source_locations {
             locations.push_back(&loc);
             max_line_number_width = std::max(
                 max_line_number_width,
-                line_number_width(loc.source_location.line_number)
+                line_number_width(loc.source_location.line_number())
             );
         }
     };
@@ -42,20 +44,17 @@ struct sorted_source_locations {
      void set(const diagnostic::problem& problem) {
          locations_by_file.clear();
 
+         original_locations.clear();
+         original_locations.reserve(problem.locations().size());
+
          for (const auto& loc : problem.locations()) {
-             if (loc.kind == location_kind::PRIMARY) {
-                 get_file(loc.source_location.file).add(loc);
-             }
+             if (loc.kind == location_kind::PRIMARY) { add(loc); }
          }
          for (const auto& loc : problem.locations()) {
-             if (loc.kind == location_kind::SUPPLEMENT) {
-                 get_file(loc.source_location.file).add(loc);
-             }
+             if (loc.kind == location_kind::SUPPLEMENT) { add(loc); }
          }
          for (const auto& loc : problem.locations()) {
-             if (loc.kind == location_kind::CONTEXTUAL) {
-                 get_file(loc.source_location.file).add(loc);
-             }
+             if (loc.kind == location_kind::CONTEXTUAL) { add(loc); }
          }
 
          // sort all locations
@@ -71,6 +70,40 @@ struct sorted_source_locations {
     }
 
 private:
+    /**
+     * The locations of generated source files, mapped to the files they were
+     * generated from (reserved in advance, so they stay in place).
+     */
+    std::vector<diagnostic::location> original_locations;
+
+    void add(const diagnostic::location& loc) {
+        const diagnostic::location& original = to_original(loc);
+        get_file(original.source_location.file).add(original);
+    }
+
+    /**
+     * Returns the location in the original source file of `loc` (following
+     * the fp::source_map of each generated file), or `loc` itself if its file
+     * wasn't generated or if it has no original location.
+     */
+    const diagnostic::location& to_original(const diagnostic::location& loc) {
+        std::optional<source_location> original;
+        const source_location* current = &loc.source_location;
+        while (const source_map* map = current->file.origin()) {
+            std::optional<source_location> mapped = map->to_original(*current);
+            if (!mapped) { break; }
+            original.emplace(*mapped);
+            current = &*original;
+        }
+        if (!original) { return loc; }
+        original_locations.push_back(diagnostic::location {
+            .kind            = loc.kind,
+            .source_location = *original,
+            .text            = loc.text
+        });
+        return original_locations.back();
+    }
+
     locations_in_file& get_file(const source_file& file) {
         for (locations_in_file& f : locations_by_file) {
             if (file == f.file) { return f; }
@@ -102,6 +135,7 @@ struct labeled_code {
         lines.clear();
         for (const auto& loc : file_locations.locations) {
             const auto& sl = loc->source_location;
+            size_t first_line_number = sl.line_number();
             for_each_line(sl, [&](auto& line) {
                 file_locations.max_line_number_width = std::max(
                     file_locations.max_line_number_width,
@@ -109,8 +143,8 @@ struct labeled_code {
                 );
                 if (loc->kind == location_kind::CONTEXTUAL) { return; }
                 size_t column_start =
-                    line.number == sl.line_number ?
-                    (sl.chars.begin() - sl.line) :
+                    line.number == first_line_number ?
+                    (sl.chars.begin() - line.content.begin()) :
                     (line.first_non_whitespace_char - line.content.begin());
                 bool is_last_line = line.content.end() >= sl.chars.end();
                 size_t column_end =
@@ -141,30 +175,23 @@ struct labeled_code {
 private:
     template <class Callback>
     void for_each_line(const source_location& location, Callback&& cb) {
-        size_t line_number = location.line_number;
-        source_iterator it = location.line;
-        cb(get_line(line_number, it, location.file.content.end()));
-        ++it;
-        for (; it != location.chars.end(); ++it) {
-            if (*(it - 1) == '\n') {
-                ++line_number;
-                cb(get_line(line_number, it, location.file.content.end()));
-            }
+        const source_file& file = location.file;
+        size_t first_line_number = location.line_number();
+        size_t last_line_number = first_line_number;
+        if (location.chars.size() > 1) {
+            last_line_number = file.line_number(location.chars.end() - 1);
+        }
+        for (size_t n = first_line_number; n <= last_line_number; ++n) {
+            cb(get_line(file, n));
         }
     }
 
-    labeled_code::line& get_line(
-        size_t line_number,
-        source_iterator line_start,
-        source_iterator file_end
-    ) {
+    labeled_code::line& get_line(const source_file& file, size_t line_number) {
         for (labeled_code::line& line : lines) {
             if (line_number == line.number) { return line; }
         }
-        source_iterator line_end = line_start;
-        while (line_end != file_end && *line_end != '\n') {
-            ++line_end;
-        }
+        source_iterator line_start = file.line_begin(line_number);
+        source_iterator line_end = file.line_end(line_number);
         source_iterator first_non_whitespace_char = line_start;
         while (first_non_whitespace_char != line_end) {
             if (!std::isspace(*first_non_whitespace_char)) { break; }
@@ -2,10 +2,10 @@
 
 #include <optional>
 #include <string>
-#include <vector>
 
 #include <fp/error_codes.h>
 #include <fp/source_code.h>
+#include <fp/util/small_vector.h>
 
 namespace fp::diagnostic {
 
@@ -44,7 +44,9 @@ struct problem {
     }
 
     /// Returns a list of relevant source locations.
-    const std::vector<location>& locations() const { return locations_; }
+    const util::small_vector<location, 2>& locations() const {
+        return locations_;
+    }
 
     /**
      * Returns the relevant error::code of the problem if available.
@@ -63,10 +65,10 @@ struct problem {
     problem& add_contextual(fp::source_location);
 
 private:
-    diagnostic::severity  severity_;
-    const error::code*    error_code_ = nullptr;
-    std::string           text_;
-    std::vector<location> locations_;
+    diagnostic::severity            severity_;
+    const error::code*              error_code_ = nullptr;
+    std::string                     text_;
+    util::small_vector<location, 2> locations_;
 
     problem(diagnostic::severity, const error::code*);
     problem(diagnostic::severity, std::string text);
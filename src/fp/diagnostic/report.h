@@ -19,6 +19,30 @@ struct report {
      */
     void set_max_errors(size_t n) { max_errors = n; }
 
+    /**
+     * The default error budget (see report::set_error_budget).
+     */
+    static constexpr size_t default_error_budget = 1000;
+
+    /**
+     * Sets the amount of diagnostic::error after which compilation stages stop
+     * looking for more errors in the input of this report (usually a single
+     * file), and skip the rest of it instead. For example, the lexer pushes the
+     * rest of the file as a single token::ERROR.
+     *
+     * Unlike report::set_max_errors, no exception is thrown, so pathological
+     * input (like a binary file) still has a result, which is produced quickly.
+     */
+    void set_error_budget(size_t n) { error_budget_ = n; }
+
+    /// Returns the error budget (see report::set_error_budget).
+    size_t error_budget() const { return error_budget_; }
+
+    /// Returns `true` if at least report::error_budget errors were reported.
+    bool error_budget_exhausted() const {
+        return errors_.size() >= error_budget_;
+    }
+
     //@{
     /// Returns the list of accumulated warnings.
           std::list<problem>& warnings()       { return warnings_; }
@@ -46,6 +70,7 @@ struct report {
 
 private:
     size_t max_errors = std::numeric_limits<size_t>::max();
+    size_t error_budget_ = default_error_budget;
     std::list<problem> errors_;
     std::list<problem> warnings_;
 };
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <numeric>
+#include <system_error>
+
+#include <fp/compilation_error.h>
+#include <fp/lex/tokenize.h>
+#include <fp/syntax/parse.h>
+#include <fp/util/thread_pool.h>
+
+#include "driver.h"
+
+namespace fp::driver {
+
+namespace detail {
+
+static void compile(file_result& result, symbol_table& symbols) {
+    try {
+        result.tokens = lex::tokenize(*result.file, result.report, symbols);
+        result.ast =
+            syntax::parse(result.tokens, result.arena, result.report);
+    } catch (const compilation_error&) {
+        // the maximum number of errors was reached, already in the report
+    }
+}
+
+/**
+ * Runs `process` on each file index using a util::thread_pool, starting from
+ * the largest files (by `sizes`), so that a large file isn't left to run
+ * alone at the end.
+ */
+static void for_each_file(
+    const std::vector<size_t>& sizes,
+    size_t jobs,
+    const std::function<void(size_t)>& process
+) {
+    std::vector<size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return sizes[a] > sizes[b];
+    });
+
+    util::thread_pool pool(std::min(
+        jobs ? jobs : std::max(1u, std::thread::hardware_concurrency()),
+        std::max<size_t>(sizes.size(), 1)
+    ));
+    for (size_t i : order) {
+        pool.submit([&process, i]() { process(i); });
+    }
+    pool.wait();
+}
+
+/// Merges the reports of all files (in order) into the result's report.
+static void merge_reports(result& r) {
+    for (const file_result& file : r.files) {
+        for (const auto& error : file.report.errors()) {
+            r.report.errors().push_back(error);
+        }
+        for (const auto& warning : file.report.warnings()) {
+            r.report.warnings().push_back(warning);
+        }
+    }
+}
+
+} // namespace detail
+
+result run(std::vector<std::unique_ptr<source_file>> files, size_t jobs) {
+    result r;
+    r.files.resize(files.size());
+    std::vector<size_t> sizes(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        sizes[i] = files[i]->content.size();
+        r.files[i].file = std::move(files[i]);
+    }
+    detail::for_each_file(sizes, jobs, [&r](size_t i) {
+        detail::compile(r.files[i], *r.symbols);
+    });
+    detail::merge_reports(r);
+    return r;
+}
+
+result run(const options& opts) {
+    result r;
+    r.files.resize(opts.files.size());
+    std::vector<size_t> sizes(opts.files.size());
+    for (size_t i = 0; i < opts.files.size(); ++i) {
+        std::error_code error;
+        sizes[i] = std::filesystem::file_size(opts.files[i], error);
+        if (error) { sizes[i] = 0; }
+    }
+    detail::for_each_file(sizes, opts.jobs, [&r, &opts](size_t i) {
+        file_result& file = r.files[i];
+        try {
+            file.file = source_file::map(opts.files[i]);
+        } catch (const std::system_error& e) {
+            file.report.add(diagnostic::error(e.what()));
+            return;
+        }
+        detail::compile(file, *r.symbols);
+    });
+    detail::merge_reports(r);
+    return r;
+}
+
+} // namespace fp::driver
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <fp/source_code.h>
+#include <fp/symbol_table.h>
+#include <fp/diagnostic/report.h>
+#include <fp/driver/options.h>
+#include <fp/lex/tokenized_list.h>
+#include <fp/syntax/ast/node.h>
+
+namespace fp::driver {
+
+/// The outcome of compiling a single source file.
+struct file_result {
+    /// The compiled source file (null if it couldn't be read).
+    std::unique_ptr<source_file> file;
+
+    /// The tokens of the source file.
+    lex::tokenized_list tokens;
+
+    /// Owns the nodes of `ast`.
+    syntax::ast::arena arena;
+
+    /// The AST of the source file, if parsing was reached.
+    std::optional<syntax::ast::node> ast;
+
+    /// The problems that were encountered while compiling the file.
+    diagnostic::report report;
+};
+
+/// The outcome of a driver::run.
+struct result {
+    /// The result of each file, in the order in which the files were given.
+    std::vector<file_result> files;
+
+    /**
+     * The symbols of the tokens of all the files (so that their IDs can be
+     * compared across files), which the files intern concurrently.
+     */
+    std::unique_ptr<symbol_table> symbols = std::make_unique<symbol_table>();
+
+    /**
+     * All the problems of all files, in the order in which the files were
+     * given. This doesn't depend on the number of jobs, or on the order in
+     * which files were processed.
+     */
+    diagnostic::report report;
+
+    /// Returns `true` if no errors were reported for any of the files.
+    bool succeeded() const { return report.errors().empty(); }
+};
+
+//@{
+/**
+ * Tokenizes and parses the given source files in parallel, using `jobs`
+ * threads (or the number of hardware threads, if `jobs` is 0).
+ *
+ * Each file is processed with its own diagnostic::report, and the reports are
+ * merged (in the order of the given files) once all files are done.
+ *
+ * When given driver::options, the files are memory-mapped (see
+ * source_file::map). Files that cannot be read are reported as errors in their
+ * own report.
+ */
+result run(std::vector<std::unique_ptr<source_file>> files, size_t jobs = 0);
+result run(const options&);
+//@}
+
+} // namespace fp::driver
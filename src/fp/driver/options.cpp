@@ -0,0 +1,50 @@
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+
+#include "options.h"
+
+namespace fp::driver {
+
+namespace detail {
+
+static size_t parse_jobs(std::string_view value) {
+    size_t jobs = 0;
+    auto [end, error] =
+        std::from_chars(value.data(), value.data() + value.size(), jobs);
+    if (value.empty() || error != std::errc() || end != value.end()) {
+        throw std::invalid_argument(
+            "invalid number of jobs: `" + std::string(value) + "`"
+        );
+    }
+    return jobs;
+}
+
+} // namespace detail
+
+options parse_arguments(std::span<const char* const> args) {
+    using namespace std::literals;
+    options result;
+    for (auto it = args.begin(); it != args.end(); ++it) {
+        std::string_view arg = *it;
+        if (arg == "-j"sv || arg == "--jobs"sv) {
+            if (++it == args.end()) {
+                throw std::invalid_argument(
+                    "missing number of jobs after `" + std::string(arg) + "`"
+                );
+            }
+            result.jobs = detail::parse_jobs(*it);
+        } else if (arg.starts_with("--jobs=")) {
+            result.jobs = detail::parse_jobs(arg.substr("--jobs="sv.size()));
+        } else if (arg.starts_with("-")) {
+            throw std::invalid_argument(
+                "unknown option `" + std::string(arg) + "`"
+            );
+        } else {
+            result.files.emplace_back(arg);
+        }
+    }
+    return result;
+}
+
+} // namespace fp::driver
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fp::driver {
+
+/// Options of a driver::run, usually given as command-line arguments.
+struct options {
+    /// Paths of the source files to compile.
+    std::vector<std::string> files;
+
+    /**
+     * Maximal number of files to process in parallel. If 0, the number of
+     * hardware threads is used.
+     */
+    size_t jobs = 0;
+};
+
+/**
+ * Parses command-line arguments (excluding the program name) into
+ * driver::options.
+ *
+ * The supported arguments are:
+ *
+ *     -j N, --jobs N, --jobs=N    number of parallel jobs
+ *     <path>                      a source file to compile
+ *
+ * @throws std::invalid_argument
+ *     When an argument is not recognized or is missing a valid value.
+ */
+options parse_arguments(std::span<const char* const> args);
+
+} // namespace fp::driver
@@ -43,4 +43,20 @@ inline code E0008_unsupported_float_base{
 
 inline code E0009_stray_exclamation_mark{"E0009", "stray exclamation mark"};
 
+inline code E0010_invalid_number_suffix{
+    "E0010",
+    "invalid number literal type suffix"
+};
+
+inline code E0011_number_out_of_range{
+    "E0011",
+    "number literal is out of the range of its type"
+};
+
+inline code E0012_invalid_utf8{"E0012", "invalid UTF-8 sequence"};
+
+inline code E0013_too_many_errors{"E0013", "too many errors"};
+
+inline code E0014_nesting_too_deep{"E0014", "expression is nested too deeply"};
+
 } // namespace fp::error
@@ -4,6 +4,7 @@
 
 #include <fp/literal_types.h>
 #include <fp/source_code.h>
+#include <fp/symbol_table.h>
 #include <fp/lex/token.h>
 
 namespace fp::lex {
@@ -14,10 +15,10 @@ namespace detail {
 //            lex::attribute_t variant below.
 template <token> struct attr_helper               { using type = void       ; };
 template <> struct attr_helper<token::COMMENT   > { using type = source_view; };
-template <> struct attr_helper<token::IDENTIFIER> { using type = source_view; };
-template <> struct attr_helper<token::NUMBER    > { using type = source_view; };
+template <> struct attr_helper<token::IDENTIFIER> { using type = symbol_id  ; };
+template <> struct attr_helper<token::NUMBER    > { using type = number_t   ; };
 template <> struct attr_helper<token::CHAR      > { using type = char_t     ; };
-template <> struct attr_helper<token::STRING    > { using type = std::string; };
+template <> struct attr_helper<token::STRING    > { using type = symbol_id  ; };
 
 } // namespace detail
 
@@ -25,16 +26,19 @@ template <> struct attr_helper<token::STRING    > { using type = std::string; };
  * Represents a lex::token's attribute type.
  *
  * The tokenizer attaches an attribute to each parsed token (for example, a
- * token::INTEGER is attached with an fp::integer_type attribute that holds the
- * actual integer's value).
+ * token::NUMBER is attached with an fp::number_t attribute that holds the
+ * actual number's value).
  *
  * Most tokens have no attributes to them, and so their attribute will be void.
+ *
+ * Identifiers and (decoded) string literals are interned in the symbol table
+ * given to the tokenizer, and their attribute is their fp::symbol_id.
  */
 template <token TOKEN>
 using token_attribute_t = typename detail::attr_helper<TOKEN>::type;
 
 /// The attribute value of a lex::token (see lex::token_attribute_t).
 using attribute_t =
-    std::variant<std::monostate, source_view, char_t, std::string>;
+    std::variant<std::monostate, source_view, char_t, symbol_id, number_t>;
 
 } // namespace fp::lex
@@ -0,0 +1,72 @@
+#include <algorithm>
+
+#include "bracket_index.h"
+
+namespace fp::lex {
+
+bracket_index::bracket_index(tokenized_view tokens) {
+    matches.reserve(tokens.size());
+    for (const tokenized_token& t : tokens) { push(t.token); }
+}
+
+/// Returns the index of the kind of the given closing bracket in `n_open`.
+static size_t kind(token closing) {
+    switch (closing) {
+        case token::R_PAREN:   return 0;
+        case token::R_BRACKET: return 1;
+        default:               return 2;
+    }
+}
+
+std::vector<size_t> bracket_index::unmatched_brackets() const {
+    std::vector<size_t> result(
+        closed_unmatched.begin(),
+        closed_unmatched.end()
+    );
+    for (const open_bracket& bracket : open) {
+        result.push_back(bracket.index);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void bracket_index::push_bracket(token t) {
+    auto index = index_t(matches.size());
+    matches.push_back(unmatched_index);
+    switch (t) {
+        case token::L_PAREN:
+            open.push_back({index, token::R_PAREN});
+            ++n_open[kind(token::R_PAREN)];
+            return;
+        case token::L_BRACKET:
+            open.push_back({index, token::R_BRACKET});
+            ++n_open[kind(token::R_BRACKET)];
+            return;
+        case token::L_BRACE:
+            open.push_back({index, token::R_BRACE});
+            ++n_open[kind(token::R_BRACE)];
+            return;
+        default:
+            break;
+    }
+
+    // without an open bracket of the same kind, the stack isn't searched (so
+    // each search ends with a match, and removes all the brackets it passes)
+    if (n_open[kind(t)] == 0) {
+        closed_unmatched.push_back(index);
+        return;
+    }
+    // the brackets inside the innermost open bracket of the same kind are left
+    // unmatched
+    while (open.back().closing != t) {
+        closed_unmatched.push_back(open.back().index);
+        --n_open[kind(open.back().closing)];
+        open.pop_back();
+    }
+    matches[open.back().index] = index;
+    matches[index] = open.back().index;
+    --n_open[kind(t)];
+    open.pop_back();
+}
+
+} // namespace fp::lex
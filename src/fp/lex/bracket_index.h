@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <fp/lex/token.h>
+#include <fp/lex/tokenized_list.h>
+
+namespace fp::lex {
+
+/**
+ * The matching brackets of a list of tokens: for each `(`, `[` and `{` the
+ * index of its closing bracket, and vice versa.
+ *
+ * It's built along with the tokens (see lex::tokenize), so that the parser and
+ * tools (like folding) can find the end of a bracketed section in O(1), rather
+ * than walking over its tokens.
+ *
+ * A closing bracket matches the innermost open bracket of the same kind. The
+ * open brackets inside it are left unmatched (e.g. the `(` in `{(}`), and a
+ * closing bracket without an open bracket of its kind is unmatched.
+ *
+ * ~~~{.cpp}
+ * lex::bracket_index brackets;
+ * lex::tokenized_list tokens = lex::tokenize(file, report, brackets);
+ * size_t closing_brace = brackets[i]; // assuming tokens[i] is a `{`
+ * if (closing_brace != lex::bracket_index::unmatched) {
+ *     // skip the whole block
+ * }
+ * ~~~
+ */
+struct bracket_index {
+    /// The index of the match of tokens that are unmatched (or not brackets).
+    static constexpr size_t unmatched = std::numeric_limits<size_t>::max();
+
+    bracket_index() = default;
+
+    /// Builds the index of the given `tokens`.
+    explicit bracket_index(tokenized_view tokens);
+
+    /**
+     * Returns the index of the bracket that matches the token at index `i`, or
+     * bracket_index::unmatched if there's none (or if it's not a bracket).
+     */
+    size_t operator[](size_t i) const {
+        return matches[i] == unmatched_index ? unmatched : matches[i];
+    }
+
+    /// Returns the number of tokens in the index.
+    size_t size() const { return matches.size(); }
+
+    /// Returns the indices of all the unmatched brackets, in order.
+    std::vector<size_t> unmatched_brackets() const;
+
+    /// Adds the next token `t` to the index.
+    void push(token t) {
+        switch (t) {
+            case token::L_PAREN:
+            case token::L_BRACKET:
+            case token::L_BRACE:
+            case token::R_PAREN:
+            case token::R_BRACKET:
+            case token::R_BRACE:
+                push_bracket(t);
+                return;
+            default:
+                matches.push_back(unmatched_index);
+        }
+    }
+
+private:
+    /// Indices are stored in 32 bits (like the offsets in lex::token_stream).
+    using index_t = uint32_t;
+
+    static constexpr index_t unmatched_index =
+        std::numeric_limits<index_t>::max();
+
+    /// Adds the next token `t` to the index, assuming that it's a bracket.
+    void push_bracket(token t);
+
+    /// An opening bracket whose closing bracket wasn't pushed yet.
+    struct open_bracket {
+        index_t index;
+        token   closing;
+    };
+
+    /// The index of the match of each token.
+    std::vector<index_t> matches;
+
+    /// The stack of the open brackets, from the outermost to the innermost.
+    std::vector<open_bracket> open;
+
+    /// The number of open brackets of each kind (`(`, `[` and `{`).
+    size_t n_open[3] = {};
+
+    /// The unmatched brackets that were pushed (except for those in `open`).
+    std::vector<index_t> closed_unmatched;
+};
+
+} // namespace fp::lex
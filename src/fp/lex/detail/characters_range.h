@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 //#include <fp/util/static_string_view.h>
 #include <fp/source_code.h>
 
@@ -29,6 +32,17 @@ using decimal_digits    = characters_range<'0', '9'>;
 using uppercase_letters = characters_range<'A', 'Z'>;
 using lowercase_letters = characters_range<'a', 'z'>;
 
+using hex_digits = composite_characters_range<
+    decimal_digits,
+    characters_range<'A', 'F'>,
+    characters_range<'a', 'f'>
+>;
+
+/// Returns the value of a (valid) digit, in any base up to 16.
+constexpr uint32_t digit_value(char c) {
+    return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+}
+
 using identifier_characters = composite_characters_range<
     decimal_digits,
     uppercase_letters,
@@ -41,4 +55,14 @@ using letters = composite_characters_range<
     lowercase_letters
 >;
 
+/**
+ * Maps an ASCII character (-128...127) to an index (0...255) in a table of all
+ * characters (e.g. the tokenizers dispatch table: detail::tokenizers_table).
+ */
+struct char_to_index {
+    constexpr size_t operator()(char c) const {
+        return size_t((unsigned char)c);
+    }
+};
+
 } // namespace fp::lex::detail
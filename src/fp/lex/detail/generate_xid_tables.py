@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""
+Generates xid_tables.inl: the ranges of the non-ASCII code points with the
+Unicode XID_Start and XID_Continue properties, used to tokenize identifiers.
+
+The properties are taken from Python's unicodedata (whose identifiers are
+defined by the same properties), so the tables match the Unicode version of
+the Python interpreter that generates them:
+
+    python3 generate_xid_tables.py > xid_tables.inl
+"""
+
+import sys
+import unicodedata
+
+
+def ranges(predicate):
+    """Returns the ranges `[first, last]` of non-ASCII code points that
+    satisfy `predicate`."""
+    result = []
+    for code_point in range(0x80, sys.maxunicode + 1):
+        if not predicate(chr(code_point)):
+            continue
+        if result and result[-1][1] == code_point - 1:
+            result[-1][1] = code_point
+        else:
+            result.append([code_point, code_point])
+    return result
+
+
+def is_xid_start(c):
+    return c.isidentifier()
+
+
+def is_xid_continue(c):
+    return ('a' + c).isidentifier()
+
+
+def print_table(name, table):
+    print(f'constexpr code_point_range {name}[] = {{')
+    line = '   '
+    for first, last in table:
+        entry = f' {{0x{first:X}, 0x{last:X}}},'
+        if len(line) + len(entry) > 80:
+            print(line)
+            line = '   '
+        line += entry
+    print(line)
+    print('};')
+
+
+print(f'''\
+// Generated by generate_xid_tables.py from Unicode \
+{unicodedata.unidata_version}. Do not edit.
+//
+// The (sorted) ranges of non-ASCII code points with the XID_Start and
+// XID_Continue properties. This file is included by utf8.cpp.
+''')
+print_table('xid_start_ranges', ranges(is_xid_start))
+print()
+print_table('xid_continue_ranges', ranges(is_xid_continue))
@@ -0,0 +1,151 @@
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FP_SCAN_X86
+#endif
+
+#include "scan.h"
+
+namespace fp::lex::detail {
+
+// scalar classification of characters, used by all kernels for the leftover
+// characters that do not fill a whole vector
+
+constexpr bool is_whitespace(char c) {
+    return c == ' ' || ('\t' <= c && c <= '\r');
+}
+
+constexpr bool is_identifier_character(char c) {
+    return
+        ('0' <= c && c <= '9') ||
+        ('A' <= c && c <= 'Z') ||
+        ('a' <= c && c <= 'z') ||
+        c == '_';
+}
+
+constexpr bool is_line_break(char c) { return c == '\n' || c == '\r'; }
+
+constexpr bool is_not_line_break(char c) { return !is_line_break(c); }
+
+constexpr bool is_single_quoted(char c) {
+    return !is_line_break(c) && c != '\\' && c != '\'';
+}
+
+constexpr bool is_double_quoted(char c) {
+    return !is_line_break(c) && c != '\\' && c != '"' && c != '{';
+}
+
+constexpr bool is_ascii(char c) { return !(c & 0x80); }
+
+/// Scans `chars` one character at a time, starting from offset `i`.
+template <bool (*CONTAINS)(char)>
+size_t scan_scalar_from(source_view chars, size_t i) {
+    while (i < chars.size() && CONTAINS(chars[i])) { ++i; }
+    return i;
+}
+
+template <bool (*CONTAINS)(char)>
+size_t scan_scalar(source_view chars) {
+    return scan_scalar_from<CONTAINS>(chars, 0);
+}
+
+namespace scalar {
+
+constexpr scan_kernels kernels = {
+    .whitespace       = scan_scalar<is_whitespace>,
+    .identifier       = scan_scalar<is_identifier_character>,
+    .until_line_break = scan_scalar<is_not_line_break>,
+    .single_quoted    = scan_scalar<is_single_quoted>,
+    .double_quoted    = scan_scalar<is_double_quoted>,
+    .ascii            = scan_scalar<is_ascii>
+};
+
+} // namespace scalar
+
+#if defined(FP_SCAN_X86)
+
+namespace sse2 {
+
+struct ops {
+    using vec = __m128i;
+    static constexpr size_t width = 16;
+
+    static vec load(const char* p) {
+        return _mm_loadu_si128(reinterpret_cast<const vec*>(p));
+    }
+    static vec set1(char c) { return _mm_set1_epi8(c); }
+    static vec eq(vec a, vec b) { return _mm_cmpeq_epi8(a, b); }
+    static vec gt(vec a, vec b) { return _mm_cmpgt_epi8(a, b); }
+    static vec or_(vec a, vec b) { return _mm_or_si128(a, b); }
+    static vec and_(vec a, vec b) { return _mm_and_si128(a, b); }
+    static uint32_t mask(vec v) { return uint32_t(_mm_movemask_epi8(v)); }
+};
+
+#include <fp/lex/detail/scan_kernels.inl>
+
+} // namespace sse2
+
+// The AVX2 kernels are compiled for AVX2 regardless of the compilation flags,
+// and are only used after checking that the running CPU supports AVX2.
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+namespace avx2 {
+
+struct ops {
+    using vec = __m256i;
+    static constexpr size_t width = 32;
+
+    static vec load(const char* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const vec*>(p));
+    }
+    static vec set1(char c) { return _mm256_set1_epi8(c); }
+    static vec eq(vec a, vec b) { return _mm256_cmpeq_epi8(a, b); }
+    static vec gt(vec a, vec b) { return _mm256_cmpgt_epi8(a, b); }
+    static vec or_(vec a, vec b) { return _mm256_or_si256(a, b); }
+    static vec and_(vec a, vec b) { return _mm256_and_si256(a, b); }
+    static uint32_t mask(vec v) { return uint32_t(_mm256_movemask_epi8(v)); }
+};
+
+#include <fp/lex/detail/scan_kernels.inl>
+
+} // namespace avx2
+
+#pragma GCC pop_options
+
+#endif // FP_SCAN_X86
+
+const scan_kernels* get_scan_kernels(scan_isa isa) {
+#if defined(FP_SCAN_X86)
+    // might be called before the CPU model is initialized by the runtime
+    // (during static initialization, see detail::scan)
+    __builtin_cpu_init();
+#endif
+    switch (isa) {
+        case scan_isa::SCALAR:
+            return &scalar::kernels;
+#if defined(FP_SCAN_X86)
+        case scan_isa::SSE2:
+            return __builtin_cpu_supports("sse2") ? &sse2::kernels : nullptr;
+        case scan_isa::AVX2:
+            return __builtin_cpu_supports("avx2") ? &avx2::kernels : nullptr;
+#else
+        case scan_isa::SSE2:
+        case scan_isa::AVX2:
+            return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+const scan_kernels& select_scan_kernels() {
+    for (scan_isa isa : {scan_isa::AVX2, scan_isa::SSE2}) {
+        if (const scan_kernels* kernels = get_scan_kernels(isa)) {
+            return *kernels;
+        }
+    }
+    return scalar::kernels;
+}
+
+} // namespace fp::lex::detail
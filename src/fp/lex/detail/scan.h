@@ -0,0 +1,66 @@
+#pragma once
+
+#include <fp/source_code.h>
+
+namespace fp::lex::detail {
+
+/// Instruction sets for which detail::scan_kernels are implemented.
+enum class scan_isa { SCALAR, SSE2, AVX2 };
+
+/**
+ * A set of functions that scan a section of source code for the end of runs of
+ * characters that are common when tokenizing (whitespace, identifiers, comment
+ * bodies, quoted content and ASCII).
+ *
+ * Each function receives the source code to scan, and returns the offset of
+ * the first character that does not belong to the run (or the size of the
+ * given source code if all of its characters belong to the run).
+ *
+ * The kernels never read past the end of the given source code.
+ */
+struct scan_kernels {
+    /// Skips whitespace: ` `, `\t`, `\n`, `\v`, `\f`, `\r`.
+    size_t (*whitespace)(source_view);
+
+    /// Skips identifier characters: `0-9`, `A-Z`, `a-z`, `_`.
+    size_t (*identifier)(source_view);
+
+    /// Skips anything that is not a line-break (`\n` or `\r`).
+    size_t (*until_line_break)(source_view);
+
+    /**
+     * Skips anything that is not a line-break, a backslash (`\`) or a single
+     * quote (`'`).
+     */
+    size_t (*single_quoted)(source_view);
+
+    /**
+     * Skips anything that is not a line-break, a backslash (`\`), a double
+     * quote (`"`) or a left-brace (`{`).
+     */
+    size_t (*double_quoted)(source_view);
+
+    /// Skips ASCII characters (any character below `0x80`).
+    size_t (*ascii)(source_view);
+};
+
+/**
+ * Returns the kernels implemented using the given instruction set, or `null` if
+ * the running CPU doesn't support it.
+ */
+const scan_kernels* get_scan_kernels(scan_isa);
+
+/// Returns the best scan kernels supported by the running CPU.
+const scan_kernels& select_scan_kernels();
+
+/**
+ * Returns the best scan kernels supported by the running CPU, which are
+ * selected on the first call (so they can be used during static
+ * initialization).
+ */
+inline const scan_kernels& scan() {
+    static const scan_kernels& kernels = select_scan_kernels();
+    return kernels;
+}
+
+} // namespace fp::lex::detail
@@ -0,0 +1,92 @@
+// Generic implementation of detail::scan_kernels over a vector instruction set.
+//
+// This file is included (by scan.cpp) once per instruction set, inside a
+// namespace that defines an `ops` struct with the following members:
+//
+//      vec                 vector type
+//      width               number of characters in a vector
+//      load(p)             loads `width` characters from `p` (unaligned)
+//      set1(c)             vector with all characters set to `c`
+//      eq(a, b), gt(a, b)  per-character (signed) comparisons
+//      or_(a, b), and_(..) per-character bitwise operations
+//      mask(v)             bitmask of the most significant bit of each char
+//
+// Note that characters are compared as signed, so non-ASCII characters (which
+// are negative) never fall inside any of the ASCII ranges below.
+
+/// Per-character mask of characters in the range `[FROM, TO]`.
+template <char FROM, char TO>
+ops::vec in_range(ops::vec v) {
+    return ops::and_(
+        ops::gt(v, ops::set1(FROM - 1)),
+        ops::gt(ops::set1(TO + 1), v)
+    );
+}
+
+inline ops::vec whitespace(ops::vec v) {
+    return ops::or_(ops::eq(v, ops::set1(' ')), in_range<'\t', '\r'>(v));
+}
+
+inline ops::vec identifier_character(ops::vec v) {
+    // setting the 0x20 bit turns uppercase letters into lowercase ones, without
+    // turning any other character into a letter
+    ops::vec lowercase = ops::or_(v, ops::set1(0x20));
+    return ops::or_(
+        ops::or_(in_range<'a', 'z'>(lowercase), in_range<'0', '9'>(v)),
+        ops::eq(v, ops::set1('_'))
+    );
+}
+
+inline ops::vec line_break(ops::vec v) {
+    return ops::or_(ops::eq(v, ops::set1('\n')), ops::eq(v, ops::set1('\r')));
+}
+
+inline ops::vec single_quoted_stop(ops::vec v) {
+    return ops::or_(
+        line_break(v),
+        ops::or_(ops::eq(v, ops::set1('\\')), ops::eq(v, ops::set1('\'')))
+    );
+}
+
+inline ops::vec double_quoted_stop(ops::vec v) {
+    return ops::or_(
+        ops::or_(line_break(v), ops::eq(v, ops::set1('\\'))),
+        ops::or_(ops::eq(v, ops::set1('"')), ops::eq(v, ops::set1('{')))
+    );
+}
+
+/// The most significant bit of a character is already its mask.
+inline ops::vec non_ascii(ops::vec v) { return v; }
+
+/**
+ * Scans `chars` a vector at a time, and returns the offset of the first
+ * character that matches (when `MATCHES` is `true`) or doesn't match (when
+ * `MATCHES` is `false`) the given `CLASSIFY` function. The leftover characters
+ * are scanned using `CONTAINS`.
+ */
+template <ops::vec (*CLASSIFY)(ops::vec), bool MATCHES, bool (*CONTAINS)(char)>
+size_t scan_vectorized(source_view chars) {
+    constexpr uint32_t all = ops::width == 32 ? ~0u : (1u << ops::width) - 1;
+    size_t i = 0;
+    for (; i + ops::width <= chars.size(); i += ops::width) {
+        uint32_t mask = ops::mask(CLASSIFY(ops::load(chars.data() + i)));
+        if (!MATCHES) { mask ^= all; }
+        if (mask) { return i + __builtin_ctz(mask); }
+    }
+    return scan_scalar_from<CONTAINS>(chars, i);
+}
+
+const scan_kernels kernels = {
+    .whitespace =
+        scan_vectorized<whitespace, false, is_whitespace>,
+    .identifier =
+        scan_vectorized<identifier_character, false, is_identifier_character>,
+    .until_line_break =
+        scan_vectorized<line_break, true, is_not_line_break>,
+    .single_quoted =
+        scan_vectorized<single_quoted_stop, true, is_single_quoted>,
+    .double_quoted =
+        scan_vectorized<double_quoted_stop, true, is_double_quoted>,
+    .ascii =
+        scan_vectorized<non_ascii, true, is_ascii>
+};
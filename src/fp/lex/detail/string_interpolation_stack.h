@@ -1,8 +1,7 @@
 #pragma once
 
-#include <deque>
-
 #include <fp/source_code.h>
+#include <fp/util/small_vector.h>
 
 namespace fp::lex::detail {
 
@@ -79,7 +78,8 @@ struct string_interpolation_stack {
     }
 
 private:
-    std::deque<frame> stack_;
+    /// Strings are rarely nested deeper than a few levels.
+    util::small_vector<frame, 4> stack_;
 };
 
 } // namespace fp::lex::detail
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include <fp/literal_types.h>
 #include <fp/error_codes.h>
 #include <fp/source_code.h>
+#include <fp/symbol_table.h>
 #include <fp/diagnostic/report.h>
+#include <fp/lex/bracket_index.h>
 #include <fp/lex/tokenized_list.h>
+#include <fp/lex/token_stream.h>
 #include <fp/lex/detail/string_interpolation_stack.h>
 
 namespace fp::lex::detail {
@@ -18,18 +24,46 @@ struct tokenization_state {
     /// See detail::string_interpolation_stack for details.
     detail::string_interpolation_stack string_interpolation_stack;
 
+    /// Identifiers and string literals are interned in this table.
+    symbol_table& symbols;
+
+    /**
+     * A buffer for decoding string and number literals (reused, so that
+     * decoding doesn't allocate memory for each literal).
+     */
+    std::string string_buffer;
+
+    /// If not null, the pushed tokens are also added to this index.
+    bracket_index* brackets = nullptr;
+
     tokenization_state(
         const source_file& file,
         tokenized_list& output_tokens_list,
-        diagnostic::report& report
+        diagnostic::report& report,
+        symbol_table& symbols
     ) :
         file(file),
         next(file.content.begin()),
         end(file.content.end()),
-        tokens(output_tokens_list),
+        symbols(symbols),
+        tokens(&output_tokens_list),
         report(report),
-        token_begin(next),
-        line_begin(next)
+        token_begin(next)
+    {}
+
+    tokenization_state(
+        const source_file& file,
+        token_stream& output_token_stream,
+        diagnostic::report& report,
+        symbol_table& symbols
+    ) :
+        file(file),
+        next(file.content.begin()),
+        end(file.content.end()),
+        symbols(symbols),
+        stream(&output_token_stream),
+        report(report),
+        token_begin(next)
     {}
 
     /// Reports a diagnostic::error with the given error::code.
@@ -44,28 +78,25 @@ struct tokenization_state {
          return report.errors().back();
     }
 
+    /// Returns `true` if the error budget of the report is exhausted.
+    bool error_budget_exhausted() const {
+        return report.error_budget_exhausted();
+    }
+
     /// Reports the given diagnostic::problem.
     diagnostic::problem& report_problem(diagnostic::problem p) {
         return report.add(std::move(p));
     }
 
     //@{
-    /**
-     * Returns the source location of the given source code section, filling in
-     * missing details using available line information.
-     */
+    /// Returns the source location of the given source code section.
     source_location location(source_view source_section) {
-        return source_location {
-            .chars = source_section,
-            .file = file,
-            .line = line_begin,
-            .line_number = line_number
-        };
+        return source_location { .chars = source_section, .file = file };
     }
     source_location location(source_iterator from, source_iterator to) {
         return location(source_view(from, to));
     }
-    //}
+    //@}
 
     /// Returns the source section of the current token.
     source_view current_token_characters() {
@@ -83,12 +114,6 @@ struct tokenization_state {
      */
     void begin_next_token() { token_begin = next; }
 
-    /// Indicates that the next character is the beginning of a new line.
-    void begin_new_line() {
-        line_begin = next;
-        ++line_number;
-    }
-
     /// Returns `true` if the the next character in the source is `c`.
     bool next_is(char c) const { return next != end && *next == c; }
 
@@ -98,33 +123,17 @@ struct tokenization_state {
     }
 
     /// Push the token to the output list (token_attribute_t must be void).
-    void push(token t) {
-        tokens.push_back({
-            .token = t,
-            .dummy = false,
-            .source_location = current_token_location()
-        });
-    }
+    void push(token t) { push_token(t, false, {}); }
 
     /// Push `TOKEN` to the output list with the given `attribute` attached.
     template <token TOKEN>
     void push(token_attribute_t<TOKEN> attribute) {
-        tokens.push_back({
-            .token = TOKEN,
-            .dummy = false,
-            .attribute = std::move(attribute),
-            .source_location = current_token_location()
-        });
+        push_token(TOKEN, false, std::move(attribute));
     }
 
     /// Push a dummy error `TOKEN`.
     void push_dummy(token t, lex::attribute_t attribute = {}) {
-        tokens.push_back({
-            .token = t,
-            .dummy = true,
-            .attribute = std::move(attribute),
-            .source_location = current_token_location()
-        });
+        push_token(t, true, std::move(attribute));
     }
 
     /// Consume the next character and tokenize it as the given token.
@@ -134,7 +143,14 @@ struct tokenization_state {
     }
 
 private:
-    tokenized_list& tokens; ///< The list of tokens produced so far.
+    //@{
+    /**
+     * The output of tokenization. Exactly one of these is non-null, depending
+     * on the constructor used.
+     */
+    tokenized_list* tokens = nullptr; ///< The list of tokens produced so far.
+    token_stream*   stream = nullptr; ///< The stream of tokens produced so far.
+    //@}
 
     /// Any problems encountered during tokenization is reported here.
     diagnostic::report& report;
@@ -148,15 +164,43 @@ private:
      */
     source_iterator token_begin;
 
-    /**
-     * Points to the beginning of the current line.
-     *
-     * After consuming a newline character, this iterator needs to be updated by
-     * calling tokenization_state::begin_new_line().
-     */
-    source_iterator line_begin;
-
-    size_t line_number = 1; ///< Holds the current line's number.
+    /// Push the current token to the output (either a list or a stream).
+    void push_token(token t, bool dummy, lex::attribute_t attribute) {
+        if (brackets) { brackets->push(t); }
+        if (stream) {
+            stream->push(
+                t,
+                dummy,
+                std::move(attribute),
+                current_token_characters()
+            );
+            return;
+        }
+        tokens->push_back({
+            .token = t,
+            .dummy = dummy,
+            .attribute = std::move(attribute),
+            .source_location = current_token_location()
+        });
+    }
 };
 
+/**
+ * Tokenizes the next token of `s` (along with any whitespace before it), using
+ * the detail::tokenizers_table (defined in tokenize.cpp, which is the only
+ * translation unit that includes the table).
+ */
+void tokenize_next(tokenization_state& s);
+
+/**
+ * Returns, for each token in `tokens` (and for the end of the list), whether
+ * the string interpolation stack is empty right before the token. Tokenization
+ * can only restart from such tokens.
+ *
+ * This replays the changes that the tokenizers make to the
+ * detail::string_interpolation_stack, which only depend on the tokens that
+ * they push (token::QUOTE, token::L_BRACE and token::R_BRACE).
+ */
+std::vector<bool> restartable_tokens(const tokenized_list& tokens);
+
 } // namespace fp::lex::detail
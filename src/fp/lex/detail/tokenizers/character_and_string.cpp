@@ -1,5 +1,9 @@
 #include <optional>
 
+#include <fp/lex/detail/characters_range.h>
+#include <fp/lex/detail/scan.h>
+#include <fp/lex/detail/utf8.h>
+
 #include "character_and_string.h"
 
 namespace fp::lex::detail {
@@ -20,20 +24,62 @@ namespace fp::lex::detail {
  */
 template <char QUOTE>
 source_view quoted_content(source_iterator begin, source_iterator end) {
-    constexpr auto is_terminator = [](char c) {
-        return c == QUOTE || (QUOTE == '"' && c == '{');
-    };
     source_iterator it = begin;
-    for (; it != end; ++it) {
-        if (*it == '\n' || *it == '\r' || is_terminator(*it)) { break; }
-        if (*it == '\\' && (it + 1) != end && is_terminator(*(it + 1))) {
-            // skip escaped terminators
+    while (true) {
+        // skip to the next line-break, backslash or terminator
+        source_view rest(it, end);
+        it += QUOTE == '"' ? scan().double_quoted(rest)
+                           : scan().single_quoted(rest);
+        if (it == end || *it != '\\') { break; }
+        ++it;
+        if (it != end && *it == 'u' && it + 1 != end && it[1] == '{') {
+            // skip the left-brace of unicode escape sequences
+            it += 2;
+        } else if (it != end && *it != '\n' && *it != '\r') {
+            // skip the escaped character, which may be a terminator or another
+            // backslash (so that in `'\\'` the quote is not escaped)
             ++it;
         }
     }
     return {begin, it};
 }
 
+/**
+ * Consumes the rest of a `\u{...}` escape sequence (1 to 6 hexadecimal digits
+ * of a code point), given that `it` points right after its `u`, and returns
+ * its value (or std::nullopt on error).
+ */
+static std::optional<char_t> consume_unicode_escape(
+    tokenization_state& s,
+    source_view content,
+    source_iterator& it
+) {
+    auto report = [&](const char* text) -> std::optional<char_t> {
+        s.report_error(&error::E0005_invalid_escape_sequence)
+            .add_primary(s.location(content.begin(), it), text);
+        return std::nullopt;
+    };
+    if (it == content.end() || *it != '{') {
+        return report("expected `{` after `\\u`");
+    }
+    ++it;
+    char_t value = 0;
+    size_t digits = 0;
+    for (; it != content.end() && hex_digits::contain(*it); ++it, ++digits) {
+        // more than 6 digits are consumed (and reported) as a whole
+        value = digits < 6 ? value << 4 | digit_value(*it) : value;
+    }
+    if (it == content.end() || *it != '}') {
+        return report("expected `}` after the code point's digits");
+    }
+    ++it;
+    if (digits == 0) { return report("missing code point digits"); }
+    if (digits > 6 || !is_valid_code_point(value)) {
+        return report("invalid code point");
+    }
+    return value;
+}
+
 /**
  * Consumes a single char from a character or string literal, which could
  * potentially be represented as an escape sequence, and returns its value.
@@ -43,9 +89,8 @@ source_view quoted_content(source_iterator begin, source_iterator end) {
  *
  * On error (invalid character), a std::nullopt will be returned instead.
  *
- * At the moment, Unicode is not supported. When encountering a UTF-8 byte, the
- * entire Unicode code point will be consumed (1 to 4 bytes), and std::nullopt
- * will be returned to denote an error.
+ * Non-ASCII characters are decoded from UTF-8 (1 to 4 bytes). An invalid
+ * UTF-8 sequence is consumed as a whole, and reported as an error.
  *
  * @tparam QUOTE
  *     When tokenizing a character literal, this should be a single-quote, and
@@ -58,7 +103,6 @@ source_view quoted_content(source_iterator begin, source_iterator end) {
  *      This iterator will be updated to the position after consumption.
  *
  * @todo Handle `\xFF` escape sequences.
- * @todo Handle unicode characters (and `\u` escape sequences).
  */
 template <char_t QUOTE>
 std::optional<char_t> consume_char(
@@ -69,13 +113,14 @@ std::optional<char_t> consume_char(
     // skip the first char, regardless of whether it is a blackslash or not
     it = content.begin() + 1;
 
-    // UTF-8 not supported yet
     if (content.front() & 0x80) {
-        for (; it != content.end() && *it & 0x80; ++it) {}
-        s.report_error("unicode is not supported yet")
+        utf8_code_point c = decode_utf8(content);
+        it = content.begin() + c.size;
+        if (c.valid) { return c.value; }
+        s.report_error(&error::E0012_invalid_utf8)
             .add_primary(
                 s.location(content.begin(), it),
-                "unicode literals are not supported yet, sorry!"
+                "invalid UTF-8 sequence"
             );
         return std::nullopt;
     }
@@ -98,6 +143,8 @@ std::optional<char_t> consume_char(
         case '0':   return '\0';
     }
 
+    if (content[1] == 'u') { return consume_unicode_escape(s, content, it); }
+
     s.report_error(&error::E0005_invalid_escape_sequence)
         .add_primary(
             s.location(content.begin(), it),
@@ -222,9 +269,10 @@ static void tokenize_string(tokenization_state& s) {
     // if the quoted content is empty, do nothing
     if (quoted_content.empty()) { return; }
 
-    // parse the quoted content into the string token's `value`.
-    token_attribute_t<token::STRING> value;
-    value.reserve(quoted_content.size());
+    // parse the quoted content into the string token's `value`, which is then
+    // interned as the token's attribute
+    std::string& value = s.string_buffer;
+    value.clear();
     while (!quoted_content.empty()) {
         // consume a character from the quoted content
         source_iterator consume_end;
@@ -239,10 +287,10 @@ static void tokenize_string(tokenization_state& s) {
             return;
         }
 
-        value += char(*char_value);
+        encode_utf8(*char_value, value);
     }
 
-    s.push<token::STRING>(std::move(value));
+    s.push<token::STRING>(s.symbols.intern(value));
 }
 
 void tokenize_double_quote(tokenization_state& s) {
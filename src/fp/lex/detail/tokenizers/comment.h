@@ -1,13 +1,54 @@
 #pragma once
 
+#include <string>
+
+#include <fp/error_codes.h>
+#include <fp/lex/detail/scan.h>
 #include <fp/lex/detail/tokenization_state.h>
+#include <fp/lex/detail/utf8.h>
 
 namespace fp::lex::detail {
 
+/**
+ * Reports each run of consecutive invalid UTF-8 sequences in `chars` (the
+ * characters of a comment, which are otherwise not decoded) as a single error.
+ *
+ * Runs of ASCII characters are skipped by the scan kernels, so only non-ASCII
+ * characters are decoded.
+ */
+inline void report_invalid_utf8(tokenization_state& s, source_view chars) {
+    source_iterator it = chars.begin();
+    while (true) {
+        it += scan().ascii(source_view(it, chars.end()));
+        if (it == chars.end()) { break; }
+        utf8_code_point c = decode_utf8(source_view(it, chars.end()));
+        if (c.valid) {
+            it += c.size;
+            continue;
+        }
+        source_iterator begin = it;
+        size_t count = 0;
+        while (!c.valid) {
+            it += c.size;
+            ++count;
+            if (it == chars.end() || !(*it & 0x80)) { break; }
+            c = decode_utf8(source_view(it, chars.end()));
+        }
+        s.report_error(&error::E0012_invalid_utf8)
+            .add_primary(
+                s.location(begin, it),
+                count == 1 ?
+                    "invalid UTF-8 sequence" :
+                    std::to_string(count) + " invalid UTF-8 sequences"
+            );
+    }
+}
+
 /// Tokenizes a token::COMMENT.
 inline void tokenize_comment(tokenization_state& s) {
-    while (s.next != s.end && *s.next != '\n' && *s.next != '\r') { ++s.next; }
+    s.next += scan().until_line_break(source_view(s.next, s.end));
+    report_invalid_utf8(s, s.current_token_characters());
     s.push<token::COMMENT>(s.current_token_characters());
 }
 
-} // namespace fp::lex::detail
\ No newline at end of file
+} // namespace fp::lex::detail
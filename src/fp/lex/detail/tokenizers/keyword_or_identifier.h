@@ -1,23 +1,39 @@
 #pragma once
 
+#include <fp/lex/keywords.h>
 #include <fp/lex/token.h>
-#include <fp/lex/detail/characters_range.h>
+#include <fp/lex/detail/scan.h>
 #include <fp/lex/detail/tokenization_state.h>
+#include <fp/lex/detail/utf8.h>
 
 namespace fp::lex::detail {
 
+/**
+ * Consumes the rest of the characters of an identifier: ASCII identifier
+ * characters, and non-ASCII code points that have the XID_Continue property.
+ */
+inline void consume_identifier_characters(tokenization_state& s) {
+    while (true) {
+        s.next += scan().identifier(source_view(s.next, s.end));
+        if (s.next == s.end || !(*s.next & 0x80)) { return; }
+        utf8_code_point c = decode_utf8(source_view(s.next, s.end));
+        if (!c.valid || !is_xid_continue(c.value)) { return; }
+        s.next += c.size;
+    }
+}
+
 /// Tokenizes either a language keyword or an identifier.
 inline void tokenize_keyword_or_identifier(tokenization_state& s) {
     // consume all keyword/identifier characters
-    do {
-        ++s.next;
-    } while(s.next != s.end && identifier_characters::contain(*s.next));
+    ++s.next;
+    consume_identifier_characters(s);
 
-    auto it = keywords_map.find(s.current_token_characters());
-    if (it != keywords_map.end()) {
-        s.push(it->second);
+    if (auto keyword = find_keyword(s.current_token_characters())) {
+        s.push(*keyword);
     } else {
-        s.push<token::IDENTIFIER>(s.current_token_characters());
+        s.push<token::IDENTIFIER>(
+            s.symbols.intern(s.current_token_characters())
+        );
     }
 }
 
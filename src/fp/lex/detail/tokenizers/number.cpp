@@ -1,3 +1,14 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fp/util/table.h>
 #include <fp/lex/detail/characters_range.h>
 
 #include "number.h"
@@ -6,11 +17,6 @@ namespace fp::lex::detail {
 
 using binary_digits = characters_range<'0', '1'>;
 using octal_digits  = characters_range<'0', '7'>;
-using hex_digits = composite_characters_range<
-    decimal_digits,
-    characters_range<'A', 'F'>,
-    characters_range<'a', 'f'>
->;
 
 using decimal_exponent = composite_characters_range<
     specific_character<'e'>,
@@ -73,211 +79,520 @@ consume_number_characters(tokenization_state& s) {
 }
 
 /**
- * Any error countered when tokenizing a number will cause a number_error to be
- * thrown. It will then be caught in detail::tokenize_number.
+ * Consumes the type suffix of a number literal (e.g. `i8` in ``42`i8``), and
+ * returns it (without the backtick), or an empty view if there's none.
  *
- * Yes, this is exception-based control flow. Yes, this is not ideal. Tokenizing
- * a number is complicated business when you want nice error-reporting, so I
- * settled for throwing an exception.
+ * A backtick that isn't followed by a letter is not a part of the literal.
  */
-struct number_error : std::exception {
-    source_view source_section;
-    std::string text;
-    number_error(source_view source_section, std::string text) :
-        source_section(source_section), text(std::move(text)) {}
+static source_view consume_type_suffix(tokenization_state& s) {
+    bool has_suffix =
+        s.next_is('`') && s.next + 1 != s.end && letters::contain(s.next[1]);
+    if (!has_suffix) { return {}; }
+    source_iterator suffix_begin = ++s.next;
+    while (s.next != s.end && identifier_characters::contain(*s.next)) {
+        ++s.next;
+    }
+    return source_view(suffix_begin, s.next);
+}
+
+/// A type suffix of number literals, and the type it indicates.
+struct type_suffix {
+    std::string_view name;
+    number_kind kind;
 };
 
-static void validate_decimal_point(source_view number, source_view exponent) {
-    size_t exp_decimal_point_pos = exponent.find('.');
-    if (exp_decimal_point_pos != exponent.npos) {
-        throw number_error(
-            exponent.substr(exp_decimal_point_pos, 1),
-            "decimal-point in exponent"
-        );
-    }
+/// All type suffixes (the first suffix of each type is its name).
+constexpr type_suffix type_suffixes[] = {
+    {"i8",  number_kind::I8 },
+    {"i16", number_kind::I16},
+    {"i32", number_kind::I32},
+    {"i64", number_kind::I64},
+    {"u8",  number_kind::U8 },
+    {"u16", number_kind::U16},
+    {"u32", number_kind::U32},
+    {"u64", number_kind::U64},
+    {"u",   number_kind::U64},
+    {"f32", number_kind::F32},
+    {"f64", number_kind::F64},
+    {"f",   number_kind::F64},
+};
 
-    // ensure that there's no more than one decimal-point
-    size_t first_pos = number.find('.');
-    if (first_pos == number.npos) { return; }
-    size_t second_pos = number.find('.', first_pos + 1);
-    if (second_pos != number.npos) {
-        throw number_error(
-            number.substr(second_pos, 1),
-            "more than one decimal point in number"
-        );
+/// Returns the type indicated by a type `suffix`, if it's a valid one.
+static std::optional<number_kind> suffix_kind(source_view suffix) {
+    for (const type_suffix& t : type_suffixes) {
+        if (t.name == suffix) { return t.kind; }
     }
+    return std::nullopt;
 }
 
-static void validate_no_digit_separator_next_to_exponent(
-    source_view number,
-    source_view exponent
-) {
-    if (exponent.empty()) { return; }
-    source_iterator separator_adjacent_to_exp = number.end();
-    if (number.back() == '\'') {
-        separator_adjacent_to_exp = number.end() - 1;
-    } else if (exponent[1] == '\'') {
-        separator_adjacent_to_exp = exponent.begin() + 1;
-    } else if (
-        (exponent[1] == '+' || exponent[1] == '-') && exponent[2] == '\''
-    ) {
-        separator_adjacent_to_exp = exponent.begin() + 2;
+/// Returns the name of the type of a suffixed number literal (e.g. `u64`).
+static std::string_view kind_name(number_kind kind) {
+    for (const type_suffix& t : type_suffixes) {
+        if (t.kind == kind) { return t.name; }
     }
-    if (separator_adjacent_to_exp != number.end()) {
-        throw number_error(
-            source_view(separator_adjacent_to_exp, 1),
-            "digit-separator adjacent to exponent"
-        );
+    return {};
+}
+
+static bool is_float_kind(number_kind kind) {
+    return kind == number_kind::F32 || kind == number_kind::F64;
+}
+
+/// The largest value of each integer type.
+constexpr auto max_integer_values = util::table<
+    number_kind,
+    uint64_t,
+    size_t(number_kind::F64) + 1
+>([](auto& t) {
+    t.set_default(UINT64_MAX);
+    t[number_kind::I8 ] = INT8_MAX;
+    t[number_kind::I16] = INT16_MAX;
+    t[number_kind::I32] = INT32_MAX;
+    t[number_kind::I64] = INT64_MAX;
+    t[number_kind::U8 ] = UINT8_MAX;
+    t[number_kind::U16] = UINT16_MAX;
+    t[number_kind::U32] = UINT32_MAX;
+});
+
+/**
+ * Returns `true` if an evaluated number literal is in the range of its type.
+ *
+ * Literals without a type suffix are always in range (if their value is too
+ * large, it is kept as an fp::big_number). Note that literals are never
+ * negative, so the range of `i8` literals is `[0, 127]`.
+ */
+static bool in_range(const number_t& value) {
+    switch (value.kind) {
+        case number_kind::INTEGER:
+        case number_kind::FLOAT:
+            return true;
+        case number_kind::F32:
+            return !std::isinf(float(value.floating));
+        case number_kind::F64:
+            return !std::isinf(value.floating);
+        default:
+            return
+                value.big == nullptr &&
+                value.integer <= max_integer_values[value.kind];
     }
 }
 
-static void validate_no_consecutive_digit_separators(source_view whole_number) {
-    for (auto it = whole_number.begin() + 1; it != whole_number.end(); ++it) {
-        if (*it == '\'' && *(it - 1) == '\'') {
-            throw number_error(
-                source_view(it - 1, 2),
-                "adjacent digit-separators in number"
+/// The classes of the characters that may appear in a number literal.
+enum number_char_class : uint8_t {
+    base_digit    = 1 << 0, // a digit in the base of the number
+    decimal_digit = 1 << 1,
+    separator     = 1 << 2, // '
+    decimal_point = 1 << 3, // .
+    underscore    = 1 << 4,
+    sign          = 1 << 5  // + or -
+};
+
+/// Maps each character to its number_char_class flags, in the base of `Digits`.
+template <class Digits>
+constexpr auto number_char_classes =
+    util::table<char, uint8_t, 256, char_to_index>([](auto& t) {
+        t.set_default(0);
+        for (int i = 0; i < 256; ++i) {
+            char c = char(i);
+            if (Digits::contain(c))         { t[c] |= base_digit;    }
+            if (decimal_digits::contain(c)) { t[c] |= decimal_digit; }
+        }
+        t['\''] |= separator;
+        t['.']  |= decimal_point;
+        t['_']  |= underscore;
+        t['+']  |= sign;
+        t['-']  |= sign;
+    });
+
+/**
+ * The problems of an invalid number literal, ordered by their priority: when a
+ * literal has multiple problems, only the first one is reported.
+ */
+enum class number_problem : uint8_t {
+    no_digits,
+    decimal_point_in_exponent,
+    multiple_decimal_points,
+    separator_adjacent_to_exponent,
+    adjacent_separators,
+    separator_adjacent_to_decimal_point,
+    separator_at_end,
+    non_decimal_exponent_digit,
+    exponent_has_no_digits,
+    underscore,
+    non_base_digit,
+    none
+};
+
+/// The texts of the problems (number_problem::non_base_digit depends on base).
+constexpr std::string_view number_problem_texts[] = {
+    "number has no digits",
+    "decimal-point in exponent",
+    "more than one decimal point in number",
+    "digit-separator adjacent to exponent",
+    "adjacent digit-separators in number",
+    "digit-separator adjacent to decimal-point",
+    "digit-separator at the end of a number",
+    "non-decimal digit in exponent",
+    "exponent has no digits",
+    "underscore in number",
+};
+
+/// Describes the (highest priority) problem of a number literal, if any.
+struct number_error {
+    number_problem problem = number_problem::none;
+    source_view source_section;
+
+    /// Keeps the given problem if it has a higher priority than the current.
+    void found(number_problem other, source_view other_section) {
+        if (other < problem) {
+            problem = other;
+            source_section = other_section;
+        }
+    }
+
+    explicit operator bool() const { return problem != number_problem::none; }
+
+    std::string text(std::string_view base_name) const {
+        if (problem == number_problem::non_base_digit) {
+            return
+                "non-" + std::string(base_name) + " digit in " +
+                std::string(base_name) + " number";
+        }
+        return std::string(number_problem_texts[size_t(problem)]);
+    }
+};
+
+/**
+ * Validates the (non-empty) `number` and its `exponent` (as returned by
+ * detail::consume_number_characters) in a single pass over their characters.
+ */
+template <class Digits>
+static number_error validate_number(source_view number, source_view exponent) {
+    constexpr auto& classes = number_char_classes<Digits>;
+    number_error error;
+    auto at = [](source_iterator it, size_t size = 1) {
+        return source_view(it, size);
+    };
+    auto is_separator = [](source_iterator it) { return *it == '\''; };
+
+    bool has_decimal_point = false;
+    for (auto it = number.begin(); it != number.end(); ++it) {
+        uint8_t c = classes[*it];
+        if (c & decimal_point) {
+            if (has_decimal_point) {
+                error.found(number_problem::multiple_decimal_points, at(it));
+            }
+            has_decimal_point = true;
+        } else if (c & separator) {
+            if (it != number.begin()) {
+                if (is_separator(it - 1)) {
+                    error.found(
+                        number_problem::adjacent_separators,
+                        at(it - 1, 2)
+                    );
+                }
+                if (
+                    it + 1 != number.end() &&
+                    (*(it - 1) == '.' || *(it + 1) == '.')
+                ) {
+                    error.found(
+                        number_problem::separator_adjacent_to_decimal_point,
+                        at(it)
+                    );
+                }
+            }
+        } else if (!(c & base_digit)) {
+            error.found(
+                c & underscore
+                    ? number_problem::underscore
+                    : number_problem::non_base_digit,
+                at(it)
             );
         }
     }
-}
 
-static void validate_no_digit_separator_next_to_decimal_point(
-    source_view number
-) {
-    if (number.size() == 1) { return; }
-    for (auto it = number.begin() + 1; it != number.end() - 1; ++it) {
-        if (*it != '\'') { continue; }
-        if (*(it - 1) == '.' || *(it + 1) == '.') {
-            throw number_error(
-                source_view(it, 1),
-                "digit-separator adjacent to decimal-point"
+    if (!exponent.empty()) {
+        // skip the exponent character, and a sign right after it
+        auto digits_begin = exponent.begin() + 1;
+        if (
+            digits_begin != exponent.end() &&
+            (classes[*digits_begin] & sign)
+        ) {
+            ++digits_begin;
+        }
+        bool has_digits = false;
+        for (auto it = exponent.begin() + 1; it != exponent.end(); ++it) {
+            uint8_t c = classes[*it];
+            if (c & separator) {
+                if (is_separator(it - 1)) {
+                    error.found(
+                        number_problem::adjacent_separators,
+                        at(it - 1, 2)
+                    );
+                }
+                continue;
+            }
+            if (c & decimal_point) {
+                error.found(number_problem::decimal_point_in_exponent, at(it));
+            } else if (c & underscore) {
+                error.found(number_problem::underscore, at(it));
+            }
+            if (c & decimal_digit) {
+                has_digits = true;
+            } else if (it >= digits_begin) {
+                error.found(number_problem::non_decimal_exponent_digit, at(it));
+            }
+        }
+        if (!has_digits) {
+            error.found(number_problem::exponent_has_no_digits, exponent);
+        }
+
+        if (is_separator(number.end() - 1)) {
+            error.found(
+                number_problem::separator_adjacent_to_exponent,
+                at(number.end() - 1)
+            );
+        } else if (exponent.size() > 1 && is_separator(exponent.begin() + 1)) {
+            error.found(
+                number_problem::separator_adjacent_to_exponent,
+                at(exponent.begin() + 1)
+            );
+        } else if (
+            exponent.size() > 2 &&
+            (classes[exponent[1]] & sign) &&
+            is_separator(exponent.begin() + 2)
+        ) {
+            error.found(
+                number_problem::separator_adjacent_to_exponent,
+                at(exponent.begin() + 2)
             );
         }
     }
-}
 
-static void validate_digit_separators(
-    source_view number,
-    source_view exponent
-) {
-    validate_no_digit_separator_next_to_exponent(number, exponent);
     source_view whole_number = merge(number, exponent);
-    validate_no_consecutive_digit_separators(whole_number);
-    validate_no_digit_separator_next_to_decimal_point(number);
-    if (whole_number.back() == '\'') {
-        throw number_error(
-            source_view(whole_number.end() - 1, 1),
-            "digit-separator at the end of a number"
+    if (is_separator(whole_number.end() - 1)) {
+        error.found(
+            number_problem::separator_at_end,
+            at(whole_number.end() - 1)
         );
     }
+    return error;
 }
 
-static void validate_exponent_digits(source_view exponent) {
-    if (exponent.empty()) { return; }
+/**
+ * Returns the arbitrary-precision value of the given (validated) digits in the
+ * given `base`, ignoring digit-separators and decimal-points.
+ */
+static std::vector<uint32_t> big_mantissa(source_view digits, uint32_t base) {
+    std::vector<uint32_t> limbs;
+    for (char c : digits) {
+        if (c == '\'' || c == '.') { continue; }
+        // limbs = limbs * base + digit
+        uint64_t carry = digit_value(c);
+        for (uint32_t& limb : limbs) {
+            uint64_t x = uint64_t(limb) * base + carry;
+            limb = uint32_t(x);
+            carry = x >> 32;
+        }
+        if (carry != 0) { limbs.push_back(uint32_t(carry)); }
+    }
+    return limbs;
+}
 
-    // skip exponent character
-    source_view digits = exponent.substr(1);
-    if (digits.empty()) {
-        throw number_error(exponent, "exponent has no digits");
+/**
+ * Returns the value of an integer literal with the given (validated) digits in
+ * the given `base`.
+ *
+ * The value is accumulated in 64 bits, and only if that overflows it's
+ * evaluated again as an fp::big_number.
+ */
+static number_t evaluate_integer(source_view digits, uint32_t base) {
+    number_t value;
+    bool overflow = false;
+    for (char c : digits) {
+        if (c == '\'') { continue; }
+        overflow |= __builtin_mul_overflow(value.integer, base, &value.integer);
+        overflow |= __builtin_add_overflow(
+            value.integer,
+            digit_value(c),
+            &value.integer
+        );
+    }
+    if (overflow) {
+        value.big = std::make_shared<big_number>(big_number{
+            .mantissa = big_mantissa(digits, base)
+        });
     }
+    return value;
+}
 
-    // skip exponent sign
-    if (digits[0] == '+' || digits[0] == '-') { digits.remove_prefix(1); }
-
-    bool has_digits = false;
-    for (auto it = digits.begin(); it != digits.end(); ++it) {
-        if (*it == '\'') { continue; } // skip digit-separators
-        if (decimal_digits::contain(*it)) {
-            has_digits = true;
-        } else {
-            throw number_error(
-                source_view(it, 1),
-                "non-decimal digit in exponent"
-            );
-        }
+/**
+ * Returns the value of an exponent (e.g. `e-12`) of a validated floating-point
+ * literal. Exponents too large to matter are clamped.
+ */
+static int64_t exponent_value(source_view exponent) {
+    if (exponent.empty()) { return 0; }
+    constexpr int64_t max_exponent = int64_t(1) << 48;
+    int64_t value = 0;
+    for (char c : exponent.substr(1)) {
+        if (c < '0' || c > '9') { continue; } // sign or digit-separator
+        value = std::min(value * 10 + (c - '0'), max_exponent);
     }
-    if (!has_digits) { throw number_error(exponent, "exponent has no digits"); }
+    return exponent[1] == '-' ? -value : value;
 }
 
-static void validate_no_underscores(
+/**
+ * Returns the value of a floating-point literal with the given (validated)
+ * `number` and `exponent` parts, that is either decimal, or hexadecimal (with a
+ * binary exponent, like `0x1.8p3`).
+ *
+ * The value is rounded to the nearest double (with std::from_chars). Only when
+ * it is out of the range of double, it's also evaluated as an exact
+ * fp::big_number.
+ */
+static number_t evaluate_float(
+    tokenization_state& s,
     source_view number,
-    source_view exponent
+    source_view exponent,
+    bool hexadecimal
 ) {
-    source_view whole_number = merge(number, exponent);
-    size_t underscore_pos = whole_number.find('_');
-    if (underscore_pos != whole_number.npos) {
-        throw number_error(
-            source_view(whole_number.begin() + underscore_pos, 1),
-            "underscore in number"
-        );
+    // the characters of the literal without digit-separators, which can be
+    // parsed by std::from_chars (the buffer is reused, to avoid allocations)
+    std::string& chars = s.string_buffer;
+    chars.clear();
+    for (char c : merge(number, exponent)) {
+        if (c != '\'') { chars += c; }
     }
-}
 
-template <class Digits>
-void validate_digits(source_view number, std::string_view base_name) {
-    for (auto it = number.begin(); it != number.end(); ++it) {
-        if (*it == '\'' || *it == '.') { continue; }
-        if (!Digits::contain(*it)) {
-            throw number_error(
-                source_view(it, 1),
-                "non-" + std::string(base_name) + " digit in " +
-                std::string(base_name) + " number"
-            );
-        }
+    number_t value;
+    value.is_float = true;
+    auto format = hexadecimal
+        ? std::chars_format::hex
+        : std::chars_format::general;
+    auto result = std::from_chars(
+        chars.data(), chars.data() + chars.size(), value.floating, format
+    );
+    if (result.ec != std::errc::result_out_of_range) { return value; }
+
+    auto big = std::make_shared<big_number>(big_number{
+        .mantissa = big_mantissa(number, hexadecimal ? 16 : 10),
+        .exponent = exponent_value(exponent),
+        .radix = hexadecimal ? 2u : 10u
+    });
+    // each fraction digit scales the mantissa by the base
+    size_t point = number.find('.');
+    if (point != number.npos) {
+        source_view fraction = number.substr(point + 1);
+        auto separators = std::count(fraction.begin(), fraction.end(), '\'');
+        int64_t fraction_digits = int64_t(fraction.size()) - separators;
+        big->exponent -= fraction_digits * (hexadecimal ? 4 : 1);
     }
+    value.big = std::move(big);
+
+    // the value either overflows (to infinity), or underflows to a denormal or
+    // zero, in which case std::strtod rounds it properly
+    if (hexadecimal) { chars.insert(0, "0x"); }
+    value.floating = std::strtod(chars.c_str(), nullptr);
+    return value;
 }
 
 template <class Digits, class ExponentChars, bool SUPPORT_FLOAT>
-void tokenize_number(tokenization_state& s, std::string_view base_name) {
+void tokenize_number(
+    tokenization_state& s,
+    uint32_t base,
+    std::string_view base_name
+) {
     auto [number, exponent] = consume_number_characters<ExponentChars>(s);
-    try {
-        validate_decimal_point(number, exponent);
-        validate_digit_separators(number, exponent);
-        validate_exponent_digits(exponent);
-        validate_no_underscores(number, exponent);
-        validate_digits<Digits>(number, base_name);
-    } catch (number_error& e) {
+    source_view suffix = consume_type_suffix(s);
+    number_error error;
+    if (number.empty()) {
+        error.found(number_problem::no_digits, s.current_token_characters());
+    } else {
+        error = validate_number<Digits>(number, exponent);
+    }
+    if (error) {
         s.report_error(&error::E0007_invalid_number_literal)
-            .add_primary(s.location(e.source_section), std::move(e.text))
+            .add_primary(
+                s.location(error.source_section),
+                error.text(base_name)
+            )
             .add_supplement(s.current_token_location());
-        s.push_dummy(token::NUMBER, source_view("0"));
+        s.push_dummy(token::NUMBER, number_t());
         return;
     }
 
+    std::optional<number_kind> kind;
+    if (!suffix.empty()) {
+        kind = suffix_kind(suffix);
+        if (!kind) {
+            s.report_error(&error::E0010_invalid_number_suffix)
+                .add_primary(s.location(suffix), "unknown type suffix")
+                .add_supplement(s.current_token_location());
+            s.push_dummy(token::NUMBER, number_t());
+            return;
+        }
+    }
+
+    bool has_float_syntax =
+        !exponent.empty() || number.find('.') != number.npos;
+    bool is_float = has_float_syntax || (kind && is_float_kind(*kind));
     if (!SUPPORT_FLOAT) {
-        bool is_float = !exponent.empty() || number.find('.') != number.npos;
         if (is_float) {
             s.report_error(&error::E0008_unsupported_float_base)
                 .add_primary(s.current_token_location(),\
                 "floating-point literal in " + std::string(base_name) + " base "
                 "is not supported"
             );
-            s.push_dummy(token::NUMBER, source_view("0"));
+            s.push_dummy(token::NUMBER, number_t());
             return;
         }
     }
+    if (has_float_syntax && kind && !is_float_kind(*kind)) {
+        s.report_error(&error::E0010_invalid_number_suffix)
+            .add_primary(
+                s.location(suffix),
+                "integer type suffix on floating-point literal"
+            )
+            .add_supplement(s.current_token_location());
+        s.push_dummy(token::NUMBER, number_t());
+        return;
+    }
 
-    s.push<token::NUMBER>(s.current_token_characters());
+    number_t value = is_float
+        ? evaluate_float(s, number, exponent, base == 16)
+        : evaluate_integer(number, base);
+    value.kind = kind.value_or(
+        is_float ? number_kind::FLOAT : number_kind::INTEGER
+    );
+    if (!in_range(value)) {
+        s.report_error(&error::E0011_number_out_of_range)
+            .add_primary(
+                s.current_token_location(),
+                "value is out of the range of " +
+                std::string(kind_name(value.kind))
+            );
+        s.push_dummy(token::NUMBER, number_t());
+        return;
+    }
+    s.push<token::NUMBER>(std::move(value));
 }
 
 void tokenize_number_with_zero_prefix(tokenization_state& s) {
     if (s.next_is("0x")) {
         s.next += 2;
-        tokenize_number<hex_digits, hex_exponent, true>(s, "hexadecimal");
+        tokenize_number<hex_digits, hex_exponent, true>(s, 16, "hexadecimal");
     } else if (s.next_is("0o")) {
         s.next += 2;
-        tokenize_number<octal_digits, octal_exponent, false>(s, "octal");
+        tokenize_number<octal_digits, octal_exponent, false>(s, 8, "octal");
     } else if (s.next_is("0b")) {
         s.next += 2;
-        tokenize_number<binary_digits, binary_exponent, false>(s, "binary");
+        tokenize_number<binary_digits, binary_exponent, false>(s, 2, "binary");
     } else {
-        tokenize_number<decimal_digits, decimal_exponent, true>(s, "decimal");
+        tokenize_number_with_no_zero_prefix(s);
     }
 }
 
 void tokenize_number_with_no_zero_prefix(tokenization_state& s) {
-    tokenize_number<decimal_digits, decimal_exponent, true>(s, "decimal");
+    tokenize_number<decimal_digits, decimal_exponent, true>(s, 10, "decimal");
 }
 
 } // namespace fp::lex::detail
@@ -1,24 +1,113 @@
 #pragma once
 
-#include <fp/util/to_string.h>
+#include <cctype>
+#include <charconv>
+#include <string>
+
 #include <fp/error_codes.h>
 #include <fp/lex/detail/tokenization_state.h>
+#include <fp/lex/detail/utf8.h>
 
 namespace fp::lex::detail {
 
-/// Push a token::ERROR and report a diagnostic::error.
-inline void stray_character(tokenization_state& s) {
-    char c = *s.next;
-    s.consume_and_push(token::ERROR);
+/**
+ * Returns `true` if the ASCII character `c` can't begin any token (and isn't
+ * whitespace either). Such characters are handled by detail::stray_character
+ * in the detail::tokenizers_table.
+ */
+constexpr bool is_stray_ascii_character(char c) {
+    bool is_control = c >= 0 && c < ' ';
+    bool is_whitespace = c >= '\t' && c <= '\r';
+    return
+        (is_control && !is_whitespace) ||
+        c == '$' || c == '\\' || c == '`' || c == 127;
+}
 
-    std::ostringstream error_text;
-    error_text << "stray character";
-    if (c < ' ' || c == 127) { // unprintable
-        error_text << ": \\" << std::oct << int16_t(c);
+/**
+ * Returns the stray character at the beginning of the (non-empty) `chars`:
+ * either an ASCII character that can't begin a token, a non-ASCII code point
+ * that can't begin an identifier, or an invalid UTF-8 sequence (which is not
+ * `valid`).
+ *
+ * If `chars` doesn't begin with a stray character, the returned code point's
+ * size is 0.
+ */
+inline utf8_code_point next_stray_character(source_view chars) {
+    char c = chars.front();
+    if (c >= 0) {
+        return {char_t(c), is_stray_ascii_character(c) ? 1u : 0u, true};
+    }
+    utf8_code_point code_point = decode_utf8(chars);
+    if (code_point.valid && is_xid_start(code_point.value)) {
+        code_point.size = 0;
     }
+    return code_point;
+}
 
-    s.report_error(&error::E0001_stray_character)
-        .add_primary(s.current_token_location(), error_text.str());
+/// Returns the text of the error reported for a single stray character.
+inline std::string stray_character_text(utf8_code_point c) {
+    if (!c.valid) { return "invalid UTF-8 sequence"; }
+    auto digits = [&](int base) {
+        char buffer[8];
+        char* end = std::to_chars(buffer, buffer + 8, c.value, base).ptr;
+        return std::string(buffer, end);
+    };
+    if (c.value >= 0x80) {
+        std::string hex = digits(16);
+        for (char& digit : hex) { digit = char(std::toupper(digit)); }
+        return "stray character: U+" +
+            std::string(hex.size() < 4 ? 4 - hex.size() : 0, '0') + hex;
+    }
+    if (c.value < ' ' || c.value == 127) { // unprintable
+        return "stray character: \\" + digits(8);
+    }
+    return "stray character";
+}
+
+/**
+ * Pushes a single token::ERROR for the run of consecutive stray characters
+ * (see detail::next_stray_character) that begins with `first` (which was not
+ * consumed yet), and reports a single diagnostic::error for all of them.
+ *
+ * Garbage input (e.g. a binary file) is mostly made of such runs, so that the
+ * number of tokens and errors is proportional to the number of runs rather
+ * than to the number of bytes.
+ */
+inline void stray_characters(tokenization_state& s, utf8_code_point first) {
+    s.next += first.size;
+    size_t count = 1;
+    size_t invalid_count = first.valid ? 0 : 1;
+    while (s.next != s.end) {
+        utf8_code_point c = next_stray_character(source_view(s.next, s.end));
+        if (c.size == 0) { break; }
+        s.next += c.size;
+        ++count;
+        if (!c.valid) { ++invalid_count; }
+    }
+    s.push(token::ERROR);
+
+    const error::code* error_code =
+        invalid_count == count ?
+        &error::E0012_invalid_utf8 :
+        &error::E0001_stray_character;
+    std::string text;
+    if (count == 1) {
+        text = stray_character_text(first);
+    } else if (invalid_count == count) {
+        text = std::to_string(count) + " invalid UTF-8 sequences";
+    } else if (invalid_count == 0) {
+        text = std::to_string(count) + " stray characters";
+    } else {
+        text = std::to_string(count) +
+            " stray characters and invalid UTF-8 sequences";
+    }
+    s.report_error(error_code)
+        .add_primary(s.current_token_location(), std::move(text));
+}
+
+/// Tokenizes a run of stray characters that begins with an ASCII character.
+inline void stray_character(tokenization_state& s) {
+    stray_characters(s, {char_t(*s.next), 1, true});
 }
 
 } // namespace fp::lex::detail
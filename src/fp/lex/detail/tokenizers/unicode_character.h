@@ -1,17 +1,29 @@
 #pragma once
 
 #include <fp/lex/detail/tokenization_state.h>
+#include <fp/lex/detail/utf8.h>
+#include <fp/lex/detail/tokenizers/keyword_or_identifier.h>
+#include <fp/lex/detail/tokenizers/stray_character.h>
 
 namespace fp::lex::detail {
 
-/// Push a token::ERROR and report a diagnostic::error.
+/**
+ * Tokenizes a non-ASCII code point: either the beginning of an identifier (a
+ * code point with the XID_Start property), or the beginning of a run of stray
+ * characters (see detail::stray_characters), which may include invalid UTF-8
+ * sequences.
+ */
 inline void unicode_character(tokenization_state& s) {
-    s.consume_and_push(token::ERROR);
-    s.report_error("unicode character not supported")
-        .add_primary(
-            s.current_token_location(),
-            "unicode character (not supported)"
+    utf8_code_point c = decode_utf8(source_view(s.next, s.end));
+    if (c.valid && is_xid_start(c.value)) {
+        s.next += c.size;
+        consume_identifier_characters(s);
+        s.push<token::IDENTIFIER>(
+            s.symbols.intern(s.current_token_characters())
         );
+        return;
+    }
+    stray_characters(s, c);
 }
 
 } // namespace fp::lex::detail
@@ -1,23 +1,18 @@
 #pragma once
 
+#include <fp/lex/detail/scan.h>
 #include <fp/lex/detail/tokenization_state.h>
 
 namespace fp::lex::detail {
 
-/// Skips the next character without doing anything.
-inline void ignore(tokenization_state& s) { ++s.next; }
-
-/// Skips over the next character and begin a new line.
-inline void line_feed(tokenization_state& s) {
-    ++s.next;
-    s.begin_new_line();
-}
-
-/// Just like tokenizer::line_feed, but also skips a CRLF combination ("\r\n").
-inline void carriage_return(tokenization_state& s) {
-    ++s.next; // skip '\r'
-    if (s.next_is('\n')) { ++s.next; }
-    s.begin_new_line();
+/**
+ * Skips the next run of whitespace characters without doing anything.
+ *
+ * This includes line-breaks, since line information is not tracked during
+ * tokenization (see fp::source_file::line_offsets).
+ */
+inline void skip_whitespace(tokenization_state& s) {
+    s.next += scan().whitespace(source_view(s.next, s.end));
 }
 
 } // namespace fp::lex::detail
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fp/util/table.h>
+#include <fp/lex/detail/characters_range.h>
 #include <fp/lex/detail/tokenization_state.h>
 #include <fp/lex/detail/tokenizers/character_and_string.h>
 #include <fp/lex/detail/tokenizers/colon.h>
@@ -24,16 +25,6 @@ namespace fp::lex::detail {
  */
 using tokenizer_t = void (*)(tokenization_state&);
 
-/**
- * Maps an ASCII character (-128...127) to an index (0...255) in the tokenizers
- * dispatch table: detail::tokenizers_table.
- */
-struct char_to_index {
-    constexpr size_t operator()(char c) const {
-        return size_t((unsigned char)c);
-    }
-};
-
 ///// Tokenizes the symbol as `TOKEN`.
 template <token TOKEN>
 void consume_and_push(tokenization_state& s) { s.consume_and_push(TOKEN); }
@@ -57,18 +48,19 @@ constexpr auto tokenizers_table = tokenizers_table_t([](auto& t) {
     // will be treated as a stray character in the source code.
     t.set_default(stray_character);
 
-    // unicode characters are currently unsupported
+    // non-ASCII characters begin UTF-8 sequences (XID identifiers, or runs of
+    // stray characters and invalid UTF-8)
     for (char unicode_char = -128; unicode_char != 0; ++unicode_char) {
         t[unicode_char] = unicode_character;
     }
 
     // whitespace
-    t['\t'] = ignore;          // (0x09) horizontal tab
-    t['\n'] = line_feed;       // (0x0a) line feed
-    t['\v'] = ignore;          // (0x0b) vertical tab
-    t['\f'] = ignore;          // (0x0c) form feed
-    t['\r'] = carriage_return; // (0x0d) horizontal tab
-    t[' ' ] = ignore;          // (0x20) space
+    t['\t'] = skip_whitespace; // (0x09) horizontal tab
+    t['\n'] = skip_whitespace; // (0x0a) line feed
+    t['\v'] = skip_whitespace; // (0x0b) vertical tab
+    t['\f'] = skip_whitespace; // (0x0c) form feed
+    t['\r'] = skip_whitespace; // (0x0d) carriage return
+    t[' ' ] = skip_whitespace; // (0x20) space
 
     // string
     t['\''] = tokenize_character;
@@ -176,4 +168,16 @@ constexpr auto tokenizers_table = tokenizers_table_t([](auto& t) {
     return t;
 });
 
+static_assert(
+    [] {
+        for (int c = 0; c < 128; ++c) {
+            bool is_stray = tokenizers_table[char(c)] == stray_character;
+            if (is_stray != is_stray_ascii_character(char(c))) { return false; }
+        }
+        return true;
+    }(),
+    "runs of stray characters must consist of the stray characters of the "
+    "tokenizers table"
+);
+
 } // namespace fp::lex::detail
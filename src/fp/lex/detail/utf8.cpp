@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cstdint>
+#include <span>
+
+#include "utf8.h"
+
+namespace fp::lex::detail {
+
+/// A range `[first, last]` of code points.
+struct code_point_range {
+    char_t first;
+    char_t last;
+};
+
+#include <fp/lex/detail/xid_tables.inl>
+
+utf8_code_point decode_utf8(source_view chars) {
+    auto byte = [&](size_t i) { return uint8_t(chars[i]); };
+    uint8_t lead = byte(0);
+    if (lead < 0x80) { return {lead, 1, true}; }
+
+    // the number of continuation bytes, and the range of the first one (which
+    // rules out overlong encodings, surrogates and code points above U+10FFFF)
+    size_t continuations;
+    uint8_t min = 0x80, max = 0xBF;
+    char_t value;
+    if (0xC2 <= lead && lead <= 0xDF) {
+        continuations = 1;
+        value = lead & 0x1F;
+    } else if (0xE0 <= lead && lead <= 0xEF) {
+        continuations = 2;
+        value = lead & 0x0F;
+        if (lead == 0xE0) { min = 0xA0; }
+        if (lead == 0xED) { max = 0x9F; }
+    } else if (0xF0 <= lead && lead <= 0xF4) {
+        continuations = 3;
+        value = lead & 0x07;
+        if (lead == 0xF0) { min = 0x90; }
+        if (lead == 0xF4) { max = 0x8F; }
+    } else {
+        return {0, 1, false};
+    }
+
+    for (size_t i = 1; i <= continuations; ++i) {
+        if (i == chars.size() || byte(i) < min || byte(i) > max) {
+            return {0, i, false};
+        }
+        value = (value << 6) | (byte(i) & 0x3F);
+        min = 0x80;
+        max = 0xBF;
+    }
+    return {value, continuations + 1, true};
+}
+
+/// Returns `true` if `c` is in one of the (sorted) `ranges`.
+static bool in_ranges(char_t c, std::span<const code_point_range> ranges) {
+    auto it = std::upper_bound(
+        ranges.begin(), ranges.end(), c,
+        [](char_t c, const code_point_range& r) { return c < r.first; }
+    );
+    return it != ranges.begin() && c <= (it - 1)->last;
+}
+
+bool is_xid_start(char_t c) { return in_ranges(c, xid_start_ranges); }
+
+bool is_xid_continue(char_t c) { return in_ranges(c, xid_continue_ranges); }
+
+} // namespace fp::lex::detail
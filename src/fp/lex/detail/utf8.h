@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <fp/literal_types.h>
+#include <fp/source_code.h>
+
+namespace fp::lex::detail {
+
+/// The maximal number of bytes of a UTF-8 encoded code point.
+constexpr size_t max_utf8_size = 4;
+
+/// The result of detail::decode_utf8.
+struct utf8_code_point {
+    /// The decoded code point (only if `valid`).
+    char_t value;
+
+    /**
+     * The number of bytes of the code point, or of the invalid sequence (its
+     * maximal prefix that can begin a valid code point, or a single byte).
+     */
+    size_t size;
+
+    bool valid;
+};
+
+/**
+ * Decodes the UTF-8 encoded code point at the beginning of the (non-empty)
+ * `chars`.
+ *
+ * Overlong encodings, surrogates and code points above U+10FFFF are invalid.
+ * Invalid sequences are reported as the "maximal subparts" recommended by the
+ * Unicode standard, so decoding can continue right after them.
+ */
+utf8_code_point decode_utf8(source_view chars);
+
+/// Appends the UTF-8 encoding of the (valid) code point `c` to `out`.
+inline void encode_utf8(char_t c, std::string& out) {
+    if (c < 0x80) {
+        out += char(c);
+    } else if (c < 0x800) {
+        out += char(0xC0 | (c >> 6));
+        out += char(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        out += char(0xE0 | (c >> 12));
+        out += char(0x80 | ((c >> 6) & 0x3F));
+        out += char(0x80 | (c & 0x3F));
+    } else {
+        out += char(0xF0 | (c >> 18));
+        out += char(0x80 | ((c >> 12) & 0x3F));
+        out += char(0x80 | ((c >> 6) & 0x3F));
+        out += char(0x80 | (c & 0x3F));
+    }
+}
+
+/// Returns `true` if `c` is a valid code point (and not a surrogate).
+constexpr bool is_valid_code_point(char_t c) {
+    return c <= 0x10FFFF && (c < 0xD800 || c > 0xDFFF);
+}
+
+//@{
+/**
+ * Returns `true` if the non-ASCII code point `c` can begin (XID_Start) or
+ * continue (XID_Continue) an identifier.
+ */
+bool is_xid_start(char_t c);
+bool is_xid_continue(char_t c);
+//@}
+
+} // namespace fp::lex::detail
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include <fp/lex/token.h>
+#include <fp/util/table.h>
+
+namespace fp::lex {
+
+/// A language keyword and its string representation.
+struct keyword {
+    std::string_view name;
+    lex::token       token = token::ERROR;
+};
+
+/// All language keywords.
+constexpr std::array<keyword, 27> keywords = {{
+    {"and",      token::AND     },
+    {"as",       token::AS      },
+    {"break",    token::BREAK   },
+    {"case",     token::CASE    },
+    {"catch",    token::CATCH   },
+    {"class",    token::CLASS   },
+    {"concept",  token::CONCEPT },
+    {"continue", token::CONTINUE},
+    {"default",  token::DEFAULT },
+    {"do",       token::DO      },
+    {"else",     token::ELSE    },
+    {"enum",     token::ENUM    },
+    {"export",   token::EXPORT  },
+    {"for",      token::FOR     },
+    {"if",       token::IF      },
+    {"implicit", token::IMPLICIT},
+    {"import",   token::IMPORT  },
+    {"in",       token::IN      },
+    {"mut",      token::MUT     },
+    {"not",      token::NOT     },
+    {"of",       token::OF      },
+    {"or",       token::OR      },
+    {"return",   token::RETURN  },
+    {"switch",   token::SWITCH  },
+    {"throw",    token::THROW   },
+    {"try",      token::TRY     },
+    {"while",    token::WHILE   }
+}};
+
+namespace detail {
+
+/// The number of slots in detail::keywords_table (must be a power of 2).
+constexpr size_t keywords_table_size = 64;
+
+/**
+ * A hash function for keyword names, combining their first character, last
+ * character and length.
+ *
+ * The factors are searched for at compile time (see detail::keyword_hash_for)
+ * such that no two keywords have the same hash, i.e., it's a perfect hash.
+ */
+struct keyword_hash {
+    size_t first_factor = 0;
+    size_t last_factor  = 0;
+
+    constexpr size_t operator()(std::string_view name) const {
+        size_t hash =
+            first_factor * uint8_t(name.front()) +
+            last_factor  * uint8_t(name.back()) +
+            name.size();
+        return hash & (keywords_table_size - 1);
+    }
+};
+
+/**
+ * Returns the first keyword_hash that maps all `words` into different slots,
+ * or a keyword_hash with a `first_factor` of 0 if there is none.
+ */
+template <size_t N>
+constexpr keyword_hash keyword_hash_for(const std::array<keyword, N>& words) {
+    for (size_t first = 1; first < keywords_table_size; ++first) {
+        for (size_t last = 0; last < keywords_table_size; ++last) {
+            keyword_hash hash{first, last};
+            std::array<bool, keywords_table_size> used = {};
+            bool collision = false;
+            for (const keyword& k : words) {
+                bool& slot = used[hash(k.name)];
+                collision = collision || slot;
+                slot = true;
+            }
+            if (!collision) { return hash; }
+        }
+    }
+    return {};
+}
+
+constexpr keyword_hash hash_keyword = keyword_hash_for(keywords);
+
+static_assert(
+    hash_keyword.first_factor != 0,
+    "no perfect hash was found for the keywords, try a larger table"
+);
+
+/// Keywords by their hash, empty slots have an empty name.
+constexpr auto keywords_table =
+    util::table<size_t, keyword, keywords_table_size>([](auto& t) {
+        for (const keyword& k : keywords) { t[hash_keyword(k.name)] = k; }
+    });
+
+/// Maps each token to whether it is a keyword token.
+constexpr auto keyword_tokens =
+    util::table<token, bool, n_tokens>([](auto& t) {
+        t.set_default(false);
+        for (const keyword& k : keywords) { t[k.token] = true; }
+    });
+
+/// The minimal and maximal length of keyword names.
+constexpr auto keyword_name_lengths = []() {
+    std::pair<size_t, size_t> result = {keywords[0].name.size(), 0};
+    for (const keyword& k : keywords) {
+        result.first  = std::min(result.first , k.name.size());
+        result.second = std::max(result.second, k.name.size());
+    }
+    return result;
+}();
+
+} // namespace detail
+
+/**
+ * Returns the keyword token whose string representation is `name`, or
+ * `std::nullopt` if `name` is not a keyword.
+ *
+ * Only a single keyword is compared against `name`, which is found using a
+ * perfect hash that is generated at compile time.
+ */
+constexpr std::optional<token> find_keyword(std::string_view name) {
+    const auto [min_length, max_length] = detail::keyword_name_lengths;
+    if (name.size() < min_length || name.size() > max_length) {
+        return std::nullopt;
+    }
+    const keyword& candidate =
+        detail::keywords_table[detail::hash_keyword(name)];
+    if (candidate.name != name) { return std::nullopt; }
+    return candidate.token;
+}
+
+/// Returns `true` if the token is a keyword token.
+constexpr bool is_keyword(token t) { return detail::keyword_tokens[t]; }
+
+} // namespace fp::lex
@@ -1,3 +1,4 @@
+#include <fp/lex/keywords.h>
 #include <fp/util/ansi/codes.h>
 
 #include "to_terminal.h"
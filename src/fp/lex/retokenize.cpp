@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <functional>
+#include <ranges>
+#include <vector>
+
+#include <fp/lex/tokenize.h>
+#include <fp/lex/detail/tokenization_state.h>
+#include <fp/lex/detail/utf8.h>
+
+#include "retokenize.h"
+
+namespace fp::lex {
+
+namespace detail {
+
+/// Returns `true` if `section` is a part of `content`.
+static bool contains(source_view content, source_view section) {
+    std::less_equal<const char*> less_equal;
+    return
+        less_equal(content.data(), section.data()) &&
+        less_equal(
+            section.data() + section.size(),
+            content.data() + content.size()
+        );
+}
+
+/**
+ * Returns a copy of the `previous` token (of a source file whose content is
+ * `previous_content`) moved `shift` characters forward into `file`.
+ */
+static tokenized_token relocate(
+    const tokenized_token& previous,
+    source_view previous_content,
+    const source_file& file,
+    ptrdiff_t shift
+) {
+    auto relocate_view = [&](source_view view) {
+        // some attributes don't refer to the source code (e.g. dummy values)
+        if (!contains(previous_content, view)) { return view; }
+        size_t offset = view.data() - previous_content.data();
+        return file.content.substr(offset + shift, view.size());
+    };
+    lex::attribute_t attribute = previous.attribute;
+    if (auto* view = std::get_if<source_view>(&attribute)) {
+        *view = relocate_view(*view);
+    }
+    return {
+        .token = previous.token,
+        .dummy = previous.dummy,
+        .attribute = std::move(attribute),
+        .source_location = {
+            .chars = relocate_view(previous.source_location.chars),
+            .file = file
+        }
+    };
+}
+
+/**
+ * Returns a section of the whole lines of `file` that contain the characters
+ * `[begin, end)` (see fp::source_file::first_offset).
+ */
+static std::shared_ptr<source_file> section(
+    const source_file& file,
+    size_t begin,
+    size_t end
+) {
+    source_view content = file.content;
+    auto is_line_break = [](char c) { return c == '\n' || c == '\r'; };
+    while (begin > 0 && !is_line_break(content[begin - 1])) { --begin; }
+    while (end < content.size() && !is_line_break(content[end])) { ++end; }
+    if (end < content.size()) {
+        end += content.substr(end).starts_with("\r\n") ? 2 : 1;
+    }
+    return std::make_shared<source_file>(
+        file.name,
+        std::string(content.substr(begin, end - begin)),
+        begin,
+        file.line_number(content.begin() + begin)
+    );
+}
+
+/// Random access to the tokens of lex::piecewise_tokens.
+struct piece_index {
+    const piecewise_tokens& tokens;
+
+    /// The index of the first token of each piece.
+    std::vector<size_t> starts;
+
+    explicit piece_index(const piecewise_tokens& tokens) : tokens(tokens) {
+        size_t start = 0;
+        starts.reserve(tokens.pieces.size());
+        for (const piecewise_tokens::piece& piece : tokens.pieces) {
+            starts.push_back(start);
+            start += piece.end - piece.begin;
+        }
+    }
+
+    /// Returns the index of the piece of the `i`th token (or of the end).
+    size_t piece_of(size_t i) const {
+        return std::upper_bound(starts.begin(), starts.end(), i) -
+            starts.begin() - 1;
+    }
+
+    /// Returns the index of the `i`th token in the run of its piece `p`.
+    size_t run_index(size_t p, size_t i) const {
+        return tokens.pieces[p].begin + (i - starts[p]);
+    }
+
+    const tokenized_token& operator[](size_t i) const {
+        size_t p = piece_of(i);
+        return tokens.pieces[p].run->tokens[run_index(p, i)];
+    }
+
+    /// Returns the offset of the `i`th token in the current content.
+    size_t offset(size_t i) const {
+        size_t p = piece_of(i);
+        return tokens.pieces[p].offset_of(
+            tokens.pieces[p].run->tokens[run_index(p, i)]
+                .source_location.chars.begin()
+        );
+    }
+
+    /// Returns the offset of the end of the `i`th token.
+    size_t end_offset(size_t i) const {
+        return offset(i) + (*this)[i].source_location.chars.size();
+    }
+
+    /// See lex::token_run::restartable (`i` may be the end of the tokens).
+    bool restartable(size_t i) const {
+        size_t p = piece_of(i);
+        return tokens.pieces[p].run->restartable[run_index(p, i)];
+    }
+
+    /**
+     * Calls `f(piece, token)` for each token in the range `[from, to)`, along
+     * with its piece.
+     */
+    template <class F>
+    void for_each(size_t from, size_t to, F&& f) const {
+        for (size_t p = piece_of(from); from < to; ++p) {
+            const piecewise_tokens::piece& piece = tokens.pieces[p];
+            size_t last = std::min(to, starts[p] + (piece.end - piece.begin));
+            for (; from < last; ++from) {
+                f(piece, piece.run->tokens[run_index(p, from)]);
+            }
+        }
+    }
+
+    /**
+     * Appends the parts of the pieces in the range `[from, to)` to `pieces`,
+     * moved `shift` characters forward.
+     */
+    void append(
+        std::vector<piecewise_tokens::piece>& pieces,
+        size_t from,
+        size_t to,
+        ptrdiff_t shift
+    ) const {
+        for (size_t p = piece_of(from); from < to; ++p) {
+            const piecewise_tokens::piece& piece = tokens.pieces[p];
+            size_t last = std::min(to, starts[p] + (piece.end - piece.begin));
+            pieces.push_back({
+                .run = piece.run,
+                .begin = run_index(p, from),
+                .end = run_index(p, last),
+                .offset = piece.offset + shift
+            });
+            from = last;
+        }
+    }
+};
+
+} // namespace detail
+
+piecewise_tokens::piecewise_tokens(
+    std::shared_ptr<const source_file> file,
+    tokenized_list tokens
+) :
+    file(std::move(file))
+{
+    if (tokens.empty()) { return; }
+    auto run = std::make_shared<token_run>();
+    run->file = this->file;
+    run->restartable = detail::restartable_tokens(tokens);
+    run->tokens = std::move(tokens);
+    pieces.push_back({
+        .run = run,
+        .begin = 0,
+        .end = run->tokens.size(),
+        .offset = ptrdiff_t(this->file->first_offset)
+    });
+}
+
+size_t piecewise_tokens::size() const {
+    size_t size = 0;
+    for (const piece& p : pieces) { size += p.end - p.begin; }
+    return size;
+}
+
+tokenized_list piecewise_tokens::expand(size_t from, size_t to) const {
+    tokenized_list tokens;
+    tokens.reserve(to - from);
+    detail::piece_index(*this).for_each(
+        from, to,
+        [&](const piece& p, const tokenized_token& t) {
+            tokens.push_back(detail::relocate(
+                t,
+                p.run->file->content,
+                *file,
+                p.offset - ptrdiff_t(file->first_offset)
+            ));
+        }
+    );
+    return tokens;
+}
+
+piecewise_tokens::piece piecewise_tokens::copy(size_t from, size_t to) const {
+    auto run = std::make_shared<token_run>();
+    if (from == to) {
+        run->file = file;
+        run->restartable = {true};
+        return {
+            .run = std::move(run),
+            .begin = 0,
+            .end = 0,
+            .offset = ptrdiff_t(file->first_offset)
+        };
+    }
+    const detail::piece_index index(*this);
+    std::shared_ptr<source_file> section = detail::section(
+        *file,
+        index.offset(from) - file->first_offset,
+        index.end_offset(to - 1) - file->first_offset
+    );
+    run->tokens.reserve(to - from);
+    run->restartable.reserve(to - from + 1);
+    index.for_each(from, to, [&](const piece& p, const tokenized_token& t) {
+        run->tokens.push_back(detail::relocate(
+            t,
+            p.run->file->content,
+            *section,
+            p.offset - ptrdiff_t(section->first_offset)
+        ));
+        run->restartable.push_back(
+            p.run->restartable[&t - p.run->tokens.data()]
+        );
+    });
+    run->restartable.push_back(index.restartable(to));
+    run->file = std::move(section);
+    return {
+        .run = run,
+        .begin = 0,
+        .end = run->tokens.size(),
+        .offset = ptrdiff_t(run->file->first_offset)
+    };
+}
+
+retokenized_list retokenize(
+    const piecewise_tokens& previous,
+    std::shared_ptr<const source_file> edited,
+    const source_edit& edit,
+    diagnostic::report& report,
+    symbol_table& symbols
+) {
+    const ptrdiff_t shift = ptrdiff_t(edit.inserted.size() - edit.removed);
+    if (previous.pieces.empty()) {
+        tokenized_list tokens = tokenize(*edited, report, symbols);
+        size_t size = tokens.size();
+        return {
+            piecewise_tokens(std::move(edited), std::move(tokens)),
+            token_splice{0, 0, size, shift}
+        };
+    }
+
+    const detail::piece_index index(previous);
+    const size_t size = previous.size();
+    const size_t edit_end = edit.offset + edit.inserted.size();
+
+    // Tokenizers look (at most) a whole code point past the end of their
+    // tokens (e.g. whether the UTF-8 sequence after an identifier continues
+    // it, which is up to detail::max_utf8_size bytes), so the tokens that are
+    // kept must end at least that many characters before the edited ones.
+    // Tokenization then restarts right after the last kept token (so that any
+    // whitespace after it is skipped again).
+    auto indices = std::views::iota(size_t(0), size);
+    size_t begin = std::ranges::partition_point(
+        indices,
+        [&](size_t i) {
+            return index.end_offset(i) + detail::max_utf8_size <= edit.offset;
+        }
+    ) - indices.begin();
+    while (!index.restartable(begin)) { --begin; }
+
+    tokenized_list tokens;
+    detail::tokenization_state s(*edited, tokens, report, symbols);
+    s.next += begin == 0 ? 0 : index.end_offset(begin - 1);
+
+    // tokenize until reaching a token of `previous` (after the edit), from
+    // which the previous tokenization continued in the same state
+    size_t previous_end = size;
+    for (size_t i = begin; s.next != s.end; ) {
+        size_t next_offset = s.next - edited->content.begin();
+        if (next_offset >= edit_end && s.string_interpolation_stack.empty()) {
+            size_t previous_offset = next_offset - shift;
+            while (i < size && index.offset(i) < previous_offset) { ++i; }
+            if (
+                i < size &&
+                index.offset(i) == previous_offset &&
+                index.restartable(i)
+            ) {
+                previous_end = i;
+                break;
+            }
+        }
+        detail::tokenize_next(s);
+    }
+
+    // the tokens before and after the re-tokenized ones are shared, and only
+    // the re-tokenized tokens are moved into a section of the edited file
+    piecewise_tokens result;
+    result.file = edited;
+    index.append(result.pieces, 0, begin, 0);
+    if (!tokens.empty()) {
+        piecewise_tokens retokenized(edited, std::move(tokens));
+        result.pieces.push_back(retokenized.copy(0, retokenized.size()));
+    }
+    size_t end = result.size();
+    index.append(result.pieces, previous_end, size, shift);
+    return {
+        std::move(result),
+        token_splice{begin, previous_end, end, shift}
+    };
+}
+
+} // namespace fp::lex
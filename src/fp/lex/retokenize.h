@@ -0,0 +1,152 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <fp/source_code.h>
+#include <fp/symbol_table.h>
+#include <fp/diagnostic/report.h>
+#include <fp/lex/tokenized_list.h>
+
+namespace fp::lex {
+
+/**
+ * Tokens that are shared by the pieces of lex::piecewise_tokens (of any
+ * version of the source file), along with the source code they refer to.
+ */
+struct token_run {
+    /**
+     * The source code of the tokens. Tokens that are re-tokenized after an
+     * edit refer to a section of the edited source file (see
+     * fp::source_file::first_offset), which holds only the lines of the
+     * tokens, so that the whole versions of the file aren't kept alive.
+     */
+    std::shared_ptr<const source_file> file;
+
+    tokenized_list tokens;
+
+    /**
+     * Whether tokenization can restart at each token, which is the case unless
+     * it's inside a string interpolation (see detail::restartable_tokens).
+     */
+    std::vector<bool> restartable;
+};
+
+/**
+ * A list of tokens of a source file that is edited incrementally (see
+ * lex::retokenize), which is stored in pieces, so that the tokens that an
+ * edit doesn't change are shared with the previous versions of the list
+ * rather than copied.
+ *
+ * Each piece is a range of the tokens of a lex::token_run. Its tokens keep
+ * the source locations that they were tokenized with (which are never
+ * modified), and the piece holds the offset of their source code in the
+ * current version of the file instead (see piecewise_tokens::piece::offset_of).
+ */
+struct piecewise_tokens {
+    /// A range of the tokens of a lex::token_run.
+    struct piece {
+        std::shared_ptr<const token_run> run;
+        size_t begin;
+        size_t end;
+
+        /// The offset of the beginning of the content of `run->file`.
+        ptrdiff_t offset;
+
+        /// The tokens of the piece.
+        tokenized_view tokens() const {
+            return tokenized_view(run->tokens).subspan(begin, end - begin);
+        }
+
+        /// Returns the offset (in the current content) of `chars` of the run.
+        size_t offset_of(source_iterator chars) const {
+            return size_t(offset + (chars - run->file->content.begin()));
+        }
+    };
+
+    /// The current version of the source file.
+    std::shared_ptr<const source_file> file;
+
+    std::vector<piece> pieces;
+
+    piecewise_tokens() = default;
+
+    /// Constructs a single piece of the given `tokens` of `file`.
+    piecewise_tokens(
+        std::shared_ptr<const source_file> file,
+        tokenized_list tokens
+    );
+
+    /// The number of tokens in all the pieces.
+    size_t size() const;
+
+    //@{
+    /**
+     * Reconstructs a lex::tokenized_list out of the tokens in the range
+     * `[from, to)` (or of all tokens, if no range is given), whose source
+     * locations are relocated into `file`.
+     */
+    tokenized_list expand() const { return expand(0, size()); }
+    tokenized_list expand(size_t from, size_t to) const;
+    //@}
+
+    /**
+     * Copies the tokens in the range `[from, to)` into a single piece of a new
+     * lex::token_run, whose source code is a section of the lines of `file`
+     * that contain them (used to parse them as a contiguous list).
+     */
+    piece copy(size_t from, size_t to) const;
+};
+
+/**
+ * Describes which tokens were replaced by lex::retokenize.
+ *
+ * The tokens `[0, begin)` are the same in the previous and the new list. The
+ * previous tokens `[previous_end, previous size)` are the same as the new
+ * tokens `[end, new size)`. Only the tokens in between were re-tokenized.
+ */
+struct token_splice {
+    size_t begin;
+    size_t previous_end;
+    size_t end;
+
+    /// The number of characters by which the tokens after the splice moved.
+    ptrdiff_t shift;
+};
+
+/// The result of lex::retokenize.
+struct retokenized_list {
+    piecewise_tokens tokens;
+    token_splice     splice;
+};
+
+/**
+ * Tokenizes the `edited` source file, given the tokens of the source file
+ * before it was edited (`previous`) and the applied `edit`.
+ *
+ * Only the edited section of the source code is tokenized, starting from the
+ * nearest preceding token boundary at which tokenization can restart (one
+ * that's not inside a string or a string interpolation), and stopping as soon
+ * as tokenization reaches a boundary of the previous tokens (after the edit)
+ * at which it's in the same state. The re-tokenized tokens are added as a new
+ * piece, and the pieces of `previous` before and after them are shared (and
+ * moved by the edit), so the cost of the edit doesn't depend on the size of
+ * the file, but on the size of the edit and on the number of pieces.
+ *
+ * The result is the same as `tokenize(*edited, report, symbols)` (see
+ * piecewise_tokens::expand), except that problems are only reported for the
+ * re-tokenized section. `previous` must have been tokenized with the same
+ * fp::symbol_table.
+ *
+ * `previous` is not modified, so it (and anything that refers to it, like an
+ * AST) stays valid until the caller discards it.
+ */
+retokenized_list retokenize(
+    const piecewise_tokens& previous,
+    std::shared_ptr<const source_file> edited,
+    const source_edit& edit,
+    diagnostic::report&,
+    symbol_table&
+);
+
+} // namespace fp::lex
@@ -3,8 +3,6 @@
 #include <cstdint>
 #include <ostream>
 #include <string_view>
-#include <unordered_set>
-#include <unordered_map>
 
 namespace fp::lex {
 
@@ -107,7 +105,7 @@ enum class token : uint8_t {
     // containing attributes
     COMMENT,        ///< # some comment...
     IDENTIFIER,     ///< some_identifier, Can_Be_CAPITALIZED
-    NUMBER,         ///< 42, 0xFF, 0b11, 1'000'000, 3.14, 1.23e-10, ...
+    NUMBER,         ///< 42, 0xFF, 0b11, 1'000'000, 3.14, 1.23e-10, 42`u8, ...
     CHAR,           ///< 'a'
 
     /**
@@ -138,15 +136,6 @@ enum class token : uint8_t {
 /// The number of available tokens (in lex::token).
 constexpr size_t n_tokens = size_t(token::_n_tokens);
 
-/// The set of all keyword tokens.
-extern std::unordered_set<token> keywords;
-
-/// A mapping to all keyword tokens from their string representation.
-extern std::unordered_map<std::string_view, token> keywords_map;
-
-/// Returns `true` if the token is a keyword token.
-bool is_keyword(token);
-
 /**
  * Returns a string representation for a lex::token.
  *
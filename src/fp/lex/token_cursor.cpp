@@ -0,0 +1,83 @@
+#include <iterator>
+#include <stdexcept>
+
+#include <fp/lex/detail/tokenization_state.h>
+
+#include "token_cursor.h"
+
+namespace fp::lex {
+
+struct token_cursor::state {
+    /**
+     * The produced tokens, of which the first `consumed` were already
+     * consumed. Consumed tokens are discarded whenever more tokens are needed.
+     */
+    tokenized_list tokens;
+    size_t consumed = 0;
+
+    detail::tokenization_state tokenization;
+
+    state(
+        const source_file& file,
+        diagnostic::report& report,
+        symbol_table& symbols
+    ) :
+        tokenization(file, tokens, report, symbols)
+    {}
+
+    /// Tokenizes until there are more than `n` tokens that were not consumed.
+    bool fill(size_t n) {
+        while (tokens.size() - consumed <= n) {
+            if (tokenization.next == tokenization.end) { return false; }
+            if (consumed > 0 && consumed >= tokens.size() / 2) {
+                discard_consumed();
+            }
+            detail::tokenize_next(tokenization);
+        }
+        return true;
+    }
+
+    /// Discards the consumed tokens (keeping the capacity of `tokens`).
+    void discard_consumed() {
+        // (tokens are not assignable, so they can't just be erased)
+        tokenized_list rest(
+            std::make_move_iterator(tokens.begin() + consumed),
+            std::make_move_iterator(tokens.end())
+        );
+        tokens.clear();
+        for (tokenized_token& t : rest) { tokens.push_back(std::move(t)); }
+        consumed = 0;
+    }
+};
+
+token_cursor::token_cursor(
+    const source_file& file,
+    diagnostic::report& report,
+    symbol_table& symbols
+) :
+    state_(std::make_unique<state>(file, report, symbols))
+{}
+
+token_cursor::~token_cursor() = default;
+token_cursor::token_cursor(token_cursor&&) = default;
+token_cursor& token_cursor::operator=(token_cursor&&) = default;
+
+bool token_cursor::done() { return !state_->fill(0); }
+
+const tokenized_token* token_cursor::peek(size_t n) {
+    if (!state_->fill(n)) { return nullptr; }
+    return &state_->tokens[state_->consumed + n];
+}
+
+tokenized_token token_cursor::next() {
+    if (!state_->fill(0)) {
+        throw std::out_of_range("no tokens left in token_cursor");
+    }
+    return std::move(state_->tokens[state_->consumed++]);
+}
+
+size_t token_cursor::buffered() const {
+    return state_->tokens.size() - state_->consumed;
+}
+
+} // namespace fp::lex
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+
+#include <fp/source_code.h>
+#include <fp/symbol_table.h>
+#include <fp/diagnostic/report.h>
+#include <fp/lex/tokenized_list.h>
+
+namespace fp::lex {
+
+/**
+ * Tokenizes a source file lazily, producing tokens on demand.
+ *
+ * Unlike lex::tokenize, which produces the tokens of the whole file up front,
+ * a token_cursor only tokenizes as much of the file as needed to provide the
+ * requested tokens. Only the tokens that were not consumed yet are kept, so
+ * memory usage is proportional to the used lookahead (see token_cursor::peek),
+ * rather than to the size of the file. This is useful for consumers that only
+ * make a single pass over the tokens (such as syntax highlighting).
+ *
+ * The produced tokens (and reported problems) are the same as those of
+ * lex::tokenize.
+ *
+ * A token_cursor is also an input range of the remaining tokens:
+ * ~~~{.cpp}
+ * for (const auto& t : lex::token_cursor(file, report, symbols)) {
+ *     ...
+ * }
+ * ~~~
+ */
+struct token_cursor {
+    struct iterator;
+
+    token_cursor(
+        const source_file&,
+        diagnostic::report&,
+        symbol_table&
+    );
+    ~token_cursor();
+
+    token_cursor(token_cursor&&);
+    token_cursor& operator=(token_cursor&&);
+
+    /// Returns `true` if all tokens were consumed.
+    bool done();
+
+    /**
+     * Returns the `n`-th token after the next token (or the next token itself
+     * if `n` is 0), without consuming it.
+     *
+     * Returns `nullptr` if there are not enough tokens left.
+     *
+     * References to peeked tokens are invalidated by the next call to a
+     * non-const member function.
+     */
+    const tokenized_token* peek(size_t n = 0);
+
+    /**
+     * Consumes and returns the next token.
+     *
+     * @throws std::out_of_range when all tokens were already consumed.
+     */
+    tokenized_token next();
+
+    /// The number of tokens that were produced but not consumed yet.
+    size_t buffered() const;
+
+    iterator begin();
+    std::default_sentinel_t end() { return {}; }
+
+private:
+    struct state;
+    std::unique_ptr<state> state_;
+};
+
+/**
+ * An input iterator over the remaining tokens of a lex::token_cursor.
+ *
+ * Incrementing the iterator consumes the token it points to.
+ */
+struct token_cursor::iterator {
+    using iterator_concept = std::input_iterator_tag;
+    using value_type       = tokenized_token;
+    using difference_type  = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(token_cursor& cursor) : cursor(&cursor) {}
+
+    const tokenized_token& operator*() const { return *cursor->peek(); }
+    const tokenized_token* operator->() const { return cursor->peek(); }
+
+    iterator& operator++() {
+        cursor->next();
+        return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    bool operator==(std::default_sentinel_t) const { return cursor->done(); }
+
+private:
+    token_cursor* cursor = nullptr;
+};
+
+inline token_cursor::iterator token_cursor::begin() { return iterator(*this); }
+
+} // namespace fp::lex
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <limits>
+
+#include <fp/util/assert.h>
+#include <fp/lex/print/to_terminal.h>
+
+#include "token_stream.h"
+
+namespace fp::lex {
+
+token_stream::token_stream(const source_file& file, tokenized_view tokens) :
+    file_(&file)
+{
+    reserve(tokens.size());
+    for (const tokenized_token& t : tokens) {
+        push(t.token, t.dummy, t.attribute, t.source_location.chars);
+    }
+}
+
+void token_stream::reserve(size_t n) {
+    kinds_.reserve(n);
+    offsets_.reserve(n);
+    lengths_.reserve(n);
+}
+
+bool token_stream::is_dummy(size_t i) const {
+    return std::binary_search(dummies_.begin(), dummies_.end(), uint32_t(i));
+}
+
+const attribute_t& token_stream::attribute(size_t i) const {
+    static const attribute_t no_attribute;
+    auto it = std::lower_bound(
+        attributes_.begin(), attributes_.end(), uint32_t(i),
+        [](const auto& entry, uint32_t i) { return entry.first < i; }
+    );
+    if (it == attributes_.end() || it->first != i) { return no_attribute; }
+    return it->second;
+}
+
+source_location token_stream::location(size_t i) const {
+    return source_location { .chars = chars(i), .file = *file_ };
+}
+
+tokenized_token token_stream::operator[](size_t i) const {
+    return {
+        .token = kinds_[i],
+        .dummy = is_dummy(i),
+        .attribute = attribute(i),
+        .source_location = location(i)
+    };
+}
+
+void token_stream::push(
+    lex::token t,
+    bool dummy,
+    attribute_t attribute,
+    source_view chars
+) {
+    size_t offset = chars.begin() - file_->content.begin();
+    FP_ASSERT(
+        offset + chars.size() <= std::numeric_limits<uint32_t>::max(),
+        "token_stream supports source files of up to 4GB"
+    );
+    uint32_t i = uint32_t(kinds_.size());
+    kinds_.push_back(t);
+    offsets_.push_back(uint32_t(offset));
+    lengths_.push_back(uint32_t(chars.size()));
+    if (!std::holds_alternative<std::monostate>(attribute)) {
+        attributes_.emplace_back(i, std::move(attribute));
+    }
+    if (dummy) { dummies_.push_back(i); }
+}
+
+tokenized_list token_stream::expand(size_t from, size_t to) const {
+    tokenized_list tokens;
+    tokens.reserve(to - from);
+    for (size_t i = from; i < to; ++i) { tokens.push_back((*this)[i]); }
+    return tokens;
+}
+
+std::ostream& operator<<(std::ostream& os, const token_stream& tokens) {
+    for (const tokenized_token& t : tokens) {
+        fp::lex::print::to_terminal(os, t);
+        os << '\n';
+    }
+    return os;
+}
+
+} // namespace fp::lex
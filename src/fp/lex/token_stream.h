@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <fp/source_code.h>
+#include <fp/lex/token.h>
+#include <fp/lex/attribute.h>
+#include <fp/lex/tokenized_list.h>
+
+namespace fp::lex {
+
+/**
+ * A compact storage of tokenized tokens, laid out as parallel arrays.
+ *
+ * A lex::tokenized_list stores a full lex::tokenized_token for each token,
+ * which includes an attribute variant and a complete fp::source_location. This
+ * means that even a single `;` token costs around 100 bytes.
+ *
+ * A token_stream stores the same information in a "struct-of-arrays" layout:
+ *
+ *  - The kind of each token (lex::token) in 1 byte.
+ *  - The offset and length of each token's characters (relative to the
+ *    beginning of the source file) as 32-bit integers.
+ *  - A side table of attributes, that only holds entries for tokens that
+ *    actually have an attribute attached (identifiers, numbers, ...).
+ *  - A side table of the indices of dummy tokens.
+ *
+ * Like fp::source_location, line information is not stored at all, and is
+ * only resolved on demand (see fp::source_file::line_offsets).
+ *
+ * Tokens can be accessed by index, or iterated over. In both cases they are
+ * reconstructed as lex::tokenized_token values. Since AST nodes refer to their
+ * tokens with lex::token_iterator, a token_stream (or a part of it) can be
+ * expanded to a lex::tokenized_list using token_stream::expand(), which can
+ * then be given to syntax::parse.
+ */
+struct token_stream {
+    struct iterator;
+
+    /// Constructs an empty token stream of tokens from the given `file`.
+    explicit token_stream(const source_file& file) : file_(&file) {}
+
+    /// Constructs a compacted copy of the given `tokens` of the given `file`.
+    token_stream(const source_file& file, tokenized_view tokens);
+
+    /// The source file that the tokens originate from.
+    const source_file& file() const { return *file_; }
+
+    /// The number of tokens in the stream.
+    size_t size() const { return kinds_.size(); }
+
+    /// Returns `true` if the stream contains no tokens.
+    bool empty() const { return kinds_.empty(); }
+
+    /// Reserves storage for `n` tokens.
+    void reserve(size_t n);
+
+    /// The kinds of all tokens in the stream, ordered by their appearance.
+    std::span<const token> kinds() const { return kinds_; }
+
+    /// The kind of the `i`-th token.
+    lex::token kind(size_t i) const { return kinds_[i]; }
+
+    /// Returns `true` if the `i`-th token is a dummy token.
+    bool is_dummy(size_t i) const;
+
+    /// The source code characters of the `i`-th token.
+    source_view chars(size_t i) const {
+        return file_->content.substr(offsets_[i], lengths_[i]);
+    }
+
+    /**
+     * The attribute of the `i`-th token. For tokens that have no attribute,
+     * an std::monostate attribute is returned.
+     */
+    const attribute_t& attribute(size_t i) const;
+
+    /**
+     * Returns the attached attribute of the `i`-th token, assuming that it is
+     * a `TOKEN`. If this assumption is not respected, a std::bad_variant_access
+     * will be thrown.
+     */
+    template <lex::token TOKEN>
+    const token_attribute_t<TOKEN>& get_attribute(size_t i) const {
+        return std::get<token_attribute_t<TOKEN>>(attribute(i));
+    }
+
+    /// The source location of the `i`-th token.
+    source_location location(size_t i) const;
+
+    /// Reconstructs the `i`-th token.
+    tokenized_token operator[](size_t i) const;
+
+    iterator begin() const;
+    iterator end() const;
+
+    /// Appends a token to the end of the stream.
+    void push(
+        lex::token t,
+        bool dummy,
+        attribute_t attribute,
+        source_view chars
+    );
+
+    //@{
+    /**
+     * Reconstructs a lex::tokenized_list out of the tokens in the range
+     * `[from, to)` (or of all tokens, if no range is given).
+     */
+    tokenized_list expand() const { return expand(0, size()); }
+    tokenized_list expand(size_t from, size_t to) const;
+    //@}
+
+private:
+    const source_file*      file_;
+    std::vector<lex::token> kinds_;
+    std::vector<uint32_t>   offsets_;
+    std::vector<uint32_t>   lengths_;
+
+    /// Pairs of token index and attribute, sorted by the token index.
+    std::vector<std::pair<uint32_t, attribute_t>> attributes_;
+
+    /// Indices of the dummy tokens, in ascending order.
+    std::vector<uint32_t> dummies_;
+};
+
+/**
+ * A random-access iterator over a lex::token_stream.
+ *
+ * Dereferencing the iterator reconstructs the lex::tokenized_token (by value).
+ */
+struct token_stream::iterator {
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = tokenized_token;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = tokenized_token;
+    using pointer           = void;
+
+    iterator() = default;
+    iterator(const token_stream& stream, size_t i) : stream_(&stream), i_(i) {}
+
+    /// The index of the token that the iterator points to.
+    size_t index() const { return i_; }
+
+    lex::token kind() const { return stream_->kind(i_); }
+
+    tokenized_token operator*() const { return (*stream_)[i_]; }
+    tokenized_token operator[](difference_type n) const {
+        return (*stream_)[i_ + n];
+    }
+
+    iterator& operator++() { ++i_; return *this; }
+    iterator& operator--() { --i_; return *this; }
+    iterator operator++(int) { iterator it = *this; ++i_; return it; }
+    iterator operator--(int) { iterator it = *this; --i_; return it; }
+
+    iterator& operator+=(difference_type n) { i_ += n; return *this; }
+    iterator& operator-=(difference_type n) { i_ -= n; return *this; }
+
+    friend iterator operator+(iterator it, difference_type n) {
+        return it += n;
+    }
+
+    friend iterator operator+(difference_type n, iterator it) {
+        return it += n;
+    }
+
+    friend iterator operator-(iterator it, difference_type n) {
+        return it -= n;
+    }
+
+    friend difference_type operator-(iterator it1, iterator it2) {
+        return difference_type(it1.i_) - difference_type(it2.i_);
+    }
+
+    friend bool operator==(iterator it1, iterator it2) {
+        return it1.i_ == it2.i_;
+    }
+
+    friend auto operator<=>(iterator it1, iterator it2) {
+        return it1.i_ <=> it2.i_;
+    }
+
+private:
+    const token_stream* stream_ = nullptr;
+    size_t              i_      = 0;
+};
+
+inline token_stream::iterator token_stream::begin() const {
+    return iterator(*this, 0);
+}
+
+inline token_stream::iterator token_stream::end() const {
+    return iterator(*this, size());
+}
+
+std::ostream& operator<<(std::ostream&, const token_stream&);
+
+} // namespace fp::lex
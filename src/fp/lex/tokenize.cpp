@@ -1,3 +1,10 @@
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include <fp/util/thread_pool.h>
 #include <fp/lex/detail/tokenization_state.h>
 #include <fp/lex/detail/tokenizers_table.h>
 
@@ -5,18 +12,272 @@
 
 namespace fp::lex {
 
-tokenized_list tokenize(const source_file& source, diagnostic::report& report) {
+namespace detail {
+
+/**
+ * Pushes the rest of the source as a single token::ERROR, without looking at
+ * it (once the error budget of the report is exhausted).
+ */
+static void skip_rest(tokenization_state& s) {
+    source_iterator skipped = s.next;
+    s.next = s.end;
+    s.push(token::ERROR);
+    s.report_error(&error::E0013_too_many_errors).add_primary(
+        s.location(skipped, skipped),
+        "the rest of the file is skipped"
+    );
+}
+
+void tokenize_next(tokenization_state& s) {
+    s.begin_next_token();
+    if (s.error_budget_exhausted()) {
+        skip_rest(s);
+        return;
+    }
+    detail::tokenizers_table[*s.next](s);
+}
+
+static void tokenize(tokenization_state& s) {
+    while (s.next != s.end) { tokenize_next(s); }
+}
+
+std::vector<bool> restartable_tokens(const tokenized_list& tokens) {
+    std::vector<bool> result(tokens.size() + 1);
+    // the number of open left-braces in each frame
+    std::vector<size_t> stack;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        result[i] = stack.empty();
+        switch (tokens[i].token) {
+            case token::QUOTE:
+                if (!stack.empty() && stack.back() == 0) {
+                    stack.pop_back(); // closing-quote
+                } else {
+                    stack.push_back(0); // opening-quote
+                }
+                break;
+            case token::L_BRACE:
+                if (!stack.empty()) { stack.back() += 1; }
+                break;
+            case token::R_BRACE:
+                if (!stack.empty()) { stack.back() -= 1; }
+                break;
+            default:
+                break;
+        }
+    }
+    result.back() = stack.empty();
+    return result;
+}
+
+/// Tokenizes until reaching a token boundary at or after `until`.
+static void tokenize_until(tokenization_state& s, source_iterator until) {
+    while (s.next != s.end && s.next < until) { tokenize_next(s); }
+}
+
+/**
+ * Returns the beginnings of (at most) `n_chunks` chunks of roughly the same
+ * size that `content` is split into. Each chunk begins at the beginning of a
+ * line.
+ */
+static std::vector<source_iterator> chunk_begins(
+    source_view content,
+    size_t n_chunks
+) {
+    std::vector<source_iterator> begins = {content.begin()};
+    for (size_t i = 1; i < n_chunks; ++i) {
+        source_iterator approximate_begin =
+            content.begin() + i * content.size() / n_chunks;
+        source_iterator line_break = std::find(
+            std::max(begins.back(), approximate_begin),
+            content.end(),
+            '\n'
+        );
+        if (line_break == content.end()) { break; }
+        begins.push_back(line_break + 1);
+    }
+    return begins;
+}
+
+/// The speculative tokenization of a chunk of source code.
+struct tokenized_chunk {
+    /// Where tokenization of the chunk stopped.
+    source_iterator end;
+
+    tokenized_list     tokens;
+    diagnostic::report report;
+
+    /// The symbols of the chunk's tokens (interned when stitched).
+    symbol_table symbols;
+
+    /// The state in which tokenization stopped.
+    detail::string_interpolation_stack string_interpolation_stack;
+};
+
+/**
+ * Continues the tokenization `s` with the tokens of `chunk` (and its reported
+ * problems), from the first of them that `s` reaches in the same state.
+ *
+ * Until reaching such a token, `s` continues sequentially. If it doesn't reach
+ * any, none of the chunk's tokens are used.
+ */
+static void stitch(
+    tokenization_state& s,
+    tokenized_list& tokens,
+    diagnostic::report& report,
+    tokenized_chunk& chunk
+) {
+    const std::vector<bool> restartable = restartable_tokens(chunk.tokens);
+    auto begin_of = [&](size_t i) {
+        return chunk.tokens[i].source_location.chars.begin();
+    };
+    size_t first = 0;
+    while (true) {
+        while (first < chunk.tokens.size() && begin_of(first) < s.next) {
+            ++first;
+        }
+        if (first == chunk.tokens.size()) { return; }
+        if (
+            begin_of(first) == s.next &&
+            restartable[first] &&
+            s.string_interpolation_stack.empty()
+        ) {
+            break;
+        }
+        tokenize_next(s);
+    }
+
+    auto reported_after = [&](const diagnostic::problem& p) {
+        return p.locations().front().source_location.chars.begin() >= s.next;
+    };
+
+    // the sequential tokenization stops right after exhausting the error
+    // budget, so it continues sequentially through chunks that exhaust it
+    size_t errors = report.errors().size();
+    for (const diagnostic::problem& p : chunk.report.errors()) {
+        if (reported_after(p)) { ++errors; }
+    }
+    if (errors >= report.error_budget()) { return; }
+
+    // intern the chunk's symbols in order of appearance, just like the
+    // sequential tokenization does
+    std::vector<std::optional<symbol_id>> symbols(chunk.symbols.size());
+    for (size_t i = first; i < chunk.tokens.size(); ++i) {
+        tokenized_token& t = chunk.tokens[i];
+        if (auto* id = std::get_if<symbol_id>(&t.attribute)) {
+            std::optional<symbol_id>& symbol = symbols[id->index];
+            if (!symbol) { symbol = s.symbols.intern(chunk.symbols[*id]); }
+            *id = *symbol;
+        }
+        tokens.push_back(std::move(t));
+    }
+
+    for (diagnostic::problem& p : chunk.report.errors()) {
+        if (reported_after(p)) { report.add(std::move(p)); }
+    }
+    for (diagnostic::problem& p : chunk.report.warnings()) {
+        if (reported_after(p)) { report.add(std::move(p)); }
+    }
+
+    s.next = chunk.end;
+    s.string_interpolation_stack = std::move(chunk.string_interpolation_stack);
+}
+
+} // namespace detail
+
+tokenized_list tokenize(
+    const source_file& source,
+    diagnostic::report& report,
+    symbol_table& symbols
+) {
     tokenized_list tokens;
 
     // reserve half the source size for tokens (is a factor of 0.5 good?)
     tokens.reserve(source.content.size() / 2);
 
-    detail::tokenization_state s(source, tokens, report);
-    while (s.next != s.end) {
-        s.begin_next_token();
-        detail::tokenizers_table[*s.next](s);
+    detail::tokenization_state s(source, tokens, report, symbols);
+    detail::tokenize(s);
+
+    return tokens;
+}
+
+tokenized_list tokenize(
+    const source_file& source,
+    diagnostic::report& report,
+    bracket_index& brackets,
+    symbol_table& symbols
+) {
+    tokenized_list tokens;
+    tokens.reserve(source.content.size() / 2);
+
+    brackets = bracket_index();
+    detail::tokenization_state s(source, tokens, report, symbols);
+    s.brackets = &brackets;
+    detail::tokenize(s);
+
+    return tokens;
+}
+
+token_stream tokenize_to_stream(
+    const source_file& source,
+    diagnostic::report& report,
+    symbol_table& symbols
+) {
+    token_stream tokens(source);
+
+    // a token stream is cheap enough to over-reserve (9 bytes per token)
+    tokens.reserve(source.content.size() / 2);
+
+    detail::tokenization_state s(source, tokens, report, symbols);
+    detail::tokenize(s);
+
+    return tokens;
+}
+
+tokenized_list tokenize_parallel(
+    const source_file& source,
+    diagnostic::report& report,
+    symbol_table& symbols,
+    const parallel_tokenization& options
+) {
+    util::thread_pool pool(options.jobs);
+    size_t n_chunks = std::min(
+        source.content.size() / std::max<size_t>(options.min_chunk_size, 1),
+        pool.size() * 4
+    );
+    std::vector<source_iterator> begins =
+        detail::chunk_begins(source.content, n_chunks);
+    if (begins.size() < 2) { return tokenize(source, report, symbols); }
+    begins.push_back(source.content.end());
+
+    tokenized_list tokens;
+    tokens.reserve(source.content.size() / 2);
+    detail::tokenization_state s(source, tokens, report, symbols);
+
+    // the first chunk is tokenized directly into the result
+    pool.submit([&]() { detail::tokenize_until(s, begins[1]); });
+    std::vector<detail::tokenized_chunk> chunks(begins.size() - 2);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        pool.submit([&, i]() {
+            detail::tokenized_chunk& chunk = chunks[i];
+            // the error budget applies to the whole source (see stitch)
+            chunk.report.set_error_budget(std::numeric_limits<size_t>::max());
+            detail::tokenization_state cs(
+                source, chunk.tokens, chunk.report, chunk.symbols
+            );
+            cs.next = begins[i + 1];
+            chunk.tokens.reserve((begins[i + 2] - begins[i + 1]) / 2);
+            detail::tokenize_until(cs, begins[i + 2]);
+            chunk.end = cs.next;
+            chunk.string_interpolation_stack =
+                std::move(cs.string_interpolation_stack);
+        });
     }
+    pool.wait();
 
+    for (detail::tokenized_chunk& chunk : chunks) {
+        detail::stitch(s, tokens, report, chunk);
+    }
+    detail::tokenize_until(s, s.end);
     return tokens;
 }
 
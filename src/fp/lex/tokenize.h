@@ -1,8 +1,11 @@
 #pragma once
 
 #include <fp/source_code.h>
+#include <fp/symbol_table.h>
 #include <fp/diagnostic/report.h>
+#include <fp/lex/bracket_index.h>
 #include <fp/lex/tokenized_list.h>
+#include <fp/lex/token_stream.h>
 
 namespace fp::lex {
 
@@ -12,10 +15,74 @@ namespace fp::lex {
  * All encountered problems during tokenization will be reported to the given
  * diagnostic::report.
  *
+ * Identifiers and string literals are interned in the given fp::symbol_table
+ * (see lex::attribute_t).
+ *
+ * Once the error budget of the report is exhausted (see
+ * diagnostic::report::set_error_budget), the rest of the source code is pushed
+ * as a single token::ERROR, and an error::E0013_too_many_errors is reported.
+ *
  * @throws fp::compilation_error
  *     Thrown when the maximum number of allowed errors is reached (as set by
  *     the given diagnostic::report).
  */
-tokenized_list tokenize(const source_file&, diagnostic::report&);
+tokenized_list tokenize(
+    const source_file&,
+    diagnostic::report&,
+    symbol_table&
+);
+
+/**
+ * Just like lex::tokenize, but also builds the lex::bracket_index of the
+ * produced tokens into `brackets` (in the same pass).
+ */
+tokenized_list tokenize(
+    const source_file&,
+    diagnostic::report&,
+    bracket_index& brackets,
+    symbol_table&
+);
+
+/**
+ * Just like lex::tokenize, but stores the produced tokens in a compact
+ * lex::token_stream instead of a lex::tokenized_list.
+ */
+token_stream tokenize_to_stream(
+    const source_file&,
+    diagnostic::report&,
+    symbol_table&
+);
+
+/// Options of lex::tokenize_parallel.
+struct parallel_tokenization {
+    /// The number of threads (or the number of hardware threads, if 0).
+    size_t jobs = 0;
+
+    /**
+     * The minimal size (in bytes) of each chunk that the source code is split
+     * into. Source code smaller than two chunks is tokenized sequentially.
+     */
+    size_t min_chunk_size = 1 << 20;
+};
+
+/**
+ * Just like lex::tokenize, but splits the source code into chunks that are
+ * tokenized in parallel. The result (including the reported problems and the
+ * IDs of interned symbols) is identical to the result of lex::tokenize.
+ *
+ * Chunks begin at line boundaries, and are speculatively tokenized as if they
+ * begin outside of any string interpolation (strings and comments never span
+ * multiple lines). The chunks are then stitched in order: the tokens of each
+ * chunk are used from the first token at which the tokenization of the chunks
+ * before it continues in the same state. When a chunk begins in the middle of
+ * a multi-line string interpolation, the tokens up to that point are
+ * tokenized again, sequentially.
+ */
+tokenized_list tokenize_parallel(
+    const source_file&,
+    diagnostic::report&,
+    symbol_table&,
+    const parallel_tokenization& = {}
+);
 
 } // namespace fp::lex
@@ -1,16 +1,98 @@
 #pragma once
 
+#include <bit>
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include <fp/source_code.h>
 
 namespace fp {
 
-/// Represents a parsed integer literal. TODO: replace with GMP.
-using integer_t = source_view;
+/**
+ * The exact value of a number literal that is too large to be represented by
+ * fp::number_t's fixed-size values: `mantissa * radix ^ exponent`.
+ */
+struct big_number {
+    /// An arbitrary-precision unsigned integer, as little-endian 32-bit limbs.
+    std::vector<uint32_t> mantissa;
 
-/// Represents a parsed real number literal. TODO: replace with MPFR.
-using float_t = source_view;
+    /// The exponent of the value (always 0 for integer literals).
+    int64_t exponent = 0;
+
+    /// The radix of the exponent (10, or 2 for hexadecimal floats).
+    uint32_t radix = 10;
+
+    bool operator==(const big_number&) const = default;
+};
+
+/**
+ * The type of a number literal, as given by its type suffix (e.g. ``42`u8``).
+ *
+ * Literals without a suffix are either number_kind::INTEGER or
+ * number_kind::FLOAT, whose types are `i64` and `f64` by default.
+ */
+enum class number_kind : uint8_t {
+    INTEGER,    ///< 42, 0xFF, ...
+    FLOAT,      ///< 4.2, 42e10, ...
+    I8,         ///< 42`i8
+    I16,        ///< 42`i16
+    I32,        ///< 42`i32
+    I64,        ///< 42`i64
+    U8,         ///< 42`u8
+    U16,        ///< 42`u16
+    U32,        ///< 42`u32
+    U64,        ///< 42`u64 or 42`u
+    F32,        ///< 42`f32
+    F64,        ///< 42`f64 or 42`f
+};
+
+/**
+ * Represents the value of a number literal.
+ *
+ * The value of the overwhelming majority of literals is stored inline, as a
+ * 64-bit unsigned integer or as a double, without any allocation. Only when a
+ * literal overflows these (e.g. `18446744073709551616` or `1e400`), its exact
+ * value is also stored in an fp::big_number (on the heap).
+ */
+struct number_t {
+    /**
+     * `true` for floating-point literals (with a decimal-point, an exponent or
+     * a floating-point type suffix).
+     */
+    bool is_float = false;
+
+    /// The type of the literal.
+    number_kind kind = number_kind::INTEGER;
+
+    union {
+        /**
+         * The value of an integer literal (or its lowest 64 bits, if it's too
+         * large).
+         */
+        uint64_t integer = 0;
+
+        /**
+         * The value of a floating-point literal, rounded to the nearest double
+         * (or infinity, if it's too large).
+         */
+        double floating;
+    };
+
+    /// The exact value of the literal if it overflows, otherwise null.
+    std::shared_ptr<const big_number> big;
+
+    bool operator==(const number_t& other) const {
+        if (is_float != other.is_float || kind != other.kind) { return false; }
+        bool same_value = is_float
+            ? std::bit_cast<uint64_t>(floating) ==
+                std::bit_cast<uint64_t>(other.floating)
+            : integer == other.integer;
+        return
+            same_value &&
+            (big == other.big || (big && other.big && *big == *other.big));
+    }
+};
 
 /// Represents a parsed character literal.
 using char_t = char32_t;
@@ -1,11 +1,97 @@
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <fp/source_map.h>
+#include <fp/util/assert.h>
+
 #include "source_code.h"
 
 namespace fp {
 
+namespace detail {
+
+/**
+ * Appends the offset following the line-break character at `offset` to
+ * `line_offsets`, unless it's a `\r` that is part of a CRLF combination (in
+ * which case, the line begins after the `\n`).
+ */
+static void add_line_offset(
+    source_view content,
+    size_t offset,
+    std::vector<uint32_t>& line_offsets
+) {
+    bool is_crlf =
+        content[offset] == '\r' &&
+        offset + 1 < content.size() &&
+        content[offset + 1] == '\n';
+    if (!is_crlf) { line_offsets.push_back(uint32_t(offset + 1)); }
+}
+
+/// Scans `content` for line-breaks and fills the given line offsets table.
+static void scan_line_offsets(
+    source_view content,
+    std::vector<uint32_t>& line_offsets
+) {
+    line_offsets.push_back(0);
+    size_t i = 0;
+#if defined(__SSE2__)
+    // compare 16 characters at a time against `\n` and `\r`, and only look at
+    // the characters that matched
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    for (; i + 16 <= content.size(); i += 16) {
+        __m128i chunk = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(content.data() + i)
+        );
+        unsigned mask = _mm_movemask_epi8(_mm_or_si128(
+            _mm_cmpeq_epi8(chunk, lf),
+            _mm_cmpeq_epi8(chunk, cr)
+        ));
+        while (mask) {
+            add_line_offset(content, i + __builtin_ctz(mask), line_offsets);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < content.size(); ++i) {
+        if (content[i] == '\n' || content[i] == '\r') {
+            add_line_offset(content, i, line_offsets);
+        }
+    }
+}
+
+} // namespace detail
+
 source_file::source_file(std::string name, std::string content) :
     name(std::move(name)), content_data(std::move(content))
 {
-    content = content_data;
+    size_t size = content_data.size();
+    content_data.append(padding, '\0');
+    this->content = source_view(content_data).substr(0, size);
+    padded_ = true;
+}
+
+source_file::source_file(
+    std::string name,
+    std::string content,
+    size_t first_offset,
+    size_t first_line
+) :
+    source_file(std::move(name), std::move(content))
+{
+    this->first_offset = first_offset;
+    this->first_line = first_line;
 }
 
 source_file::source_file(std::string name, std::string_view content) :
@@ -16,6 +102,118 @@ source_file::source_file(std::string name, const char* content) :
     name(std::move(name)), content(content)
 {}
 
+std::unique_ptr<source_file> source_file::map(const std::string& path) {
+    // `error` is the errno of the failed call, which is saved before any
+    // cleanup (which may change errno)
+    auto fail = [&path](int error, const char* what) {
+        throw std::system_error(
+            error, std::generic_category(), what + (" `" + path + "`")
+        );
+    };
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { fail(errno, "cannot open"); }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        fail(error, "cannot stat");
+    }
+    size_t size = size_t(info.st_size);
+
+    // Reserve enough (zero-filled) anonymous pages for the content and the
+    // padding, and then map the file over them. The rest of the last page of
+    // the file is zero-filled by the kernel, so the padding is always zeros.
+    size_t page_size = size_t(::sysconf(_SC_PAGESIZE));
+    size_t mapping_size = (size + padding + page_size - 1) / page_size
+                        * page_size;
+    void* mapping = ::mmap(
+        nullptr, mapping_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+    if (mapping == MAP_FAILED) {
+        int error = errno;
+        ::close(fd);
+        fail(error, "cannot map");
+    }
+    if (size > 0) {
+        void* file_mapping = ::mmap(
+            mapping, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0
+        );
+        if (file_mapping == MAP_FAILED) {
+            int error = errno;
+            ::munmap(mapping, mapping_size);
+            ::close(fd);
+            fail(error, "cannot map");
+        }
+    }
+    ::close(fd);
+
+    auto file = std::make_unique<source_file>(
+        path,
+        source_view(static_cast<const char*>(mapping), size)
+    );
+    file->mapping_ = mapping;
+    file->mapping_size_ = mapping_size;
+    file->padded_ = true;
+    return file;
+}
+
+std::unique_ptr<source_file> source_file::edit(const source_edit& e) const {
+    FP_ASSERT(
+        e.offset + e.removed <= content.size(),
+        "edit of [" << e.offset << ", " << e.offset + e.removed << ") is "
+        "outside of the content of " << name << " (" << content.size() << ")"
+    );
+    std::string edited;
+    edited.reserve(content.size() - e.removed + e.inserted.size() + padding);
+    edited += content.substr(0, e.offset);
+    edited += e.inserted;
+    edited += content.substr(e.offset + e.removed);
+    return std::make_unique<source_file>(name, std::move(edited));
+}
+
+source_file::~source_file() {
+    if (mapping_) { ::munmap(mapping_, mapping_size_); }
+}
+
+void source_file::set_origin(std::unique_ptr<const source_map> origin) {
+    origin_ = std::move(origin);
+}
+
+const std::vector<uint32_t>& source_file::line_offsets() const {
+    std::call_once(line_offsets_flag_, [this]() {
+        FP_ASSERT(
+            content.size() <= std::numeric_limits<uint32_t>::max(),
+            "line information is supported for source files of up to 4GB"
+        );
+        detail::scan_line_offsets(content, line_offsets_);
+    });
+    return line_offsets_;
+}
+
+size_t source_file::line_number(source_iterator it) const {
+    const std::vector<uint32_t>& offsets = line_offsets();
+    auto line_it = std::upper_bound(
+        offsets.begin(), offsets.end(), uint32_t(it - content.begin())
+    );
+    return first_line + (line_it - offsets.begin()) - 1;
+}
+
+source_iterator source_file::line_begin(size_t line_number) const {
+    return content.begin() + line_offsets()[line_number - first_line];
+}
+
+source_iterator source_file::line_end(size_t line_number) const {
+    const std::vector<uint32_t>& offsets = line_offsets();
+    size_t i = line_number - first_line;
+    if (i + 1 == offsets.size()) { return content.end(); }
+    source_iterator end = content.begin() + offsets[i + 1];
+    // exclude the line-break characters (`\n`, `\r` or `\r\n`)
+    if (*(end - 1) == '\n') { --end; }
+    if (end != line_begin(line_number) && *(end - 1) == '\r') { --end; }
+    return end;
+}
+
 source_location source_location::slice(source_iterator first) const {
     return slice(first, chars.end());
 }
@@ -25,19 +223,6 @@ source_location source_location::slice(
     source_iterator last
 ) const {
     source_location result = *this;
-    // find the beginning of the slice's line
-    for (auto it = chars.begin(); it < first; ++it) {
-        bool is_newline = false;
-        if (*it == '\n') { is_newline = true; }
-        if (*it == '\r') {
-            is_newline = true;
-            if (it + 1 < first && *it == '\n') { ++it; } // goddamn CRLF
-        }
-        if (is_newline) {
-            result.line = it + 1;
-            ++result.line_number;
-        }
-    }
     result.chars = source_view(first, last);
     return result;
 }
@@ -1,13 +1,32 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace fp {
 
+struct source_map;
+
 /// A reference to a section of input source code.
 using source_view = std::string_view;
 
+/// Iterator pointing to a character in a source code.
+using source_iterator = source_view::iterator;
+
+/**
+ * An edit of a piece of source code: `removed` characters starting at `offset`
+ * are replaced with the `inserted` text.
+ */
+struct source_edit {
+    size_t           offset;
+    size_t           removed;
+    std::string_view inserted;
+};
+
 /// A piece of source code that is given as an input to the compiler.
 struct source_file {
     /// The name of the source code (usually the name of the source file).
@@ -16,12 +35,119 @@ struct source_file {
     /// The contents of the source code.
     source_view content;
 
+    /// The offset of the content in the whole file (if it's a section of one).
+    size_t first_offset = 0;
+
+    /// The number of the first line of the content (see `first_offset`).
+    size_t first_line = 1;
+
+    /**
+     * The minimal number of readable bytes after the end of the content of
+     * padded source files (see source_file::padded). All of them are `\0`.
+     */
+    static constexpr size_t padding = 64;
+
     source_file(std::string name, std::string content);
     source_file(std::string name, std::string_view content);
     source_file(std::string name, const char* content);
 
+    /**
+     * Constructs a section of a larger source file (e.g. the source code that
+     * a piece of lex::piecewise_tokens refers to): its whole lines `content`,
+     * which begin at offset `first_offset` and on line number `first_line`.
+     *
+     * Offsets and line numbers of source locations in the section (see
+     * fp::source_location) are those of the whole file.
+     */
+    source_file(
+        std::string name,
+        std::string content,
+        size_t first_offset,
+        size_t first_line
+    );
+
+    /**
+     * Memory-maps the file at `path` (read-only), and returns a source_file
+     * whose content is a view over the mapping. The file is not copied, and
+     * the mapping is kept alive for as long as the source_file.
+     *
+     * The returned source_file is padded (see source_file::padded).
+     *
+     * The file must not be modified or truncated while it's mapped.
+     *
+     * @throws std::system_error
+     *     When the file cannot be opened or mapped.
+     */
+    static std::unique_ptr<source_file> map(const std::string& path);
+
+    ~source_file();
+
+    /**
+     * Returns a new source file (with the same name) whose content is the
+     * content of this file after applying the given edit.
+     *
+     * The origin (see source_file::origin) is not carried over to the new file,
+     * as its offsets no longer match.
+     */
+    std::unique_ptr<source_file> edit(const source_edit&) const;
+
+    // source locations refer to their source file, so it must stay in place
+    source_file(const source_file&) = delete;
+    source_file& operator=(const source_file&) = delete;
+
     bool operator==(const source_file& other) const { return this == &other; }
 
+    /**
+     * Returns `true` if at least source_file::padding `\0` bytes can be read
+     * right after the end of the content, e.g. when scanning it a whole vector
+     * register at a time.
+     *
+     * Source files that own their content (either a `std::string` or a
+     * mapping) are always padded, while views given as a `std::string_view`
+     * or a `const char*` are not.
+     */
+    bool padded() const { return padded_; }
+
+    /**
+     * Returns the mapping of the content of this (generated) file back to the
+     * files it was generated from, or `nullptr` if it wasn't generated (see
+     * fp::source_map).
+     */
+    const source_map* origin() const { return origin_.get(); }
+
+    /// Sets the mapping returned by source_file::origin.
+    void set_origin(std::unique_ptr<const source_map>);
+
+    /**
+     * Returns the offsets of the beginning of each line in the source code, in
+     * ascending order. The first line always begins at offset 0 (even in a
+     * section of a larger file, whose offsets are relative to its content).
+     *
+     * A new line begins after a line-feed (`\n`), a carriage-return (`\r`), or
+     * a CRLF combination (`\r\n`).
+     *
+     * The offsets table is built (only once) the first time it is needed. It is
+     * safe to call this function concurrently from multiple threads.
+     */
+    const std::vector<uint32_t>& line_offsets() const;
+
+    /**
+     * Returns the number (1-based) of the line that contains the character
+     * pointed to by the given iterator.
+     *
+     * Complexity is O(log n) in the number of lines.
+     */
+    size_t line_number(source_iterator) const;
+
+    /// Returns an iterator to the beginning of line number `line_number`.
+    source_iterator line_begin(size_t line_number) const;
+
+    /**
+     * Returns an iterator to the end of line number `line_number`, excluding
+     * its line-break characters.
+     */
+    source_iterator line_end(size_t line_number) const;
+
 private:
     /**
      * Used only when owning the data, in which case source_code::contents is
@@ -29,10 +155,19 @@ private:
      * source_code::content points to a string that someone else owns.
      */
     std::string content_data;
-};
 
-/// Iterator pointing to a character in a source code.
-using source_iterator = source_view::iterator;
+    /// The memory-mapped region of source_file::map, if any.
+    void*  mapping_      = nullptr;
+    size_t mapping_size_ = 0;
+
+    bool padded_ = false;
+
+    std::unique_ptr<const source_map> origin_;
+
+    /// See source_file::line_offsets().
+    mutable std::vector<uint32_t> line_offsets_;
+    mutable std::once_flag        line_offsets_flag_;
+};
 
 /// Returns a merged source code section. `first` must appear before `second`.
 constexpr source_view merge(source_view first, source_view second) {
@@ -42,6 +177,11 @@ constexpr source_view merge(source_view first, source_view second) {
 /**
  * Information about a location in a piece of source code. Each compiler element
  * will hold an instance of this to keep track of its origin in the source code.
+ *
+ * Only the range of characters is stored, which is effectively a pair of
+ * offsets into the source file. Line information is resolved on demand (using
+ * the line offsets table of the source file), which is typically only needed
+ * when printing diagnostics.
  */
 struct source_location {
     /// The range of characters that make up the element.
@@ -50,11 +190,19 @@ struct source_location {
     /// The relevant source code file.
     const source_file& file;
 
-    /// Iterator to the beginning of the location's line.
-    source_iterator line;
+    /// The offset of the location's first character relative to `file`.
+    size_t offset() const {
+        return file.first_offset + (chars.begin() - file.content.begin());
+    }
+
+    /// Returns an iterator to the beginning of the location's (first) line.
+    source_iterator line() const { return file.line_begin(line_number()); }
+
+    /// Returns the line number of the location relative to `file`.
+    size_t line_number() const { return file.line_number(chars.begin()); }
 
-    /// The line number of the location relative to `file`.
-    size_t line_number;
+    /// Returns the column (0-based) of the location within its first line.
+    size_t column() const { return chars.begin() - line(); }
 
     //@{
     /**
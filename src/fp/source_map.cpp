@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <limits>
+
+#include <fp/util/assert.h>
+
+#include "source_map.h"
+
+namespace fp {
+
+void source_map::add(
+    size_t generated_offset,
+    size_t size,
+    const source_file& original,
+    size_t original_offset
+) {
+    FP_ASSERT(
+        original_offset + size <= original.content.size(),
+        "source map segment [" << original_offset << ", "
+        << original_offset + size << ") is outside of the content of "
+        << original.name << " (" << original.content.size() << ")"
+    );
+    FP_ASSERT(
+        generated_offset + size <= std::numeric_limits<uint32_t>::max(),
+        "source maps are supported for generated files of up to 4GB"
+    );
+    if (size == 0) { return; }
+
+    uint32_t file = file_index(original);
+    if (!segments_.empty()) {
+        segment& last = segments_.back();
+        FP_ASSERT(
+            generated_offset >= last.generated_offset + last.size,
+            "source map segment at " << generated_offset << " overlaps or "
+            "precedes the previous segment"
+        );
+        bool continues_last =
+            last.file_index == file &&
+            last.generated_offset + last.size == generated_offset &&
+            last.original_offset + last.size == original_offset;
+        if (continues_last) {
+            last.size += uint32_t(size);
+            return;
+        }
+    }
+    segments_.push_back(segment {
+        .generated_offset = uint32_t(generated_offset),
+        .size             = uint32_t(size),
+        .original_offset  = uint32_t(original_offset),
+        .file_index       = file
+    });
+}
+
+std::optional<source_location> source_map::to_original(
+    const source_location& location
+) const {
+    size_t begin = location.offset();
+    auto it = std::upper_bound(
+        segments_.begin(), segments_.end(), begin,
+        [](size_t offset, const segment& s) {
+            return offset < s.generated_offset;
+        }
+    );
+    if (it == segments_.begin()) { return std::nullopt; }
+    const segment& s = *(it - 1);
+
+    // an empty location may point right after the end of its segment (e.g.
+    // at the end of the generated file)
+    size_t segment_end = s.generated_offset + s.size;
+    bool is_empty = location.chars.empty();
+    if (begin > segment_end || (begin == segment_end && !is_empty)) {
+        return std::nullopt;
+    }
+    size_t end = std::min(begin + location.chars.size(), segment_end);
+
+    const source_file& original = *files_[s.file_index];
+    return source_location {
+        .chars = original.content.substr(
+            s.original_offset + (begin - s.generated_offset),
+            end - begin
+        ),
+        .file = original
+    };
+}
+
+uint32_t source_map::file_index(const source_file& file) {
+    // consecutive segments usually come from the same file
+    if (!segments_.empty()) {
+        uint32_t last = segments_.back().file_index;
+        if (files_[last] == &file) { return last; }
+    }
+    auto it = std::find(files_.begin(), files_.end(), &file);
+    if (it == files_.end()) {
+        files_.push_back(&file);
+        return uint32_t(files_.size() - 1);
+    }
+    return uint32_t(it - files_.begin());
+}
+
+} // namespace fp
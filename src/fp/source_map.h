@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <fp/source_code.h>
+
+namespace fp {
+
+/**
+ * Maps the content of a generated source_file (e.g. code expanded from a
+ * template) back to the original source files it was generated from, so that
+ * diagnostics can point at the original code.
+ *
+ * The mapping is stored as a sorted list of run-length segments, each mapping
+ * a range of generated offsets to a range (of the same size) of offsets in
+ * one original file. Generated characters outside of all segments (e.g. code
+ * that was synthesized from nothing) have no original location.
+ *
+ * ~~~{.cpp}
+ * auto map = std::make_unique<source_map>();
+ * map->add(0, 12, template_file, 40); // generated [0, 12) is [40, 52)
+ * generated_file.set_origin(std::move(map));
+ * ~~~
+ *
+ * The original source files must outlive the source map.
+ */
+struct source_map {
+    /**
+     * Maps the `size` generated characters starting at `generated_offset` to
+     * the characters of `original` starting at `original_offset`.
+     *
+     * Segments must be added in ascending order of their generated offsets,
+     * and must not overlap. A segment that continues the previous one (in
+     * both the generated and the original file) is merged into it, so mapping
+     * character by character is as compact as mapping whole ranges.
+     */
+    void add(
+        size_t generated_offset,
+        size_t size,
+        const source_file& original,
+        size_t original_offset
+    );
+
+    /**
+     * Returns the original location of the given location in the generated
+     * file, or `std::nullopt` if its first character has no original location.
+     *
+     * Locations that continue past the end of the segment of their first
+     * character are truncated at its end.
+     *
+     * Complexity is O(log n) in the number of segments.
+     */
+    std::optional<source_location> to_original(const source_location&) const;
+
+    /// Returns the number of (merged) segments.
+    size_t size() const { return segments_.size(); }
+
+private:
+    struct segment {
+        uint32_t generated_offset;
+        uint32_t size;
+        uint32_t original_offset;
+        uint32_t file_index;
+    };
+
+    std::vector<segment>            segments_;
+    std::vector<const source_file*> files_;
+
+    uint32_t file_index(const source_file&);
+};
+
+} // namespace fp
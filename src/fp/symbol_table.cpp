@@ -0,0 +1,75 @@
+#include <bit>
+#include <mutex>
+#include <utility>
+
+#include <fp/util/assert.h>
+
+#include "symbol_table.h"
+
+namespace fp {
+
+std::ostream& operator<<(std::ostream& os, symbol_id id) {
+    return os << "symbol#" << id.index;
+}
+
+symbol_table::~symbol_table() {
+    for (std::atomic<std::string_view*>& segment : segments) {
+        delete[] segment.load(std::memory_order_relaxed);
+    }
+}
+
+/// Returns the segment of `index` and the index in it (see segments).
+static std::pair<size_t, size_t> segment_of(uint32_t index) {
+    size_t segment = std::bit_width(uint64_t(index) + 1) - 1;
+    return {segment, index + 1 - (size_t(1) << segment)};
+}
+
+symbol_id symbol_table::intern(std::string_view str) {
+    key k{str, std::hash<std::string_view>()(str)};
+    shard& shard = shards[k.hash % n_shards];
+
+    // most strings were already interned, which only requires a shared lock
+    {
+        std::shared_lock lock(shard.mutex);
+        if (auto it = shard.ids.find(k); it != shard.ids.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock lock(shard.mutex);
+    // (the string may have been interned since the shared lock was released)
+    if (auto it = shard.ids.find(k); it != shard.ids.end()) {
+        return it->second;
+    }
+    symbol_id id{size_.fetch_add(1, std::memory_order_relaxed)};
+    FP_ASSERT(id.index != UINT32_MAX, "too many symbols");
+    const std::string& interned = shard.strings.emplace_back(str);
+    shard.ids.emplace(key{interned, k.hash}, id);
+
+    // the string is published before the ID is returned (or found by others
+    // through the shard), so looking it up by the ID needs no lock
+    auto [s, i] = segment_of(id.index);
+    std::string_view* segment = segments[s].load(std::memory_order_acquire);
+    if (segment == nullptr) {
+        auto* allocated = new std::string_view[size_t(1) << s];
+        if (segments[s].compare_exchange_strong(
+            segment, allocated, std::memory_order_acq_rel
+        )) {
+            segment = allocated;
+        } else {
+            delete[] allocated;
+        }
+    }
+    segment[i] = interned;
+    return id;
+}
+
+std::string_view symbol_table::operator[](symbol_id id) const {
+    FP_ASSERT(
+        id.index < size(),
+        "symbol_id " << id.index << " is not in the table"
+    );
+    auto [s, i] = segment_of(id.index);
+    return segments[s].load(std::memory_order_acquire)[i];
+}
+
+} // namespace fp
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <compare>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace fp {
+
+/**
+ * Identifies a string that was interned in an fp::symbol_table.
+ *
+ * Symbol IDs are dense: the strings of a table are numbered from 0, in the
+ * order in which they were first interned. Two IDs from the same table are
+ * equal iff their strings are equal.
+ */
+struct symbol_id {
+    uint32_t index;
+
+    auto operator<=>(const symbol_id&) const = default;
+};
+
+std::ostream& operator<<(std::ostream&, symbol_id);
+
+/**
+ * Interns strings (e.g. identifiers and string literals), so that each
+ * distinct string is stored once, and identified by an fp::symbol_id.
+ *
+ * A symbol table is thread-safe: strings can be interned and looked up
+ * concurrently (e.g. while tokenizing multiple files in parallel). Strings are
+ * split into shards by their hash, each with its own lock, so concurrent
+ * interning only contends on strings of the same shard, and looking up the
+ * string of an ID takes no lock at all.
+ *
+ * There's no global table: the owner of the tokens (e.g. a driver::run of a
+ * set of files) owns the table too, so its strings are freed along with them.
+ */
+struct symbol_table {
+    symbol_table() = default;
+    ~symbol_table();
+
+    symbol_table(const symbol_table&) = delete;
+    symbol_table& operator=(const symbol_table&) = delete;
+
+    /**
+     * Returns the ID of the given string, adding it to the table if it wasn't
+     * interned before.
+     */
+    symbol_id intern(std::string_view);
+
+    /**
+     * Returns the string of the given ID (which must have been returned by
+     * this table). The returned view is valid for as long as the table exists.
+     */
+    std::string_view operator[](symbol_id) const;
+
+    /// The number of distinct strings in the table.
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+private:
+    /// A string, along with its hash (which is only computed once).
+    struct key {
+        std::string_view str;
+        size_t           hash;
+
+        bool operator==(const key& other) const { return str == other.str; }
+    };
+
+    struct key_hash {
+        size_t operator()(const key& k) const { return k.hash; }
+    };
+
+    /// The strings whose hash selects this shard (see symbol_table::intern).
+    struct alignas(64) shard {
+        mutable std::shared_mutex mutex;
+
+        /// The interned strings (a deque never moves them).
+        std::deque<std::string> strings;
+
+        /// Maps each interned string (viewing `strings`) to its ID.
+        std::unordered_map<key, symbol_id, key_hash> ids;
+    };
+
+    static constexpr size_t n_shards = 32;
+    std::array<shard, n_shards> shards;
+
+    /**
+     * The strings of the IDs, in segments that are never moved: segment `k`
+     * holds the strings of the 2^k IDs that begin at 2^k - 1. Segments are
+     * allocated by the first string that needs them.
+     */
+    static constexpr size_t n_segments = 32;
+    std::array<std::atomic<std::string_view*>, n_segments> segments = {};
+
+    /// The number of IDs given so far.
+    std::atomic<uint32_t> size_ = 0;
+};
+
+} // namespace fp
+
+template <>
+struct std::hash<fp::symbol_id> {
+    size_t operator()(fp::symbol_id id) const noexcept { return id.index; }
+};
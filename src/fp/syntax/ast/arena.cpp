@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <iterator>
+
+#include "arena.h"
+
+namespace fp::syntax::ast {
+
+namespace detail {
+
+constexpr size_t min_chunk_size = 4 * 1024;
+constexpr size_t max_chunk_size = 1024 * 1024;
+
+} // namespace detail
+
+void* arena::allocate_in_new_chunk(size_t size, size_t alignment) {
+    // each chunk is at least as large as all previous chunks combined (up to
+    // a maximal size), or large enough for this allocation
+    size_t chunk_size = std::max(
+        std::clamp(
+            total_capacity,
+            detail::min_chunk_size,
+            detail::max_chunk_size
+        ),
+        size
+    );
+    chunks.push_back(std::make_unique_for_overwrite<std::byte[]>(chunk_size));
+    used = 0;
+    capacity = chunk_size;
+    total_capacity += chunk_size;
+    return allocate(size, alignment);
+}
+
+void arena::adopt(arena&& other) {
+    owned.insert(
+        owned.end(),
+        std::make_move_iterator(other.owned.begin()),
+        std::make_move_iterator(other.owned.end())
+    );
+    if (chunks.empty()) {
+        chunks = std::move(other.chunks);
+        used = other.used;
+        capacity = other.capacity;
+        total_capacity = other.total_capacity;
+    } else {
+        // the last chunk is kept last, since allocations continue in it
+        chunks.insert(
+            chunks.end() - 1,
+            std::make_move_iterator(other.chunks.begin()),
+            std::make_move_iterator(other.chunks.end())
+        );
+        total_capacity += other.total_capacity;
+    }
+    other = arena();
+}
+
+} // namespace fp::syntax::ast
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fp/util/assert.h>
+
+namespace fp::syntax::ast {
+
+/**
+ * Owns the memory of all the AST nodes produced by a syntax::parse.
+ *
+ * Memory is bump-allocated from a list of chunks, whose sizes grow
+ * geometrically. Only trivially-destructible objects can be allocated in an
+ * arena, since their destructors are never called: destroying an arena only
+ * releases its (few) chunks, regardless of the number of nodes in it.
+ *
+ * All the objects allocated in an arena are valid for as long as the arena
+ * exists (even if the arena is moved).
+ */
+struct arena {
+    arena() = default;
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    arena(arena&&) = default;
+    arena& operator=(arena&&) = default;
+
+    /// Constructs a `T` from the given arguments in the arena.
+    template <class T, class... Args>
+    T* make(Args&&... args) {
+        static_assert(
+            std::is_trivially_destructible_v<T>,
+            "the destructors of objects in an arena are never called"
+        );
+        return new (allocate(sizeof(T), alignof(T)))
+            T(std::forward<Args>(args)...);
+    }
+
+    /// Copies the given objects into the arena, and returns a view of them.
+    template <class T>
+    std::span<const T> copy(std::span<const T> objects) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (objects.empty()) { return {}; }
+        void* data = allocate(objects.size_bytes(), alignof(T));
+        std::uninitialized_copy(
+            objects.begin(), objects.end(), static_cast<T*>(data)
+        );
+        return {static_cast<const T*>(data), objects.size()};
+    }
+
+    /**
+     * Allocates `size` bytes aligned to `alignment`, which must be a power of
+     * 2 that is not larger than `__STDCPP_DEFAULT_NEW_ALIGNMENT__` (chunks are
+     * aligned to it, and offsets within them are aligned to `alignment`).
+     */
+    void* allocate(size_t size, size_t alignment) {
+        FP_ASSERT(
+            alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+            "over-aligned allocations are not supported by ast::arena"
+        );
+        size_t offset = (used + alignment - 1) & ~(alignment - 1);
+        if (offset + size > capacity) {
+            return allocate_in_new_chunk(size, alignment);
+        }
+        used = offset + size;
+        return chunks.back().get() + offset;
+    }
+
+    /**
+     * Keeps the given object alive for as long as the arena exists (unlike the
+     * objects allocated in the arena, it may have a destructor, e.g. if it
+     * owns memory outside of the arena). Returns the object.
+     */
+    template <class T>
+    T* keep(std::unique_ptr<T> object) {
+        T* kept = object.get();
+        owned.push_back(std::move(object));
+        return kept;
+    }
+
+    /**
+     * Takes the ownership of all the objects allocated in `other`, which
+     * remain valid for as long as this arena exists. `other` becomes empty.
+     */
+    void adopt(arena&& other);
+
+    /// Returns the total size (in bytes) of all chunks.
+    size_t allocated_bytes() const { return total_capacity; }
+
+private:
+    void* allocate_in_new_chunk(size_t size, size_t alignment);
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+
+    /// The objects kept alive by the arena (see arena::keep).
+    std::vector<std::shared_ptr<void>> owned;
+
+    /// Number of bytes used in the last chunk.
+    size_t used = 0;
+
+    /// Size of the last chunk.
+    size_t capacity = 0;
+
+    /// Sum of the sizes of all chunks.
+    size_t total_capacity = 0;
+};
+
+} // namespace fp::syntax::ast
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <fp/lex/tokenized_list.h>
-#include <fp/syntax/ast/node.h>
 
 namespace fp::syntax::ast::detail {
 
@@ -21,24 +20,12 @@ struct base_node {
 
     lex::tokenized_view tokens() const { return tokens_; }
 
-    const fp::source_location& source_location() const {
-        if (!source_location_) {
-            source_location_.emplace(get_source_location(tokens_));
-        }
-        return *source_location_;
-    }
-
-    operator node() const& {
-        return node::make(std::move(static_cast<const Derived&>(*this)));
-    }
-
-    operator node() && {
-        return node::make(std::move(static_cast<Derived&&>(*this)));
+    fp::source_location source_location() const {
+        return get_source_location(tokens_);
     }
 
 private:
     lex::tokenized_view tokens_;
-    mutable std::optional<fp::source_location> source_location_;
 };
 
 } // namespace fp::syntax::ast::detail
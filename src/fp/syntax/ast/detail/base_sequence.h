@@ -1,6 +1,6 @@
 #pragma once
 
-#include <vector>
+#include <span>
 
 #include <fp/util/assert.h>
 #include <fp/syntax/ast/detail/base_node.h>
@@ -17,11 +17,12 @@ namespace fp::syntax::ast::detail {
  */
 template <class Derived>
 struct base_sequence : public detail::base_node<Derived> {
-    /// The `ast::node`s that make up the sequence.
-    std::vector<node> nodes;
+    /// The `ast::node`s that make up the sequence (stored in the ast::arena).
+    std::span<const node> nodes;
 
     /**
-     * The separator tokens that appear between the sequence's `nodes`.
+     * The separator tokens that appear between the sequence's `nodes` (stored
+     * in the ast::arena).
      *
      * `separators[i]` is the `i`-th separating token, which appears right after
      * the `i`-th node (`nodes[i]`).
@@ -31,17 +32,17 @@ struct base_sequence : public detail::base_node<Derived> {
      * separators.size() == nodes.size() - 1
      * ~~~
      */
-    std::vector<lex::token_iterator> separators;
+    std::span<const lex::token_iterator> separators;
 
     base_sequence(
         lex::token_iterator from,
         lex::token_iterator to,
-        std::vector<node> nodes,
-        std::vector<lex::token_iterator> separators
+        std::span<const node> nodes,
+        std::span<const lex::token_iterator> separators
     ) :
         detail::base_node<Derived>(from, to),
-        nodes(std::move(nodes)),
-        separators(std::move(separators))
+        nodes(nodes),
+        separators(separators)
     {
         FP_ASSERT(
             !separators.empty(),
@@ -16,6 +16,7 @@ namespace fp::syntax::ast {
 struct binary_op;
 struct block;
 struct char_;
+struct deferred_block;
 struct empty;
 struct error;
 struct identifier;
@@ -34,6 +35,7 @@ using variant_node = std::variant<
     binary_op,
     block,
     char_,
+    deferred_block,
     empty,
     error,
     identifier,
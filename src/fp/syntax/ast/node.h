@@ -1,10 +1,11 @@
 #pragma once
 
 #include <variant>
-#include <memory>
+#include <utility>
 
 #include <fp/util/overloaded.h>
 #include <fp/lex/tokenized_list.h>
+#include <fp/syntax/ast/arena.h>
 #include <fp/syntax/ast/detail/variant_node.h>
 
 namespace fp::syntax::ast {
@@ -13,12 +14,24 @@ namespace fp::syntax::ast {
  * Represents an AST node.
  *
  * An AST can be produced from by calling syntax::parse.
+ *
+ * An ast::node is a (cheap to copy) reference to a node that lives in an
+ * ast::arena, which owns the whole AST.
  */
 struct node {
-    template <class NodeType>
-    static node make(NodeType&& n) {
-        return node(std::make_unique<detail::variant_node>(
-            std::forward<NodeType>(n)
+    /**
+     * Constructs a node of type `NodeType` (e.g. ast::identifier) in the given
+     * arena from the given arguments.
+     */
+    template <
+        class NodeType,
+        class... Args,
+        class Variant = detail::variant_node // delays type completeness
+    >
+    static node make(ast::arena& arena, Args&&... args) {
+        return node(arena.make<Variant>(
+            std::in_place_type<NodeType>,
+            std::forward<Args>(args)...
         ));
     }
 
@@ -26,7 +39,10 @@ struct node {
     lex::tokenized_view tokens() const;
 
     /// Returns the location of this node in the source code.
-    const fp::source_location& source_location() const;
+    fp::source_location source_location() const;
+
+    /// Returns true if both refer to the same node (rather than equal nodes).
+    bool operator==(const node& other) const = default;
 
     /// Returns true if this node is of the given type (e.g. ast::identifier).
     template <class NodeType>
@@ -77,9 +93,11 @@ struct node {
     //@}
 
 private:
-    std::unique_ptr<detail::variant_node> variant_node;
+    const detail::variant_node* variant_node;
 
-    explicit node(std::unique_ptr<detail::variant_node>);
+    explicit node(const detail::variant_node* variant_node) :
+        variant_node(variant_node)
+    {}
 
     // delays evaluation of the incomplete type detail::variant_node
     template <class N = node>
@@ -95,6 +113,7 @@ private:
 #include <fp/syntax/ast/types/binary_op.inl>
 #include <fp/syntax/ast/types/block.inl>
 #include <fp/syntax/ast/types/char.inl>
+#include <fp/syntax/ast/types/deferred_block.inl>
 #include <fp/syntax/ast/types/empty.inl>
 #include <fp/syntax/ast/types/error.inl>
 #include <fp/syntax/ast/types/identifier.inl>
@@ -110,3 +129,8 @@ static_assert(
     sizeof(fp::syntax::ast::detail::variant_node) > 0,
     "The definition of the variant must be complete (include all node types)"
 );
+
+static_assert(
+    std::is_trivially_destructible_v<fp::syntax::ast::detail::variant_node>,
+    "AST nodes are allocated in an ast::arena, which never destroys them"
+);
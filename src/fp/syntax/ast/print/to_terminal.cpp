@@ -36,6 +36,11 @@ struct Visitor {
         print_node_line(char_, green, char_.source_location().chars);
     }
 
+    void print(const ast::deferred_block& block) {
+        // printing doesn't parse the contents
+        print_node_line(block, default_color, "{ ... }");
+    }
+
     void print(const ast::empty& error) {
         os << default_color << "ast::empty";
     }
@@ -168,7 +173,7 @@ private:
         if constexpr (sizeof...(children) > 0) { print_children(children...); }
     }
 
-    void print_children_range(const std::vector<ast::node>& children) {
+    void print_children_range(std::span<const ast::node> children) {
         for (const auto& child : children) {
             FP_WITH(
                 child_contexts =
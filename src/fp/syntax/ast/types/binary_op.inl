@@ -18,6 +18,8 @@ struct binary_op : public detail::base_node<binary_op> {
 
     lex::token op() const { return op_token_it->token; }
 
+    lex::token_iterator op_token() const { return op_token_it; }
+
     const fp::source_location& op_source_location() const {
         return op_token_it->source_location;
     }
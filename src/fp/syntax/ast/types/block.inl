@@ -19,15 +19,12 @@ struct block : public detail::base_sequence<block> {
     block(
         lex::token_iterator opening_brace,
         lex::token_iterator closing_brace,
-        std::vector<node> nodes,
-        std::vector<lex::token_iterator> separators
+        std::span<const node> nodes,
+        std::span<const lex::token_iterator> separators
     ) :
-        base_sequence(
-            opening_brace,
-            closing_brace + 1,
-            std::move(nodes),
-            std::move(separators)
-        )
+        base_sequence(opening_brace, closing_brace + 1, nodes, separators),
+        opening_brace(opening_brace),
+        closing_brace(closing_brace)
     {}
 };
 
@@ -10,7 +10,10 @@ struct char_ : detail::base_node<char_> {
 
     explicit char_(lex::token_iterator token_it) :
         base_node(token_it, token_it + 1),
-        value(token_it->get_attribute<lex::token::CHAR>())
+        // dummy tokens (of invalid character literals) have no value
+        value(token_it->dummy
+            ? char_t(0)
+            : token_it->get_attribute<lex::token::CHAR>())
     {}
 };
 
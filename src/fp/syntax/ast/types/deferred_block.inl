@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+
+#include <fp/syntax/ast/detail/base_node.h>
+#include <fp/syntax/ast/node.h>
+
+namespace fp::syntax::detail {
+
+struct deferred_parser;
+
+/// Parses the contents of the given block (see ast::deferred_block::parse).
+ast::node parse_deferred(const ast::deferred_block&);
+
+} // namespace fp::syntax::detail
+
+namespace fp::syntax::ast {
+
+/**
+ * A block whose contents are not parsed yet, which replaces ast::block when
+ * only the outline of the source code is parsed (see
+ * syntax::parsing_options::outline).
+ *
+ * The contents are parsed on the first call to deferred_block::parse, which
+ * returns the node that the whole block is parsed into (usually an ast::block,
+ * whose own blocks are deferred again). It may be called from multiple threads
+ * at once. Its nodes are allocated in the ast::arena of the outline, and its
+ * problems are reported to the diagnostic::report of the outline, which both
+ * must still exist.
+ */
+struct deferred_block : public detail::base_node<deferred_block> {
+    lex::token_iterator opening_brace;
+    lex::token_iterator closing_brace;
+
+    /// The number of operands that the block is nested in.
+    size_t nesting_depth;
+
+    deferred_block(
+        lex::token_iterator opening_brace,
+        lex::token_iterator closing_brace,
+        size_t nesting_depth,
+        syntax::detail::deferred_parser& parser
+    ) :
+        base_node(opening_brace, closing_brace + 1),
+        opening_brace(opening_brace),
+        closing_brace(closing_brace),
+        nesting_depth(nesting_depth),
+        parser(&parser)
+    {}
+
+    /// Returns the tokens between the braces.
+    lex::tokenized_view contents() const {
+        return lex::tokenized_view(opening_brace + 1, closing_brace);
+    }
+
+    /// Returns the parsed block, which is parsed on the first call.
+    node parse() const {
+        // the acquire pairs with the release of detail::parse_deferred, which
+        // publishes the parsed nodes
+        const node* parsed_node = parsed.load(std::memory_order_acquire);
+        if (parsed_node) { return *parsed_node; }
+        return syntax::detail::parse_deferred(*this);
+    }
+
+private:
+    friend ast::node syntax::detail::parse_deferred(const deferred_block&);
+
+    syntax::detail::deferred_parser* parser;
+
+    /// The parsed block (in the arena of the outline), once it's parsed.
+    mutable std::atomic<const node*> parsed = nullptr;
+};
+
+} // namespace fp::syntax::ast
@@ -5,11 +5,16 @@
 namespace fp::syntax::ast {
 
 struct identifier : detail::base_node<identifier> {
+    /// The identifier's characters in the source code.
     source_view chars;
 
+    /// The interned identifier (see fp::symbol_table).
+    symbol_id symbol;
+
     identifier(lex::token_iterator token_it) :
         base_node(token_it, token_it + 1),
-        chars(token_it->get_attribute<lex::token::IDENTIFIER>())
+        chars(token_it->source_location.chars),
+        symbol(token_it->get_attribute<lex::token::IDENTIFIER>())
     {}
 };
 
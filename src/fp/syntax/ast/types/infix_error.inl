@@ -8,6 +8,9 @@ namespace fp::syntax::ast {
 /**
  * Represents a syntax error that is caused when encountering a token that is
  * not a valid infix (or postfix) operator.
+ *
+ * Its tokens also include the tokens that were skipped after the invalid token
+ * to recover from the error (up to `end`).
  */
 struct infix_error : detail::base_node<infix_error> {
     /// The AST node which was supposed to be the infix operator's "LHS".
@@ -16,11 +19,19 @@ struct infix_error : detail::base_node<infix_error> {
     /// The invalid infix token.
     const lex::tokenized_token& invalid_infix_token;
 
-    infix_error(ast::node lhs, lex::token_iterator invalid_infix_token) :
-        base_node(lhs.tokens().begin(), invalid_infix_token + 1),
+    infix_error(
+        ast::node lhs,
+        lex::token_iterator invalid_infix_token,
+        lex::token_iterator end
+    ) :
+        base_node(lhs.tokens().begin(), end),
         lhs(std::move(lhs)),
         invalid_infix_token(*invalid_infix_token)
     {}
+
+    infix_error(ast::node lhs, lex::token_iterator invalid_infix_token) :
+        infix_error(lhs, invalid_infix_token, invalid_infix_token + 1)
+    {}
 };
 
 } // namespace fp::syntax::ast
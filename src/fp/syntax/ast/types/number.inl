@@ -5,11 +5,16 @@
 namespace fp::syntax::ast {
 
 struct number : detail::base_node<number> {
+    /// The number's characters in the source code.
     source_view chars;
 
+    /// The value of the number (owned by its token).
+    const number_t& value;
+
     explicit number(lex::token_iterator token_it) :
         base_node(token_it, token_it + 1),
-        chars(token_it->get_attribute<lex::token::NUMBER>())
+        chars(token_it->source_location.chars),
+        value(token_it->get_attribute<lex::token::NUMBER>())
     {}
 };
 
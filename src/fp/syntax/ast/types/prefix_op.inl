@@ -16,6 +16,8 @@ struct prefix_op : public detail::base_node<prefix_op> {
 
     lex::token op() const { return op_token_it->token; }
 
+    lex::token_iterator op_token() const { return op_token_it; }
+
     const fp::source_location& op_source_location() const {
         return op_token_it->source_location;
     }
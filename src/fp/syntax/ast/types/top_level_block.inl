@@ -15,14 +15,14 @@ namespace fp::syntax::ast {
  */
 struct top_level_block : public detail::base_sequence<top_level_block> {
     top_level_block(
-        std::vector<node> nodes,
-        std::vector<lex::token_iterator> separators
+        std::span<const node> nodes,
+        std::span<const lex::token_iterator> separators
     ) :
         base_sequence(
             nodes.front().tokens().begin(),
             nodes.back().tokens().end(),
-            std::move(nodes),
-            std::move(separators)
+            nodes,
+            separators
         )
     {}
 };
@@ -3,21 +3,26 @@
 #include <fp/syntax/detail/parsing_state.h>
 #include <fp/syntax/detail/token_table_t.h>
 #include <fp/syntax/detail/parse_prefix.h>
+#include <fp/syntax/detail/recovery.h>
 #include <fp/syntax/detail/parsers/binary_op.h>
 #include <fp/syntax/detail/parsers/postfix_op.h>
 #include <fp/syntax/detail/parsers/sequence.h>
 
 namespace fp::syntax::detail {
 
+/**
+ * Parses the next token as an infix (or postfix) operator of `lhs`, and returns
+ * its node, or parsing_state::suspended if the parser is suspended until its
+ * operand is parsed (see parsing_state::parse_operands).
+ */
 using infix_parser_t = ast::node (*)(parsing_state&, ast::node lhs);
 
-/// Parses the next token as an ast::infix_error.
+/**
+ * Parses the next token as an ast::infix_error, which also skips the tokens
+ * after it up to the next synchronization point (see detail::skip_unexpected).
+ */
 inline ast::node parse_infix_error(parsing_state& s, ast::node lhs) {
-    s.report_error("unexpected token")
-        .add_primary(s.next->source_location)
-        .add_contextual(lhs.source_location());
-    ++s.next;
-    return ast::infix_error(std::move(lhs), s.next - 1);
+    return skip_unexpected(s, lhs);
 }
 
 constexpr auto infix_parser_table = token_table_t<infix_parser_t>([](auto& t) {
@@ -65,13 +70,10 @@ constexpr auto infix_parser_table = token_table_t<infix_parser_t>([](auto& t) {
     t[lex::token::OPTIONAL] = parse_postfix_op;
     t[lex::token::INC]      = parse_postfix_op;
     t[lex::token::DEC]      = parse_postfix_op;
-
-//    // error
-//    t[lex::token::ERROR] = infix_parser_skip_error;
 });
 
 inline ast::node parse_infix(parsing_state& s, ast::node lhs) {
-    return infix_parser_table[s.next->token](s, std::move(lhs));
+    return infix_parser_table[s.next->token](s, lhs);
 }
 
 } // namespace fp::syntax::detail
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fp/syntax/detail/parsing_state.h>
+#include <fp/syntax/detail/recovery.h>
 #include <fp/syntax/detail/token_table_t.h>
 #include <fp/syntax/detail/parsers/brackets.h>
 #include <fp/syntax/detail/parsers/if.h>
@@ -9,12 +10,38 @@
 
 namespace fp::syntax::detail {
 
+/**
+ * Parses the prefix of the next operand, and returns its node, or
+ * parsing_state::suspended if the parser is suspended until its own operand is
+ * parsed (see parsing_state::parse_operands).
+ */
 using prefix_parser_t = ast::node (*)(parsing_state&);
 
+/**
+ * Parses a token that cannot begin an operand. If it's a synchronization point
+ * (see detail::is_sync_point), the operand is missing, and is parsed as an
+ * ast::empty. Otherwise, the token is skipped along with the rest of the
+ * tokens up to the next synchronization point, and they are parsed as an
+ * ast::error.
+ */
 inline ast::node parse_prefix_error(parsing_state& s) {
-    s.report_error("Invalid token");
-    ++s.next;
-    return ast::error(s.next - 1, s.next);
+    lex::token_iterator first = s.next;
+    bool follow_on = follow_on_error(s);
+    if (is_sync_point(first->token)) {
+        if (!follow_on) {
+            s.report_error("expected an expression")
+                .add_primary(first->source_location, "before this");
+        }
+        s.recovery_point = first;
+        return s.make<ast::empty>(first, first);
+    }
+    skip_to_sync_point(s);
+    if (!follow_on) {
+        diagnostic::problem& error = s.report_error("Invalid token")
+            .add_primary(first->source_location);
+        add_recovery_point(s, error, first);
+    }
+    return s.make<ast::error>(first, s.next);
 }
 
 constexpr auto prefix_parser_table = token_table_t<prefix_parser_t>([](auto& t) {
@@ -42,26 +69,10 @@ constexpr auto prefix_parser_table = token_table_t<prefix_parser_t>([](auto& t)
     t[lex::token::BIT_AND]   = parse_prefix_op;
     t[lex::token::INC]       = parse_prefix_op;
     t[lex::token::DEC]       = parse_prefix_op;
-
-//    // error
-//    t[lex::token::ERROR] = prefix_parser_skip_error;
-//
-//    return t;
 });
 
 inline ast::node parse_prefix(parsing_state& s) {
-    ast::node node = prefix_parser_table[s.next->token](s);
-//    if (node.is<ast::error>()) {
-//        // try to recover from the error by parsing until succeeding, while
-//        // ignoring all errors along the way to avoid diagnostics clutter
-//        WITH(s.ignore_diagnostics_in_scope()) {
-//            while (
-//                s.it != s.end &&
-//                prefix_parser_table[s.it->value](s).is<ast::error>()
-//            ) {}
-//        }
-//    }
-    return node;
+    return prefix_parser_table[s.next->token](s);
 }
 
 } // namespace fp::syntax::detail
@@ -29,13 +29,21 @@ constexpr auto associativity_table = token_table_t<associativity>([](auto& t) {
     return t;
 });
 
+/// Resumes parsing an ast::binary_op with its parsed `rhs`.
+inline ast::node resume_binary_op(
+    parsing_state& s,
+    pending_parse& op,
+    ast::node rhs
+) {
+    return s.make<ast::binary_op>(op.node, op.token, rhs);
+}
+
 /// Parses the next token as an ast::binary_op.
 ast::node parse_binary_op(parsing_state& s, ast::node lhs) {
     lex::token_iterator op = s.next++;
     precedence_t p = precedence_table[op->token];
     if (associativity_table[op->token] == associativity::RIGHT) { --p; }
-    ast::node rhs = s.parse(p);
-    return ast::binary_op(std::move(lhs), op, std::move(rhs));
+    return s.parse_operand<resume_binary_op>(p, op, lhs);
 }
 
 } // namespace fp::syntax::detail
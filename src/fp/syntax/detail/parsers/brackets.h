@@ -2,49 +2,135 @@
 
 #include <fp/syntax/detail/precedence.h>
 #include <fp/syntax/detail/parsing_state.h>
+#include <fp/syntax/detail/recovery.h>
 #include <fp/syntax/detail/parsers/sequence.h>
 
 namespace fp::syntax::detail {
 
-ast::node parse_block(
-    parsing_state& s,
-    lex::token_iterator opening_brace,
-    ast::node first_node
-) {
-    parsed_sequence r = parse_sequence(s, std::move(first_node));
+/**
+ * Ends parsing an ast::block once all the nodes of its sequence are parsed,
+ * at its closing brace (or the end of the input).
+ */
+ast::node end_block(parsing_state& s, const pending_parse& block) {
+    parsed_sequence r = end_sequence(s, block);
+    lex::token_iterator opening_brace = block.token;
     if (s.next == s.end) {
         s.report_error("unterminated opening brace {")
             .add_primary(
                 opening_brace->source_location,
                 "missing closing }"
             );
+        // without a closing brace, the tokens can't make an ast::block
+        return s.make<ast::error>(opening_brace, s.end);
     }
     lex::token_iterator closing_brace = s.next++;
-    return ast::block(
+    return s.make<ast::block>(
         opening_brace,
         closing_brace,
-        std::move(r.nodes),
-        std::move(r.separators)
+        r.nodes,
+        r.separators
     );
 }
 
-/// TODO: Document
-ast::node parse_brackets(parsing_state& s) {
-    lex::token_iterator opening_brace = s.next++;
-    ast::node node = s.parse(precedence_table[lex::token::SEMICOLON]);
+/**
+ * Continues parsing an ast::block after the last node or separator of its
+ * sequence, where `continues` is whether another node follows (see
+ * detail::continue_sequence).
+ */
+inline ast::node continue_block(
+    parsing_state& s,
+    pending_parse& block,
+    bool continues
+) {
+    if (
+        continues ||
+        // the sequence usually ends right at the closing brace
+        (
+            !s.next_is(lex::token::R_BRACE) &&
+            recover_sequence(
+                s, block, lex::token::SEMICOLON, lex::token::R_BRACE
+            )
+        )
+    ) {
+        return s.parse_next_operand(sequence_precedence(s, block), block);
+    }
+    return end_block(s, block);
+}
+
+/// Resumes parsing an ast::block with the next node of its sequence.
+ast::node resume_block(
+    parsing_state& s,
+    pending_parse& block,
+    ast::node node
+) {
+    return continue_block(s, block, continue_sequence(s, block, node));
+}
+
+/// Resumes parsing brackets with the first node inside them.
+ast::node resume_brackets(
+    parsing_state& s,
+    pending_parse& brackets,
+    ast::node node
+) {
+    lex::token_iterator opening_brace = brackets.token;
+    // skip unexpected tokens after the node (e.g. a missing separator)
+    while (
+        s.next != s.end &&
+        !s.next_is(lex::token::SEMICOLON) &&
+        !s.next_is(lex::token::R_BRACE)
+    ) {
+        node = skip_unexpected(s, node);
+    }
     if (s.next == s.end) {
         s.report_error("unterminated opening brace {")
             .add_primary(opening_brace->source_location, "missing closing }");
         return node;
     }
-    switch (s.next->token) {
-        case lex::token::SEMICOLON:
-            return parse_block(s, opening_brace, std::move(node));
-        default:
+    if (s.next_is(lex::token::R_BRACE)) {
+        // without a separator, the contents can't make an ast::block
+        if (!follow_on_error(s)) {
             s.report_error("unexpected token")
                 .add_primary(s.next->source_location, "unexpected");
-            return node;
+        }
+        ++s.next;
+        return s.make<ast::error>(opening_brace, s.next);
+    }
+    brackets.resume = resume_block;
+    return continue_block(s, brackets, begin_sequence(s, brackets, node));
+}
+
+/**
+ * Parses the opening brace `{` and the contents after it (e.g. an ast::block,
+ * which ends with its closing brace).
+ */
+ast::node parse_brackets_contents(parsing_state& s) {
+    lex::token_iterator opening_brace = s.next++;
+    return s.parse_operands<resume_brackets>(
+        precedence_table[lex::token::SEMICOLON],
+        opening_brace
+    );
+}
+
+/**
+ * Parses brackets, whose contents are deferred (parsed into an
+ * ast::deferred_block) if parsing_state::deferred is set and their closing
+ * brace is found, and are parsed by detail::parse_brackets_contents otherwise.
+ */
+ast::node parse_brackets(parsing_state& s) {
+    if (s.deferred) {
+        lex::token_iterator opening_brace = s.next;
+        lex::token_iterator closing_brace = s.matching_bracket(opening_brace);
+        if (closing_brace != s.end) {
+            s.next = closing_brace + 1;
+            return s.make<ast::deferred_block>(
+                opening_brace,
+                closing_brace,
+                s.nesting_depth(),
+                *s.deferred
+            );
+        }
     }
+    return parse_brackets_contents(s);
 }
 
 } // namespace fp::syntax::detail
@@ -5,32 +5,65 @@
 
 namespace fp::syntax::detail {
 
-/// Parses the next token as ast::if_.
-ast::node parse_if(parsing_state& s) {
-    lex::token_iterator if_token = s.next++;
-    ast::node condition = s.parse(0);
-    if (condition.is<ast::empty>()) {
+/// Resumes parsing an ast::if_ with its parsed `body`.
+ast::node resume_if_body(
+    parsing_state& s,
+    pending_parse& if_,
+    ast::node body
+) {
+    lex::token_iterator if_token = if_.token;
+    ast::node condition = if_.node;
+    bool missing_opening_brace =
+        if_.operand_begin == s.end ||
+        if_.operand_begin->token != lex::token::L_BRACE;
+    // (a body that is missing due to a reported error isn't reported again)
+    if (missing_opening_brace && !s.recovering()) {
+        // the condition and the body are empty at the end of the input, and
+        // have no source location
+        fp::source_location missing_brace_location =
+            condition.is<ast::empty>()
+                ? if_token->source_location.slice_end()
+                : condition.source_location().slice_end();
+        diagnostic::problem& error = s.report_error(
+            "missing { after `if` condition"
+        );
+        error.add_primary(missing_brace_location, "missing { here")
+            .add_contextual(if_token->source_location);
+        if (!condition.is<ast::empty>()) {
+            error.add_contextual(condition.source_location());
+        }
+        if (!body.is<ast::empty>()) {
+            error.add_contextual(body.source_location());
+        }
+    }
+    return s.make<ast::if_>(if_token, condition, body);
+}
+
+/// Resumes parsing an ast::if_ with its parsed `condition`.
+ast::node resume_if_condition(
+    parsing_state& s,
+    pending_parse& if_,
+    ast::node condition
+) {
+    if (condition.is<ast::empty>() && !s.recovering()) {
         s.report_error("missing `if` condition")
             .add_primary(
-                if_token->source_location.slice_end(),
+                if_.token->source_location.slice_end(),
                 "missing condition here"
             )
-            .add_contextual(if_token->source_location);
+            .add_contextual(if_.token->source_location);
     }
     // even when missing {, we'll parse the next node as the body of the
     // ast::if_ node, to try to recover from the error
-    bool missing_opening_brace = !s.next_is(lex::token::L_BRACE);
-    ast::node body = s.parse(0);
-    if (missing_opening_brace) {
-        fp::source_location missing_brace_location =
-            condition.source_location().slice_end();
-        s.report_error("missing { after `if` condition")
-            .add_primary(missing_brace_location, "missing { here")
-            .add_contextual(if_token->source_location)
-            .add_contextual(condition.source_location())
-            .add_contextual(body.source_location());
-    }
-    return ast::if_(if_token, std::move(condition), std::move(body));
+    if_.resume = resume_if_body;
+    if_.node = condition;
+    return s.parse_next_operand(0, if_);
+}
+
+/// Parses the next token as ast::if_.
+ast::node parse_if(parsing_state& s) {
+    lex::token_iterator if_token = s.next++;
+    return s.parse_operands<resume_if_condition>(0, if_token);
 }
 
 } // namespace fp::syntax::detail
@@ -4,10 +4,10 @@
 
 namespace fp::syntax::detail {
 
-/// Parses the next token as an ast::binary_op.
+/// Parses the next token as an ast::postfix_op.
 ast::node parse_postfix_op(parsing_state& s, ast::node lhs) {
     lex::token_iterator op = s.next++;
-    return ast::postfix_op(std::move(lhs), op);
+    return s.make<ast::postfix_op>(lhs, op);
 }
 
 } // namespace fp::syntax::detail
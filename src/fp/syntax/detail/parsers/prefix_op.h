@@ -5,10 +5,19 @@
 
 namespace fp::syntax::detail {
 
+/// Resumes parsing an ast::prefix_op with its parsed `rhs`.
+inline ast::node resume_prefix_op(
+    parsing_state& s,
+    pending_parse& op,
+    ast::node rhs
+) {
+    return s.make<ast::prefix_op>(op.token, rhs);
+}
+
 /// Parses the next token as ast::prefix_op.
 ast::node parse_prefix_op(parsing_state& s) {
     lex::token_iterator op = s.next++;
-    return ast::prefix_op(op, s.parse(prefix_op_precedence));
+    return s.parse_operand<resume_prefix_op>(prefix_op_precedence, op);
 }
 
 } // namespace fp::syntax::detail
@@ -1,45 +1,141 @@
 #pragma once
 
+#include <span>
+
 #include <fp/syntax/detail/parsing_state.h>
+#include <fp/syntax/detail/precedence.h>
+#include <fp/syntax/detail/recovery.h>
 
 namespace fp::syntax::detail {
 
+/// The nodes and separators of a sequence, stored in the ast::arena.
 struct parsed_sequence {
-    std::vector<ast::node> nodes;
-    std::vector<lex::token_iterator> separators;
+    std::span<const ast::node> nodes;
+    std::span<const lex::token_iterator> separators;
 };
 
 /**
- * Parses the next token as an ast::sequence.
+ * Returns `true` if another node of a sequence follows its last separator. A
+ * separator may also appear after the last node (before a closing bracket or
+ * the end of the input).
+ */
+inline bool sequence_continues(const parsing_state& s) {
+    return s.next != s.end && !is_closing_bracket(s.next->token);
+}
+
+/**
+ * Begins the sequence of the given `parser` with its `first` node, assuming
+ * that the next token is a valid sequence-separator (i.e. token::COMMA or
+ * token::SEMICOLON).
+ *
+ * The parser is then resumed with each of the following nodes (see
+ * detail::continue_sequence), until detail::end_sequence. Meanwhile, they are
+ * collected in parsing_state::sequence_nodes (and their separators in
+ * parsing_state::sequence_separators), from the positions saved in `parser`.
  *
- * Assumes that the next token is a valid sequence-separator (i.e.
- * token::COMMA or token::SEMICOLON).
+ * Returns `true` if another node follows.
  */
-parsed_sequence parse_sequence(
+inline bool begin_sequence(
     parsing_state& s,
-    ast::node lhs
+    pending_parse& parser,
+    ast::node first
 ) {
-    parsed_sequence result;
-    result.nodes.push_back(std::move(lhs));
-    result.separators.push_back(s.next++);
+    parser.sequence_nodes_begin = s.sequence_nodes.size();
+    parser.sequence_separators_begin = s.sequence_separators.size();
+    s.sequence_nodes.push_back(first);
+    s.sequence_separators.push_back(s.next++);
+    return sequence_continues(s);
+}
 
-    lex::token separator_token = result.separators.front()->token;
-    precedence_t separator_precedence = precedence_table[separator_token];
+/// Returns the separator token of the sequence of `parser`.
+inline lex::token sequence_separator(
+    const parsing_state& s,
+    const pending_parse& parser
+) {
+    return s.sequence_separators[parser.sequence_separators_begin]->token;
+}
+
+/// Returns the precedence that the nodes of the sequence are parsed with.
+inline precedence_t sequence_precedence(
+    const parsing_state& s,
+    const pending_parse& parser
+) {
+    return precedence_table[sequence_separator(s, parser)];
+}
 
-    while (s.next != s.end) {
-        if (s.next_is(separator_token)) {
-            result.separators.push_back(s.next++);
+/**
+ * Adds the next `node` to the sequence of `parser`, and returns `true` if
+ * another node follows (after a separator).
+ */
+inline bool continue_sequence(
+    parsing_state& s,
+    const pending_parse& parser,
+    ast::node node
+) {
+    s.sequence_nodes.push_back(node);
+    if (!s.next_is(sequence_separator(s, parser))) { return false; }
+    s.sequence_separators.push_back(s.next++);
+    return sequence_continues(s);
+}
+
+/**
+ * Recovers from unexpected tokens where the sequence of `parser` should either
+ * continue with a `separator` or end with a `closing` bracket (e.g. a missing
+ * separator, or a closing bracket of another kind). They are skipped (see
+ * detail::skip_unexpected) along with the last node of the sequence, until
+ * reaching `closing` or the end of the input, or a separator that another node
+ * follows (in which case `true` is returned).
+ */
+bool recover_sequence(
+    parsing_state& s,
+    const pending_parse& parser,
+    lex::token separator,
+    lex::token closing
+) {
+    while (s.next != s.end && s.next->token != closing) {
+        size_t n_nodes = s.sequence_nodes.size() - parser.sequence_nodes_begin;
+        size_t n_separators =
+            s.sequence_separators.size() - parser.sequence_separators_begin;
+        if (n_nodes > n_separators) {
+            ast::node& last = s.sequence_nodes.back();
+            last = skip_unexpected(s, last);
         } else {
-            break;
+            s.sequence_nodes.push_back(skip_unexpected(s));
         }
-        result.nodes.push_back(s.parse(separator_precedence));
-        if (s.next_is(separator_token)) {
-            continue;
-        } else {
-            break;
+        if (s.next_is(separator)) {
+            s.sequence_separators.push_back(s.next++);
+            if (sequence_continues(s)) { return true; }
         }
     }
-    return result;
+    return false;
+}
+
+/**
+ * Ends the sequence of `parser`, moving its nodes and separators into the
+ * ast::arena.
+ */
+inline parsed_sequence end_sequence(
+    parsing_state& s,
+    const pending_parse& parser
+) {
+    auto nodes = std::span<const ast::node>(s.sequence_nodes)
+        .subspan(parser.sequence_nodes_begin);
+    auto separators = std::span<const lex::token_iterator>(
+        s.sequence_separators
+    ).subspan(parser.sequence_separators_begin);
+    parsed_sequence sequence{
+        .nodes = s.arena.copy<ast::node>(nodes),
+        .separators = s.arena.copy<lex::token_iterator>(separators)
+    };
+    s.sequence_nodes.erase(
+        s.sequence_nodes.begin() + parser.sequence_nodes_begin,
+        s.sequence_nodes.end()
+    );
+    s.sequence_separators.erase(
+        s.sequence_separators.begin() + parser.sequence_separators_begin,
+        s.sequence_separators.end()
+    );
+    return sequence;
 }
 
 } // namespace fp::syntax::detail
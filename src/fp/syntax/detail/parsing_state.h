@@ -1,13 +1,134 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 #include <fp/util/context_value.h>
 #include <fp/diagnostic/report.h>
+#include <fp/lex/bracket_index.h>
 #include <fp/lex/tokenized_list.h>
 #include <fp/syntax/ast/node.h>
 #include <fp/syntax/detail/precedence.h>
 
 namespace fp::syntax::detail {
 
+struct parsing_state;
+
+/**
+ * Parses the contents of the ast::deferred_block nodes of an outline (see
+ * syntax::parsing_options::outline), which all refer to it. It's allocated in
+ * the ast::arena of the outline, along with the parsed nodes.
+ *
+ * It's also a lock (for std::lock_guard), which serializes the changes that
+ * are made to the outline's arena and report once a block is parsed.
+ */
+struct deferred_parser {
+    /// The arena of the outline.
+    ast::arena& arena;
+
+    /// The report of the outline.
+    diagnostic::report& report;
+
+    /// See syntax::parsing_options::max_nesting_depth.
+    size_t max_nesting_depth;
+
+    /**
+     * The index of the brackets of the outline's tokens (which begin at
+     * `brackets_begin`), which is also used by the nested deferred blocks.
+     */
+    const lex::bracket_index& brackets;
+    lex::token_iterator       brackets_begin;
+
+    deferred_parser(
+        ast::arena& arena,
+        diagnostic::report& report,
+        size_t max_nesting_depth,
+        const lex::bracket_index& brackets,
+        lex::token_iterator brackets_begin
+    ) :
+        arena(arena),
+        report(report),
+        max_nesting_depth(max_nesting_depth),
+        brackets(brackets),
+        brackets_begin(brackets_begin)
+    {}
+
+    void lock() {
+        while (busy.test_and_set(std::memory_order_acquire)) {
+            busy.wait(true, std::memory_order_relaxed);
+        }
+    }
+
+    void unlock() {
+        busy.clear(std::memory_order_release);
+        busy.notify_one();
+    }
+
+private:
+    std::atomic_flag busy;
+};
+
+/**
+ * A parser that waits for the AST node of its next operand to be parsed (e.g.
+ * the RHS of a binary operator), see parsing_state::parse_operands.
+ *
+ * Once the operand is parsed, the parser is resumed with it by calling
+ * `resume`, which either returns the node that the parser produced, or
+ * parsing_state::suspended if the parser waits for another operand (e.g. the
+ * next node of a block, see parsing_state::parse_next_operand).
+ */
+struct pending_parse {
+    using resume_t = ast::node (*)(
+        parsing_state&,
+        pending_parse&,
+        ast::node operand
+    );
+
+    pending_parse(resume_t resume, lex::token_iterator token, ast::node node) :
+        resume(resume),
+        token(token),
+        node(node)
+    {}
+
+    resume_t resume;
+
+    /// The token that the parser began with (e.g. the operator).
+    lex::token_iterator token;
+
+    /**
+     * A node that the parser already produced (e.g. the LHS of an operator),
+     * or parsing_state::suspended if there's none.
+     */
+    ast::node node;
+
+    //@{
+    /**
+     * The beginning of the parser's sequence in parsing_state::sequence_nodes
+     * and parsing_state::sequence_separators (see detail::begin_sequence).
+     */
+    size_t sequence_nodes_begin;
+    size_t sequence_separators_begin;
+    //@}
+
+    /// The first token of the operand (see parsing_state::parse_next_operand).
+    lex::token_iterator operand_begin;
+
+    /// The precedence that the operand is parsed with.
+    precedence_t operand_precedence;
+
+    /// The precedence of the parse that the parser was called from.
+    precedence_t precedence;
+};
+
+/**
+ * Thrown once the input is nested more than parsing_state::max_nesting_depth
+ * levels deep (after the error is reported, and the rest of the input is
+ * skipped). It's caught where the top-level statement (or the deferred block)
+ * began, which is then parsed into an ast::error.
+ */
+struct nesting_too_deep {};
+
 /// The internal state being kept during syntax parsing.
 struct parsing_state {
     /// A parse function to recursively process tokens.
@@ -16,17 +137,106 @@ struct parsing_state {
     lex::token_iterator next; ///< Points to the next token in the input.
     lex::token_iterator end;  ///< Points to the end of the input.
 
+    /// Owns all the AST nodes that are produced during parsing.
+    ast::arena& arena;
+
+    /**
+     * The maximal number of parsers that can wait for their operands at once
+     * (see parsing_state::parse_operands), which is the maximal nesting depth
+     * of the input.
+     */
+    size_t max_nesting_depth;
+
+    /**
+     * The maximal number of operands that are parsed recursively, beyond which
+     * parsers are suspended instead (see parsing_state::parse_operands). This
+     * keeps the call stack shallow, while most code is never nested this deep.
+     */
+    static constexpr size_t max_recursion_depth = 64;
+
+    /// The number of operands that are being parsed recursively.
+    size_t recursion_depth = 0;
+
+    /**
+     * The number of operands that the input is nested in (when parsing an
+     * ast::deferred_block), which isn't included in `max_nesting_depth`.
+     */
+    size_t outer_nesting_depth = 0;
+
+    /**
+     * The maximal `recursion_depth`, which is also bounded by
+     * `max_nesting_depth`.
+     */
+    size_t recursion_limit;
+
+    /// The stack of suspended parsers, from the outermost to the innermost.
+    std::vector<pending_parse> pending;
+
+    //@{
+    /**
+     * The nodes and separators of the sequences that are being parsed, which
+     * are moved into the arena once complete. Nested sequences are always
+     * complete before the sequences that contain them, so they share the same
+     * stacks (see detail::begin_sequence).
+     */
+    std::vector<ast::node> sequence_nodes;
+    std::vector<lex::token_iterator> sequence_separators;
+    //@}
+
+    /**
+     * The node that parsers return instead of their own while they wait for
+     * an operand (see parsing_state::parse_operands). It's never a part of the
+     * AST.
+     */
+    const ast::node suspended;
+
+    /**
+     * The token at which parsing continued after the last syntax error (see
+     * detail::skip_to_sync_point), or the end of the input if there's none.
+     */
+    lex::token_iterator recovery_point;
+
+    /**
+     * If not null, the contents of blocks are not parsed: blocks are parsed
+     * into ast::deferred_block nodes of this parser instead (if their closing
+     * braces are found in `brackets`).
+     */
+    deferred_parser* deferred = nullptr;
+
+    /**
+     * The index of the brackets of the tokens that begin at `brackets_begin`
+     * (which include the input), if blocks are deferred.
+     */
+    const lex::bracket_index* brackets = nullptr;
+    lex::token_iterator       brackets_begin;
+
     parsing_state(
         lex::tokenized_view tokens,
         parse_function_t parse,
-        diagnostic::report& report
+        ast::arena& arena,
+        diagnostic::report& report,
+        size_t max_nesting_depth
     ) :
         next(tokens.begin()),
         end(tokens.end()),
+        arena(arena),
+        max_nesting_depth(max_nesting_depth),
+        recursion_limit(std::min(max_recursion_depth, max_nesting_depth)),
+        suspended(ast::node::make<ast::empty>(arena, end, end)),
+        recovery_point(end),
         parse_(parse),
         report(report)
     {}
 
+    /**
+     * Constructs an AST node of type `NodeType` (in the parsing's ast::arena)
+     * from the given arguments.
+     */
+    template <class NodeType, class... Args>
+    ast::node make(Args&&... args) {
+        return ast::node::make<NodeType>(arena, std::forward<Args>(args)...);
+    }
+
     /// Reports a diagnostic::error with the given error::code.
     diagnostic::problem& report_error(const error::code* error_code) {
          report_problem(diagnostic::error(error_code));
@@ -73,12 +283,138 @@ struct parsing_state {
      */
     ast::node parse(precedence_t p) { return parse_(*this, p); }
 
+    /**
+     * Returns `true` if the next operand can be parsed by a recursive call
+     * (see parsing_state::parse_operands).
+     */
+    bool can_recurse() const { return recursion_depth < recursion_limit; }
+
+    /**
+     * Parses the operands of a parser that begins with `token`, whose first
+     * operand is parsed with precedence `p`. The parser is resumed with each
+     * operand by calling `resume` (along with `node`, see
+     * detail::pending_parse), until it returns the parser's node.
+     *
+     * If parsing_state::can_recurse, the operands are parsed by recursive calls
+     * to parsing_state::parse, and the parser is kept on the call stack.
+     * Otherwise, the parser is suspended: it's pushed onto
+     * parsing_state::pending, and parsing_state::suspended is returned (which
+     * the parser returns). The loop of detail::parse then parses the operands
+     * and resumes the parser with them, so that deeply nested input doesn't
+     * overflow the call stack.
+     *
+     * If the input is nested too deeply meanwhile, detail::nesting_too_deep is
+     * thrown.
+     */
+    template <pending_parse::resume_t resume>
+    ast::node parse_operands(
+        precedence_t p,
+        lex::token_iterator token,
+        ast::node node
+    ) {
+        if (!can_recurse()) [[unlikely]] {
+            return suspend<resume>(p, token, node);
+        }
+        pending_parse parser(resume, token, node);
+        parse_next_operand(p, parser);
+        ast::node result = resume(*this, parser, parse_recursively(p));
+        while (result == suspended) {
+            ast::node operand = parse_recursively(parser.operand_precedence);
+            result = parser.resume(*this, parser, operand);
+        }
+        return result;
+    }
+
+    /**
+     * Like parsing_state::parse_operands, for a parser that has a single
+     * operand (i.e. `resume` never waits for another operand).
+     */
+    template <pending_parse::resume_t resume>
+    ast::node parse_operand(
+        precedence_t p,
+        lex::token_iterator token,
+        ast::node node
+    ) {
+        if (!can_recurse()) [[unlikely]] {
+            return suspend<resume>(p, token, node);
+        }
+        pending_parse parser(resume, token, node);
+        parse_next_operand(p, parser);
+        return resume(*this, parser, parse_recursively(p));
+    }
+
+    /// Parses the operands of a parser without a node.
+    template <pending_parse::resume_t resume>
+    ast::node parse_operands(precedence_t p, lex::token_iterator token) {
+        return parse_operands<resume>(p, token, suspended);
+    }
+
+    /// Parses the operand of a parser without a node.
+    template <pending_parse::resume_t resume>
+    ast::node parse_operand(precedence_t p, lex::token_iterator token) {
+        return parse_operand<resume>(p, token, suspended);
+    }
+
+    /**
+     * Makes the given `parser` (while it's being resumed) wait for its next
+     * operand again, which is parsed with precedence `p`, and returns
+     * parsing_state::suspended (which the parser returns).
+     */
+    ast::node parse_next_operand(precedence_t p, pending_parse& parser) {
+        parser.operand_begin = next;
+        parser.operand_precedence = p;
+        return suspended;
+    }
+
+    /**
+     * Returns the bracket that matches the bracket `it` (see `brackets`), or
+     * `end` if it's unmatched in the input.
+     */
+    lex::token_iterator matching_bracket(lex::token_iterator it) const {
+        size_t match = (*brackets)[it - brackets_begin];
+        if (match == lex::bracket_index::unmatched) { return end; }
+        return std::min(brackets_begin + match, end);
+    }
+
+    /// Returns the number of operands that are being parsed.
+    size_t nesting_depth() const {
+        return outer_nesting_depth + recursion_depth + pending.size();
+    }
+
+    /**
+     * Returns `true` if parsing just continued from the next token after a
+     * syntax error (which was already reported), so that any error reported
+     * right at this token is a follow-on error, which is not reported.
+     */
+    bool recovering() const { return next == recovery_point && next != end; }
+
     /// Returns `true` if the next token is `TOKEN`.
     bool next_is(lex::token t) { return next != end && next->token == t; }
 
 private:
     parse_function_t parse_;
 
+    /**
+     * Suspends a parser until its first operand (with precedence `p`) is
+     * parsed, see parsing_state::parse_operands.
+     */
+    template <pending_parse::resume_t resume>
+    ast::node suspend(
+        precedence_t p,
+        lex::token_iterator token,
+        ast::node node
+    ) {
+        return parse_next_operand(p, pending.emplace_back(resume, token, node));
+    }
+
+    /// Parses the next operand with precedence `p` by a recursive call.
+    ast::node parse_recursively(precedence_t p) {
+        ++recursion_depth;
+        ast::node operand = parse(p);
+        --recursion_depth;
+        return operand;
+    }
+
     /// Any problems encountered during parsing is reported here.
     diagnostic::report& report;
 
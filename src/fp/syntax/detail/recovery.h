@@ -0,0 +1,156 @@
+#pragma once
+
+#include <fp/util/small_vector.h>
+#include <fp/syntax/detail/parsing_state.h>
+
+namespace fp::syntax::detail {
+
+/// Returns `true` if `t` is a closing bracket.
+inline bool is_closing_bracket(lex::token t) {
+    return
+        t == lex::token::R_PAREN ||
+        t == lex::token::R_BRACKET ||
+        t == lex::token::R_BRACE;
+}
+
+/// Returns `true` if `t` is an opening bracket.
+inline bool is_opening_bracket(lex::token t) {
+    return
+        t == lex::token::L_PAREN ||
+        t == lex::token::L_BRACKET ||
+        t == lex::token::L_BRACE;
+}
+
+/**
+ * Returns `true` if parsing can continue from the token `t` after a syntax
+ * error: a statement separator, or a closing bracket (which ends the
+ * brackets that the error is in).
+ */
+inline bool is_sync_point(lex::token t) {
+    return t == lex::token::SEMICOLON || is_closing_bracket(t);
+}
+
+/**
+ * Returns `true` if an error at the next token would be a follow-on error,
+ * which isn't reported: either parsing is recovering from an error at it (see
+ * parsing_state::recovering), or it's a token::ERROR (which the lexer already
+ * reported).
+ */
+inline bool follow_on_error(const parsing_state& s) {
+    return s.recovering() || s.next->token == lex::token::ERROR;
+}
+
+/// Returns the closing bracket of the given opening bracket.
+inline lex::token closing_bracket(lex::token opening) {
+    switch (opening) {
+        case lex::token::L_PAREN:   return lex::token::R_PAREN;
+        case lex::token::L_BRACKET: return lex::token::R_BRACKET;
+        default:                    return lex::token::R_BRACE;
+    }
+}
+
+/**
+ * Panic-mode error recovery: skips the next token, along with the tokens after
+ * it until the next synchronization point (see detail::is_sync_point) that is
+ * outside of the skipped brackets, or the end of the input. Returns the first
+ * skipped token.
+ *
+ * Like in lex::bracket_index, a closing bracket closes the innermost skipped
+ * bracket of the same kind. Without one, it closes brackets that enclose the
+ * error, and so it's a synchronization point.
+ *
+ * The skipped tokens are not parsed, so a single error is reported for all of
+ * them (by the caller), instead of an error for each, and the time it takes
+ * doesn't depend on how broken they are. Parsing continues from the
+ * synchronization point, which becomes the parsing_state::recovery_point.
+ */
+inline lex::token_iterator skip_to_sync_point(parsing_state& s) {
+    lex::token_iterator first = s.next;
+    // the closing brackets of the skipped brackets, from the outermost
+    util::small_vector<lex::token, 8> closing;
+    size_t n_closing[3] = {};
+    auto kind = [](lex::token closing) -> size_t {
+        switch (closing) {
+            case lex::token::R_PAREN:   return 0;
+            case lex::token::R_BRACKET: return 1;
+            default:                    return 2;
+        }
+    };
+    for (; s.next != s.end; ++s.next) {
+        lex::token t = s.next->token;
+        if (s.next == first && !is_opening_bracket(t)) { continue; }
+        if (is_opening_bracket(t)) {
+            closing.push_back(closing_bracket(t));
+            ++n_closing[kind(closing.back())];
+        } else if (is_closing_bracket(t)) {
+            if (n_closing[kind(t)] == 0) { break; }
+            while (closing.back() != t) {
+                --n_closing[kind(closing.back())];
+                closing.pop_back();
+            }
+            --n_closing[kind(t)];
+            closing.pop_back();
+        } else if (closing.empty() && t == lex::token::SEMICOLON) {
+            break;
+        }
+    }
+    s.recovery_point = s.next;
+    return first;
+}
+
+/**
+ * Adds the location where parsing continued after the given syntax `error`
+ * (see detail::skip_to_sync_point), if tokens after `first` were skipped.
+ */
+inline void add_recovery_point(
+    parsing_state& s,
+    diagnostic::problem& error,
+    lex::token_iterator first
+) {
+    if (s.next - first > 1 && s.next != s.end) {
+        error.add_supplement(
+            s.next->source_location,
+            "skipped the tokens up to here"
+        );
+    }
+}
+
+/**
+ * Recovers from an unexpected next token after `lhs` (e.g. a missing operator
+ * or separator), by skipping the rest of the tokens up to the next
+ * synchronization point (see detail::skip_to_sync_point). Returns an
+ * ast::infix_error of `lhs` and the skipped tokens.
+ *
+ * Nothing is reported for follow-on errors (see detail::follow_on_error).
+ */
+inline ast::node skip_unexpected(parsing_state& s, ast::node lhs) {
+    bool follow_on = follow_on_error(s);
+    lex::token_iterator unexpected = skip_to_sync_point(s);
+    if (!follow_on) {
+        diagnostic::problem& error = s.report_error("unexpected token")
+            .add_primary(unexpected->source_location);
+        if (!lhs.tokens().empty()) {
+            error.add_contextual(lhs.source_location());
+        }
+        add_recovery_point(s, error, unexpected);
+    }
+    return s.make<ast::infix_error>(lhs, unexpected, s.next);
+}
+
+/**
+ * Just like detail::skip_unexpected, but without a node before the unexpected
+ * token (e.g. right after a separator). Returns an ast::error of the skipped
+ * tokens.
+ */
+inline ast::node skip_unexpected(parsing_state& s) {
+    bool follow_on = follow_on_error(s);
+    lex::token_iterator unexpected = skip_to_sync_point(s);
+    if (!follow_on) {
+        diagnostic::problem& error = s.report_error("unexpected token")
+            .add_primary(unexpected->source_location);
+        add_recovery_point(s, error, unexpected);
+    }
+    return s.make<ast::error>(unexpected, s.next);
+}
+
+} // namespace fp::syntax::detail
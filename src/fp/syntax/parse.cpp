@@ -1,7 +1,17 @@
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fp/error_codes.h>
+#include <fp/util/thread_pool.h>
+#include <fp/lex/bracket_index.h>
 #include <fp/syntax/detail/precedence.h>
 #include <fp/syntax/detail/parsing_state.h>
 #include <fp/syntax/detail/parse_prefix.h>
 #include <fp/syntax/detail/parse_infix.h>
+#include <fp/syntax/detail/recovery.h>
 
 #include "parse.h"
 
@@ -9,23 +19,680 @@ namespace fp::syntax {
 
 namespace detail {
 
+/**
+ * Reports that the parser that was just suspended exceeds the maximal nesting
+ * depth, skips the rest of the input, and throws detail::nesting_too_deep.
+ */
+[[noreturn]] static void skip_too_deep(parsing_state& s) {
+    s.report_error(&error::E0014_nesting_too_deep)
+        .add_primary(
+            s.pending.back().token->source_location,
+            "nested more than " + std::to_string(s.max_nesting_depth) +
+            " levels deep, the rest of the file is skipped"
+        );
+    s.next = s.end;
+    throw nesting_too_deep();
+}
+
+/**
+ * The loop of the Pratt parser, which continues with `node` at precedence `p`:
+ * either a parsed node, or parsing_state::suspended if a parser was just
+ * suspended (see parsing_state::parse_operands). It returns once all the
+ * parsers that have been suspended since `depth` are complete.
+ *
+ * The operands of suspended parsers are parsed in this same loop, and then the
+ * parsers are resumed with them. It's only used beyond the recursion limit, so
+ * it's not inlined into detail::parse.
+ */
+[[gnu::noinline]] static ast::node parse_loop(
+    parsing_state& s,
+    precedence_t p,
+    ast::node node,
+    size_t depth
+) {
+    while (true) {
+        if (node == s.suspended) {
+            // parse the operand of the suspended parser
+            pending_parse& suspended = s.pending.back();
+            suspended.precedence = p;
+            p = suspended.operand_precedence;
+            if (s.recursion_depth + s.pending.size() > s.max_nesting_depth) {
+                skip_too_deep(s);
+            }
+            node = s.next == s.end
+                ? s.make<ast::empty>(s.end, s.end)
+                : parse_prefix(s);
+        } else if (s.next != s.end && p < precedence_table[s.next->token]) {
+            node = parse_infix(s, node);
+        } else if (s.pending.size() > depth) {
+            // the operand is complete, so its parser is resumed with it (and
+            // is done, unless it suspended itself again)
+            pending_parse& resumed = s.pending.back();
+            p = resumed.precedence;
+            node = resumed.resume(s, resumed, node);
+            if (node != s.suspended) { s.pending.pop_back(); }
+        } else {
+            return node;
+        }
+    }
+}
+
 static ast::node parse(parsing_state& s, precedence_t p) {
-    if (s.next == s.end) { return ast::empty(s.end, s.end); }
+    if (s.next == s.end) { return s.make<ast::empty>(s.end, s.end); }
+    if (!s.can_recurse()) {
+        size_t depth = s.pending.size();
+        return parse_loop(s, p, parse_prefix(s), depth);
+    }
+    // the parsers parse their operands recursively, so they are never
+    // suspended (see parsing_state::parse_operands)
     ast::node lhs = parse_prefix(s);
     while (s.next != s.end && p < precedence_table[s.next->token]) {
-        lhs = parse_infix(s, std::move(lhs));
+        lhs = parse_infix(s, lhs);
     }
     return lhs;
 }
 
+/**
+ * Abandons the parsers that were interrupted by detail::nesting_too_deep, and
+ * returns an ast::error of the tokens from `first` to the end of the input.
+ */
+static ast::node skipped_too_deep(parsing_state& s, lex::token_iterator first) {
+    s.recursion_depth = 0;
+    s.pending.clear();
+    s.sequence_nodes.clear();
+    s.sequence_separators.clear();
+    return s.make<ast::error>(first, s.end);
+}
+
+/**
+ * Parses the next top-level statement, or an ast::error of the rest of the
+ * input if it's nested too deeply (see parsing_state::max_nesting_depth).
+ */
+static ast::node parse_top_level_node(parsing_state& s) {
+    lex::token_iterator first = s.next;
+    try {
+        return s.parse(precedence_table[lex::token::SEMICOLON]);
+    } catch (const nesting_too_deep&) {
+        return skipped_too_deep(s, first);
+    }
+}
+
+/**
+ * Makes `s` parse the outline of its input `tokens` (see
+ * parsing_options::outline), if `options` ask for it. If `options` don't give
+ * an index of the brackets of `tokens`, it's built once, and kept in the arena
+ * of `s` (so that the deferred blocks, even nested ones, use it too).
+ */
+static void begin_outline(
+    parsing_state& s,
+    lex::tokenized_view tokens,
+    diagnostic::report& report,
+    const parsing_options& options
+) {
+    if (!options.outline) { return; }
+    const lex::bracket_index* brackets = options.brackets;
+    if (brackets == nullptr) {
+        brackets = s.arena.keep(std::make_unique<lex::bracket_index>(tokens));
+    }
+    s.deferred = s.arena.make<deferred_parser>(
+        s.arena,
+        report,
+        options.max_nesting_depth,
+        *brackets,
+        tokens.begin()
+    );
+    s.brackets = brackets;
+    s.brackets_begin = tokens.begin();
+}
+
+/**
+ * Parses the block of the given `tokens` (from its opening brace to its
+ * closing brace), which is nested in `nesting_depth` operands, into `arena`.
+ * Its own blocks are deferred into blocks of `deferred`, if it's not null.
+ */
+static ast::node parse_block(
+    lex::tokenized_view tokens,
+    ast::arena& arena,
+    diagnostic::report& report,
+    size_t max_nesting_depth,
+    size_t nesting_depth,
+    deferred_parser* deferred
+) {
+    parsing_state s(
+        tokens,
+        parse,
+        arena,
+        report,
+        max_nesting_depth - nesting_depth
+    );
+    s.outer_nesting_depth = nesting_depth;
+    if (deferred) {
+        s.deferred = deferred;
+        s.brackets = &deferred->brackets;
+        s.brackets_begin = deferred->brackets_begin;
+    }
+    try {
+        ast::node node = parse_brackets_contents(s);
+        if (s.next != s.end) {
+            node = s.make<ast::error>(tokens.begin(), tokens.end());
+        }
+        return node;
+    } catch (const nesting_too_deep&) {
+        return skipped_too_deep(s, tokens.begin());
+    }
+}
+
+ast::node parse_deferred(const ast::deferred_block& block) {
+    deferred_parser& parser = *block.parser;
+
+    // the block is parsed into its own arena and report, which are moved into
+    // those of the outline once it's parsed (unless another thread was first)
+    ast::arena arena;
+    diagnostic::report report;
+    ast::node node = parse_block(
+        block.tokens(),
+        arena,
+        report,
+        parser.max_nesting_depth,
+        block.nesting_depth,
+        &parser
+    );
+
+    std::lock_guard lock(parser);
+    const ast::node* parsed = block.parsed.load(std::memory_order_relaxed);
+    if (parsed) { return *parsed; }
+    parser.arena.adopt(std::move(arena));
+    for (diagnostic::problem& p : report.errors()) {
+        parser.report.add(std::move(p));
+    }
+    for (diagnostic::problem& p : report.warnings()) {
+        parser.report.add(std::move(p));
+    }
+    block.parsed.store(
+        parser.arena.make<ast::node>(node),
+        std::memory_order_release
+    );
+    return node;
+}
+
+/// The top-level statements (and their separators) of the parsed source code.
+struct top_level_statements {
+    std::vector<ast::node> nodes;
+    std::vector<lex::token_iterator> separators;
+};
+
+/**
+ * Parses semicolon-separated top-level statements into `statements`, until
+ * reaching the end of the input. Unexpected tokens after a statement (e.g. an
+ * unmatched closing bracket) are skipped along with it, up to the next
+ * separator (see detail::skip_unexpected).
+ *
+ * If `statements` is not empty, parsing continues right after its last
+ * separator. Before parsing each statement that follows a separator,
+ * `resume(statements)` is called; if it returns `true`, the rest of the
+ * statements have been filled in by it, and parsing stops.
+ */
+template <class Resume>
+static void parse_top_level(
+    parsing_state& s,
+    top_level_statements& statements,
+    Resume&& resume
+) {
+    auto parse_statement = [&] {
+        // an unmatched closing bracket can't begin a statement
+        ast::node node = s.next != s.end && is_closing_bracket(s.next->token)
+            ? skip_unexpected(s)
+            : parse_top_level_node(s);
+        while (s.next != s.end && !s.next_is(lex::token::SEMICOLON)) {
+            node = skip_unexpected(s, node);
+        }
+        statements.nodes.push_back(node);
+    };
+    if (statements.nodes.empty()) {
+        parse_statement();
+        if (s.next == s.end) { return; }
+        statements.separators.push_back(s.next++);
+    }
+    while (s.next != s.end) {
+        if (resume(statements)) { return; }
+        parse_statement();
+        if (s.next == s.end) { return; }
+        statements.separators.push_back(s.next++);
+    }
+}
+
+/// Returns the AST of the given top-level statements.
+static ast::node make_root(
+    parsing_state& s,
+    const top_level_statements& statements
+) {
+    if (statements.separators.empty()) { return statements.nodes.front(); }
+    return s.make<ast::top_level_block>(
+        s.arena.copy<ast::node>(statements.nodes),
+        s.arena.copy<lex::token_iterator>(statements.separators)
+    );
+}
+
+/**
+ * Parses top-level statements into `statements` (like detail::parse_top_level)
+ * until they end, or until reaching a statement that begins at or after
+ * `until`. Returns `true` in the latter case.
+ */
+static bool parse_top_level_until(
+    parsing_state& s,
+    top_level_statements& statements,
+    lex::token_iterator until
+) {
+    bool reached = false;
+    parse_top_level(s, statements, [&](const auto&) {
+        return reached = s.next >= until;
+    });
+    return reached;
+}
+
+/**
+ * Parses the top-level statements of the tokens of `piece` into its (new)
+ * arena, until they end, or until `stop(s.next)` returns `true` right after a
+ * separator (see detail::parse_top_level). The deferred blocks of an outline
+ * report their problems to `outline_report`. Returns where parsing stopped.
+ */
+template <class Stop>
+static lex::token_iterator parse_piece(
+    piecewise_ast::piece& piece,
+    diagnostic::report& report,
+    diagnostic::report& outline_report,
+    parsing_options options,
+    Stop&& stop
+) {
+    lex::tokenized_view tokens = piece.tokens.tokens();
+    piece.arena = std::make_shared<ast::arena>();
+    parsing_state s(
+        tokens, parse, *piece.arena, report, options.max_nesting_depth
+    );
+    // the index of the brackets of the whole input doesn't fit the piece
+    options.brackets = nullptr;
+    begin_outline(s, tokens, outline_report, options);
+    top_level_statements statements;
+    parse_top_level(s, statements, [&](const auto&) { return stop(s.next); });
+    piece.nodes = piece.arena->copy<ast::node>(statements.nodes);
+    piece.separators =
+        piece.arena->copy<lex::token_iterator>(statements.separators);
+    return s.next;
+}
+
+/**
+ * Returns the beginnings of (at most) `n_segments` segments of roughly the
+ * same number of tokens that `tokens` is split into. Each segment (but the
+ * first) begins right after a semicolon that is outside of any brackets.
+ */
+static std::vector<lex::token_iterator> segment_begins(
+    lex::tokenized_view tokens,
+    size_t n_segments
+) {
+    std::vector<lex::token_iterator> begins = {tokens.begin()};
+    size_t depth = 0;
+    for (
+        size_t i = 0;
+        i + 1 < tokens.size() && begins.size() < n_segments;
+        ++i
+    ) {
+        switch (tokens[i].token) {
+            case lex::token::L_PAREN:
+            case lex::token::L_BRACKET:
+            case lex::token::L_BRACE:
+                ++depth;
+                break;
+            case lex::token::R_PAREN:
+            case lex::token::R_BRACKET:
+            case lex::token::R_BRACE:
+                if (depth > 0) { --depth; }
+                break;
+            case lex::token::SEMICOLON:
+                if (
+                    depth == 0 &&
+                    i + 1 >= begins.size() * tokens.size() / n_segments
+                ) {
+                    begins.push_back(tokens.begin() + i + 1);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return begins;
+}
+
+/// The speculative parsing of a segment of top-level statements.
+struct parsed_segment {
+    /// Where parsing of the segment stopped.
+    lex::token_iterator end;
+
+    /// Whether the statements continue after `end` (past the segment).
+    bool continues = false;
+
+    top_level_statements statements;
+    ast::arena           arena;
+    diagnostic::report   report;
+};
+
+/**
+ * Continues the top-level `statements` of `s` with the statements of `segment`
+ * (along with its AST nodes and reported problems), assuming that `s` reached
+ * its beginning right after a separator. Returns `true` if more statements
+ * follow.
+ */
+static bool stitch(
+    parsing_state& s,
+    top_level_statements& statements,
+    parsed_segment& segment
+) {
+    statements.nodes.insert(
+        statements.nodes.end(),
+        segment.statements.nodes.begin(),
+        segment.statements.nodes.end()
+    );
+    statements.separators.insert(
+        statements.separators.end(),
+        segment.statements.separators.begin(),
+        segment.statements.separators.end()
+    );
+    s.arena.adopt(std::move(segment.arena));
+    for (diagnostic::problem& p : segment.report.errors()) {
+        s.report_problem(std::move(p));
+    }
+    for (diagnostic::problem& p : segment.report.warnings()) {
+        s.report_problem(std::move(p));
+    }
+    s.next = segment.end;
+    return segment.continues;
+}
+
 } // namespace detail
 
-ast::node parse(lex::tokenized_view tokens, diagnostic::report& report) {
-    // Parsing is implemented using a simple Pratt Parser (TDOP) algorithm
-    detail::parsing_state s(tokens, detail::parse, report);
-    ast::node lhs = s.parse(0);
-    while (s.next != s.end) { lhs = detail::parse_infix(s, std::move(lhs)); }
-    return lhs;
+lex::piecewise_tokens piecewise_ast::tokens() const {
+    lex::piecewise_tokens tokens;
+    tokens.file = file;
+    for (const piece& p : pieces) {
+        if (p.tokens.begin != p.tokens.end) {
+            tokens.pieces.push_back(p.tokens);
+        }
+    }
+    return tokens;
+}
+
+std::vector<ast::node> piecewise_ast::statements() const {
+    std::vector<ast::node> statements;
+    for (const piece& p : pieces) {
+        statements.insert(statements.end(), p.nodes.begin(), p.nodes.end());
+    }
+    return statements;
+}
+
+ast::node parse(
+    lex::tokenized_view tokens,
+    ast::arena& arena,
+    diagnostic::report& report,
+    const parsing_options& options
+) {
+    // Parsing is implemented using a simple Pratt Parser (TDOP) algorithm,
+    // with bounded recursion (see detail::parsing_state::parse_operands)
+    detail::parsing_state s(
+        tokens, detail::parse, arena, report, options.max_nesting_depth
+    );
+    detail::begin_outline(s, tokens, report, options);
+    detail::top_level_statements statements;
+    detail::parse_top_level(s, statements, [](const auto&) { return false; });
+    return detail::make_root(s, statements);
+}
+
+piecewise_ast parse(
+    const lex::piecewise_tokens& tokens,
+    diagnostic::report& report,
+    const parsing_options& options
+) {
+    piecewise_ast result{.file = tokens.file, .outline = options.outline};
+    piecewise_ast::piece& piece = result.pieces.emplace_back();
+    piece.tokens = tokens.pieces.size() == 1
+        ? tokens.pieces.front()
+        : tokens.copy(0, tokens.size());
+    detail::parse_piece(piece, report, report, options, [](auto) {
+        return false;
+    });
+    return result;
+}
+
+piecewise_ast reparse(
+    const piecewise_ast& previous,
+    const lex::retokenized_list& retokenized,
+    diagnostic::report& report,
+    const parsing_options& options
+) {
+    const lex::piecewise_tokens& tokens = retokenized.tokens;
+    const lex::token_splice& splice = retokenized.splice;
+    if (previous.outline != options.outline || tokens.size() == 0) {
+        return parse(tokens, report, options);
+    }
+
+    // Top-level statements are always parsed from the same state, so a
+    // previous statement can be reused if the tokens it was parsed from (and
+    // the token that ended it) are unchanged. Statements are identified by
+    // their piece, and their index in it.
+    struct statement {
+        size_t piece;
+        size_t index;
+    };
+    std::vector<size_t> starts;
+    starts.reserve(previous.pieces.size());
+    size_t start = 0;
+    for (const piecewise_ast::piece& piece : previous.pieces) {
+        starts.push_back(start);
+        start += piece.tokens.end - piece.tokens.begin;
+    }
+    auto previous_index = [&](size_t p, lex::token_iterator it) -> size_t {
+        return starts[p] + (it - previous.pieces[p].tokens.tokens().begin());
+    };
+    auto begin_of = [&](statement st) {
+        const piecewise_ast::piece& piece = previous.pieces[st.piece];
+        return st.index == 0
+            ? starts[st.piece]
+            : previous_index(st.piece, piece.separators[st.index - 1]) + 1;
+    };
+
+    // reuse the statements whose separators are before the re-tokenized tokens
+    piecewise_ast result{.file = tokens.file, .outline = options.outline};
+    size_t p = 0;
+    size_t kept = 0;
+    for (; p < previous.pieces.size(); ++p) {
+        const piecewise_ast::piece& piece = previous.pieces[p];
+        kept = std::partition_point(
+            piece.separators.begin(), piece.separators.end(),
+            [&](lex::token_iterator it) {
+                return previous_index(p, it) < splice.begin;
+            }
+        ) - piece.separators.begin();
+        if (kept == piece.nodes.size()) {
+            result.pieces.push_back(piece);
+            continue;
+        }
+        if (kept > 0) {
+            piecewise_ast::piece& first = result.pieces.emplace_back(piece);
+            first.tokens.end =
+                previous_index(p, piece.separators[kept - 1]) + 1 - starts[p] +
+                first.tokens.begin;
+            first.nodes = first.nodes.first(kept);
+            first.separators = first.separators.first(kept);
+        }
+        break;
+    }
+    size_t begin = 0;
+    for (const piecewise_ast::piece& piece : result.pieces) {
+        begin += piece.tokens.end - piece.tokens.begin;
+    }
+
+    // the statements that begin after the re-tokenized tokens may be reused
+    const ptrdiff_t moved =
+        ptrdiff_t(splice.end) - ptrdiff_t(splice.previous_end);
+    statement next{p, kept};
+    while (
+        next.piece < previous.pieces.size() &&
+        begin_of(next) < splice.previous_end
+    ) {
+        if (++next.index == previous.pieces[next.piece].nodes.size()) {
+            next = {next.piece + 1, 0};
+        }
+    }
+    std::vector<statement> reusable;
+    std::vector<size_t> reusable_begins;
+    auto find_reusable = [&](size_t n) {
+        while (
+            reusable.size() < n &&
+            next.piece < previous.pieces.size()
+        ) {
+            reusable.push_back(next);
+            reusable_begins.push_back(begin_of(next) + moved);
+            if (++next.index == previous.pieces[next.piece].nodes.size()) {
+                next = {next.piece + 1, 0};
+            }
+        }
+    };
+
+    // parse the statements in between (unless they are all reused), stopping
+    // at the first reusable statement that parsing reaches right after a
+    // separator, and otherwise retry with more of the statements after them
+    size_t reused = 0;
+    for (size_t n = 1; true; n *= 2) {
+        find_reusable(n);
+        size_t end = reusable.size() < n
+            ? tokens.size()
+            : reusable_begins.back();
+        if (end == begin) { break; }
+
+        diagnostic::report attempt;
+        piecewise_ast::piece piece;
+        piece.tokens = tokens.copy(begin, end);
+        auto index_of = [&](lex::token_iterator it) -> size_t {
+            return begin + (it - piece.tokens.tokens().begin());
+        };
+        size_t stopped = index_of(detail::parse_piece(
+            piece, attempt, report, options,
+            [&](lex::token_iterator it) {
+                return std::binary_search(
+                    reusable_begins.begin(), reusable_begins.end(),
+                    index_of(it)
+                );
+            }
+        ));
+        if (stopped == tokens.size()) {
+            // the rest of the statements were parsed
+            reused = reusable.size();
+        } else if (piece.separators.size() != piece.nodes.size()) {
+            continue;
+        } else {
+            reused = std::lower_bound(
+                reusable_begins.begin(), reusable_begins.end(), stopped
+            ) - reusable_begins.begin();
+        }
+        piece.tokens.end = piece.tokens.begin + (stopped - begin);
+        result.pieces.push_back(std::move(piece));
+        for (diagnostic::problem& problem : attempt.errors()) {
+            report.add(std::move(problem));
+        }
+        for (diagnostic::problem& problem : attempt.warnings()) {
+            report.add(std::move(problem));
+        }
+        break;
+    }
+
+    // reuse the statements after them, moved by the edit
+    if (reused < reusable.size()) {
+        statement first = reusable[reused];
+        for (size_t q = first.piece; q < previous.pieces.size(); ++q) {
+            piecewise_ast::piece& piece =
+                result.pieces.emplace_back(previous.pieces[q]);
+            piece.tokens.offset += splice.shift;
+            if (q == first.piece) {
+                piece.tokens.begin += begin_of(first) - starts[q];
+                piece.nodes = piece.nodes.subspan(first.index);
+                piece.separators = piece.separators.subspan(
+                    std::min(first.index, piece.separators.size())
+                );
+            }
+        }
+    }
+    return result;
+}
+
+ast::node parse_parallel(
+    lex::tokenized_view tokens,
+    ast::arena& arena,
+    diagnostic::report& report,
+    const parallel_parsing& parallel,
+    const parsing_options& options
+) {
+    util::thread_pool pool(parallel.jobs);
+    size_t n_segments = std::min(
+        tokens.size() / std::max<size_t>(parallel.min_segment_size, 1),
+        pool.size() * 4
+    );
+    std::vector<lex::token_iterator> begins =
+        detail::segment_begins(tokens, n_segments);
+    if (begins.size() < 2) { return parse(tokens, arena, report, options); }
+    begins.push_back(tokens.end());
+
+    detail::parsing_state s(
+        tokens, detail::parse, arena, report, options.max_nesting_depth
+    );
+    detail::begin_outline(s, tokens, report, options);
+    detail::top_level_statements statements;
+
+    // the first segment is parsed directly into the result
+    bool continues = false;
+    pool.submit([&]() {
+        continues = detail::parse_top_level_until(s, statements, begins[1]);
+    });
+    std::vector<detail::parsed_segment> segments(begins.size() - 2);
+    for (size_t i = 0; i < segments.size(); ++i) {
+        pool.submit([&, i]() {
+            detail::parsed_segment& segment = segments[i];
+            detail::parsing_state ss(
+                lex::tokenized_view(begins[i + 1], tokens.end()),
+                detail::parse,
+                segment.arena,
+                segment.report,
+                options.max_nesting_depth
+            );
+            // the deferred blocks of all the segments belong to the outline
+            ss.deferred = s.deferred;
+            ss.brackets = s.brackets;
+            ss.brackets_begin = s.brackets_begin;
+            segment.continues = detail::parse_top_level_until(
+                ss, segment.statements, begins[i + 2]
+            );
+            segment.end = ss.next;
+        });
+    }
+    pool.wait();
+    if (!continues) { return detail::make_root(s, statements); }
+
+    // top-level statements are always parsed from the same state, so the
+    // statements of a segment are used once parsing reaches its beginning
+    // right after a separator, and otherwise parsing continues sequentially
+    size_t next = 0;
+    auto resume = [&](detail::top_level_statements& statements) {
+        while (true) {
+            while (next < segments.size() && begins[next + 1] < s.next) {
+                ++next;
+            }
+            if (next == segments.size() || begins[next + 1] != s.next) {
+                return false;
+            }
+            if (!detail::stitch(s, statements, segments[next++])) {
+                return true;
+            }
+        }
+    };
+    detail::parse_top_level(s, statements, resume);
+    return detail::make_root(s, statements);
 }
 
 } // namespace fp::syntax
@@ -1,14 +1,62 @@
 #pragma once
 
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <fp/lex/bracket_index.h>
+#include <fp/lex/retokenize.h>
 #include <fp/lex/tokenized_list.h>
 #include <fp/diagnostic/report.h>
 #include <fp/syntax/ast/node.h>
 
 namespace fp::syntax {
 
+/// Options of syntax::parse, syntax::reparse and syntax::parse_parallel.
+struct parsing_options {
+    /**
+     * The maximal nesting depth of the parsed expressions: the number of
+     * operands that may be parsed inside each other, e.g. 3 in `-{a = b}`
+     * (the operand of `-`, the contents of the block, and the RHS of `=`).
+     *
+     * When a statement is nested any deeper, an error is reported, and the
+     * rest of the input (from the beginning of the statement) is skipped as a
+     * single ast::error.
+     */
+    size_t max_nesting_depth = 1000;
+
+    /**
+     * Whether to only parse the outline of the input: blocks are parsed into
+     * ast::deferred_block nodes, which hold their tokens, and their contents
+     * are only parsed once they are accessed (see ast::deferred_block::parse).
+     * Until then, problems inside them aren't reported.
+     *
+     * The deferred blocks are parsed into the same ast::arena and report their
+     * problems to the same diagnostic::report, which must outlive them.
+     *
+     * Expanding all the deferred blocks gives the same AST as a full parse,
+     * except for malformed blocks: a block whose contents don't end right
+     * before its closing brace is parsed into an ast::error of the whole block,
+     * and a block that is nested too deeply only skips the rest of the block.
+     * Blocks whose braces are unmatched are never deferred.
+     */
+    bool outline = false;
+
+    /**
+     * The index of the brackets of the parsed tokens (e.g. from lex::tokenize),
+     * which is used to find the ends of deferred blocks (see `outline`). It
+     * must outlive the outline. If it's not given, the index is built once,
+     * and kept in the ast::arena of the outline.
+     */
+    const lex::bracket_index* brackets = nullptr;
+};
+
 /**
  * Constructs an AST from the given list of tokens.
  *
+ * All AST nodes are allocated in the given ast::arena, which must outlive the
+ * returned AST.
+ *
  * All encountered problems during syntax parsing will be reported to the given
  * diagnostic::report.
  *
@@ -16,6 +64,126 @@ namespace fp::syntax {
  *     Thrown when the maximum number of allowed errors is reached (as set by
  *     the given diagnostic::report).
  */
-ast::node parse(lex::tokenized_view, diagnostic::report&);
+ast::node parse(
+    lex::tokenized_view,
+    ast::arena&,
+    diagnostic::report&,
+    const parsing_options& = {}
+);
+
+/**
+ * The AST of lex::piecewise_tokens, whose top-level statements are stored in
+ * pieces, so that the statements that an edit doesn't change are shared with
+ * the ASTs of the previous versions of the source file rather than copied (see
+ * syntax::reparse).
+ *
+ * Each piece holds consecutive top-level statements, which are parsed from a
+ * single piece of tokens (that ends right after the separator of its last
+ * statement, unless it's the last piece), and whose nodes are allocated in the
+ * ast::arena of the piece. The deferred blocks of an outline (see
+ * parsing_options::outline) report their problems to the diagnostic::report
+ * that their piece was parsed with, which must outlive them.
+ */
+struct piecewise_ast {
+    struct piece {
+        lex::piecewise_tokens::piece          tokens;
+        std::shared_ptr<ast::arena>           arena;
+        std::span<const ast::node>            nodes;
+        std::span<const lex::token_iterator> separators;
+    };
+
+    /// The version of the source file that was parsed.
+    std::shared_ptr<const source_file> file;
+
+    std::vector<piece> pieces;
+
+    /// Whether the statements were parsed as an outline.
+    bool outline = false;
+
+    /// Returns the tokens of all the pieces (e.g. for lex::retokenize).
+    lex::piecewise_tokens tokens() const;
+
+    /// Returns the top-level statements of all the pieces.
+    std::vector<ast::node> statements() const;
+};
+
+/**
+ * Constructs a syntax::piecewise_ast from the given tokens. A single piece of
+ * tokens is parsed in place, and otherwise the tokens are copied into a single
+ * piece first (see lex::piecewise_tokens::copy). `options.brackets` is not
+ * used.
+ *
+ * @throws fp::compilation_error
+ *     Thrown when the maximum number of allowed errors is reached (as set by
+ *     the given diagnostic::report).
+ */
+piecewise_ast parse(
+    const lex::piecewise_tokens&,
+    diagnostic::report&,
+    const parsing_options& = {}
+);
+
+/**
+ * Constructs the AST of the tokens that lex::retokenize produced from the
+ * tokens of the `previous` AST (see piecewise_ast::tokens).
+ *
+ * The top-level statements of `previous` that are entirely before or after the
+ * re-tokenized tokens are reused: their pieces are shared (and moved by the
+ * edit) without being parsed or copied again. Only the statements in between
+ * are parsed, from a copy of their tokens, until reaching the beginning of a
+ * reused statement right after a separator. If parsing runs past the copied
+ * tokens (e.g. when an edit opens a block), it's retried with twice as many
+ * of the following statements.
+ *
+ * The result is the same as `parse(retokenized.tokens, report, options)`,
+ * except that problems are only reported for the parsed statements. If the
+ * `previous` AST wasn't parsed with the same parsing_options::outline, all
+ * the statements are parsed again.
+ *
+ * @throws fp::compilation_error
+ *     Thrown when the maximum number of allowed errors is reached (as set by
+ *     the given diagnostic::report).
+ */
+piecewise_ast reparse(
+    const piecewise_ast& previous,
+    const lex::retokenized_list& retokenized,
+    diagnostic::report&,
+    const parsing_options& = {}
+);
+
+/// Options of syntax::parse_parallel.
+struct parallel_parsing {
+    /// The number of threads (or the number of hardware threads, if 0).
+    size_t jobs = 0;
+
+    /**
+     * The minimal number of tokens in each segment that the input is split
+     * into. Input smaller than two segments is parsed sequentially.
+     */
+    size_t min_segment_size = 1 << 16;
+};
+
+/**
+ * Just like syntax::parse, but splits the top-level statements into segments
+ * that are parsed in parallel. The result (including the reported problems,
+ * in the same order) is identical to the result of syntax::parse.
+ *
+ * Segments begin right after semicolons that are outside of any brackets, and
+ * are speculatively parsed as if they begin a top-level statement. The
+ * segments are then stitched in order: the statements of each segment are used
+ * if the parsing of the segments before it reaches its beginning right after a
+ * top-level separator (from the same state, since top-level statements are
+ * independent). Otherwise (e.g. when an unmatched bracket changes the nesting),
+ * the input is parsed sequentially until reaching the next segment.
+ *
+ * All the AST nodes are moved into the given ast::arena.
+ */
+ast::node parse_parallel(
+    lex::tokenized_view,
+    ast::arena&,
+    diagnostic::report&,
+    const parallel_parsing& = {},
+    const parsing_options& = {}
+);
 
 } // namespace fp::syntax
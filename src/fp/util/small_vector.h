@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace fp::util {
+
+/**
+ * A vector that stores up to `N` elements inline (inside the object itself),
+ * and only allocates memory on the heap when it grows beyond that.
+ *
+ * This is useful for (usually) small, short-lived lists, like the frames of a
+ * stack that is rarely deeper than a few levels, which would otherwise
+ * allocate memory the first time any element is added.
+ *
+ * ~~~{.cpp}
+ * util::small_vector<int, 4> v;
+ * v.push_back(1); // no allocation
+ * v.push_back(2);
+ * for (int x : v) { ... }
+ * ~~~
+ *
+ * Elements are only ever constructed and destroyed (never assigned), so the
+ * element type only needs to be move-constructible. Like `std::vector`, any
+ * growth of the vector invalidates iterators and references to its elements.
+ */
+template <class T, size_t N>
+struct small_vector {
+    static_assert(N > 0, "use std::vector when there are no inline elements");
+
+    using value_type      = T;
+    using size_type       = size_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using iterator        = T*;
+    using const_iterator  = const T*;
+
+    small_vector() = default;
+
+    small_vector(std::initializer_list<T> elements) {
+        reserve(elements.size());
+        for (const T& e : elements) { push_back(e); }
+    }
+
+    small_vector(const small_vector& other) {
+        reserve(other.size());
+        std::uninitialized_copy(other.begin(), other.end(), data_);
+        size_ = other.size();
+    }
+
+    small_vector(small_vector&& other) noexcept { take(std::move(other)); }
+
+    small_vector& operator=(const small_vector& other) {
+        if (this == &other) { return *this; }
+        clear();
+        reserve(other.size());
+        std::uninitialized_copy(other.begin(), other.end(), data_);
+        size_ = other.size();
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept {
+        if (this == &other) { return *this; }
+        clear();
+        release();
+        take(std::move(other));
+        return *this;
+    }
+
+    ~small_vector() {
+        clear();
+        release();
+    }
+
+    size_t size()     const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool   empty()    const { return size_ == 0; }
+
+    /// Returns `true` if the elements are stored inline (not on the heap).
+    bool is_inline() const { return data_ == inline_data(); }
+
+    //@{
+    T*       data()       { return data_; }
+    const T* data() const { return data_; }
+
+    T*       begin()       { return data_; }
+    const T* begin() const { return data_; }
+    T*       end()         { return data_ + size_; }
+    const T* end()   const { return data_ + size_; }
+
+    T&       operator[](size_t i)       { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+    T&       front()       { return data_[0]; }
+    const T& front() const { return data_[0]; }
+    T&       back()        { return data_[size_ - 1]; }
+    const T& back()  const { return data_[size_ - 1]; }
+    //@}
+
+    /// Makes sure that at least `n` elements fit without another allocation.
+    void reserve(size_t n) {
+        if (n > capacity_) { grow(n); }
+    }
+
+    //@{
+    /// Appends an element to the end of the vector.
+    void push_back(const T& e) { emplace_back(e); }
+    void push_back(T&& e) { emplace_back(std::move(e)); }
+    //@}
+
+    /// Constructs an element in place at the end of the vector.
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            return grow_and_emplace_back(std::forward<Args>(args)...);
+        }
+        T* e = std::construct_at(data_ + size_, std::forward<Args>(args)...);
+        ++size_;
+        return *e;
+    }
+
+    /// Removes the last element. Undefined behaviour when empty.
+    void pop_back() {
+        --size_;
+        std::destroy_at(data_ + size_);
+    }
+
+    /// Removes all elements (but keeps the capacity).
+    void clear() {
+        std::destroy(begin(), end());
+        size_ = 0;
+    }
+
+private:
+    T* data_ = inline_data();
+    size_t size_ = 0;
+    size_t capacity_ = N;
+    alignas(T) std::byte inline_storage[N * sizeof(T)];
+
+    T* inline_data() {
+        return std::launder(reinterpret_cast<T*>(inline_storage));
+    }
+    const T* inline_data() const {
+        return std::launder(reinterpret_cast<const T*>(inline_storage));
+    }
+
+    /// Moves the elements to a new heap buffer of the given capacity.
+    void grow(size_t capacity) {
+        move_to(std::allocator<T>().allocate(capacity), capacity);
+    }
+
+    /**
+     * Just like emplace_back, when the vector is full. The new element is
+     * constructed before the elements are moved to the new buffer, since
+     * `args` may refer to them (e.g. `v.push_back(v[0])`).
+     */
+    template <class... Args>
+    T& grow_and_emplace_back(Args&&... args) {
+        size_t capacity = 2 * capacity_;
+        T* data = std::allocator<T>().allocate(capacity);
+        T* e;
+        try {
+            e = std::construct_at(data + size_, std::forward<Args>(args)...);
+        } catch (...) {
+            std::allocator<T>().deallocate(data, capacity);
+            throw;
+        }
+        move_to(data, capacity);
+        ++size_;
+        return *e;
+    }
+
+    /// Moves the elements to the given (new) heap buffer.
+    void move_to(T* data, size_t capacity) {
+        std::uninitialized_move(begin(), end(), data);
+        std::destroy(begin(), end());
+        release();
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    /// Deallocates the heap buffer (if any) of the (empty) vector.
+    void release() {
+        if (!is_inline()) {
+            std::allocator<T>().deallocate(data_, capacity_);
+            data_ = inline_data();
+            capacity_ = N;
+        }
+    }
+
+    /**
+     * Takes the elements of `other`, leaving it empty. This vector must be
+     * empty and inline.
+     */
+    void take(small_vector&& other) {
+        if (other.is_inline()) {
+            std::uninitialized_move(other.begin(), other.end(), data_);
+            size_ = other.size_;
+            other.clear();
+            return;
+        }
+        data_ = std::exchange(other.data_, other.inline_data());
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, N);
+    }
+};
+
+} // namespace fp::util
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <utility>
+
+#include <fp/util/assert.h>
+
+#include "thread_pool.h"
+
+namespace fp::util {
+
+namespace detail {
+
+/// The pool (and worker index) that owns the current thread, if any.
+thread_local const thread_pool* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+
+} // namespace detail
+
+thread_pool::thread_pool(size_t n_threads) {
+    if (n_threads == 0) {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    queues.reserve(n_threads);
+    for (size_t i = 0; i < n_threads; ++i) {
+        queues.push_back(std::make_unique<task_queue>());
+    }
+    threads.reserve(n_threads);
+    for (size_t i = 0; i < n_threads; ++i) {
+        threads.emplace_back([this, i]() { work(i); });
+    }
+}
+
+thread_pool::~thread_pool() {
+    finish();
+    {
+        std::lock_guard lock(idle_mutex);
+        stopping = true;
+    }
+    idle.notify_all();
+    for (std::thread& thread : threads) { thread.join(); }
+}
+
+void thread_pool::submit(std::function<void()> task) {
+    size_t index = detail::current_pool == this
+        ? detail::current_worker
+        : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    // counted before it's queued, so that the counters are never lower than
+    // the tasks in the queues (and a thread waiting for them can't miss it)
+    ++n_unfinished;
+    ++n_queued;
+    {
+        std::lock_guard lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    wake(false);
+}
+
+void thread_pool::wait() {
+    FP_ASSERT(
+        detail::current_pool != this,
+        "thread_pool::wait is called from a task of the same pool, which "
+        "would wait for the task itself to finish"
+    );
+    finish();
+    std::exception_ptr task_error;
+    {
+        std::lock_guard lock(error_mutex);
+        task_error = std::exchange(error, nullptr);
+    }
+    if (task_error) { std::rethrow_exception(task_error); }
+}
+
+std::function<void()> thread_pool::take_task(size_t index) {
+    std::function<void()> task;
+    for (size_t i = 0; i < queues.size() && !task; ++i) {
+        task_queue& queue = *queues[(index + i) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) { continue; }
+        if (i == 0) {
+            // own queue
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            // steal the oldest task, which is the least likely to be related
+            // to the tasks that the other worker is currently running
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (task) { --n_queued; }
+    return task;
+}
+
+template <class Predicate>
+void thread_pool::sleep_until(Predicate ready) {
+    std::unique_lock lock(idle_mutex);
+    // counted before checking `ready()`, see thread_pool::wake
+    ++n_sleeping;
+    idle.wait(lock, ready);
+    --n_sleeping;
+}
+
+void thread_pool::wake(bool all) {
+    // The counters were changed before checking for sleeping threads, so a
+    // thread that isn't counted yet will see the change once it checks them.
+    // A thread that is counted either sleeps already, or still holds the
+    // mutex until it does, so the notification can't get lost.
+    if (n_sleeping == 0) { return; }
+    { std::lock_guard lock(idle_mutex); }
+    if (all) {
+        idle.notify_all();
+    } else {
+        idle.notify_one();
+    }
+}
+
+void thread_pool::run(std::function<void()> task) {
+    std::exception_ptr task_error;
+    try {
+        task();
+    } catch (...) {
+        task_error = std::current_exception();
+    }
+    if (task_error) {
+        std::lock_guard lock(error_mutex);
+        if (!error) { error = task_error; }
+    }
+    if (--n_unfinished == 0) { wake(true); }
+}
+
+void thread_pool::finish() {
+    while (n_unfinished > 0) {
+        if (std::function<void()> task = take_task(0)) {
+            run(std::move(task));
+            continue;
+        }
+        sleep_until([this]() { return n_queued > 0 || n_unfinished == 0; });
+    }
+}
+
+void thread_pool::work(size_t index) {
+    detail::current_pool = this;
+    detail::current_worker = index;
+    while (!stopping) {
+        if (std::function<void()> task = take_task(index)) {
+            run(std::move(task));
+            continue;
+        }
+        sleep_until([this]() { return stopping || n_queued > 0; });
+    }
+}
+
+} // namespace fp::util
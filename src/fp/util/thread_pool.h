@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fp::util {
+
+/**
+ * A fixed-size pool of worker threads that run submitted tasks.
+ *
+ * Each worker owns a queue of tasks. Workers run tasks from the back of their
+ * own queue, and when it is empty they steal tasks from the front of the queues
+ * of other workers. Tasks submitted from a worker are added to its own queue,
+ * and tasks submitted from other threads are spread over all the queues.
+ *
+ * ~~~{.cpp}
+ * util::thread_pool pool(4);
+ * for (auto& file : files) {
+ *     pool.submit([&file]() { process(file); });
+ * }
+ * pool.wait(); // all files are processed after this
+ * ~~~
+ */
+struct thread_pool {
+    /**
+     * Starts a pool of `n_threads` worker threads. If `n_threads` is 0, the
+     * number of hardware threads is used.
+     */
+    explicit thread_pool(size_t n_threads = 0);
+
+    /// Waits for all submitted tasks to finish, and stops the worker threads.
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// Returns the number of worker threads.
+    size_t size() const { return threads.size(); }
+
+    /// Schedules the given task to run on one of the worker threads.
+    void submit(std::function<void()> task);
+
+    /**
+     * Blocks until all submitted tasks have finished running. The calling
+     * thread runs queued tasks too while it waits, rather than only sleeping.
+     *
+     * It must not be called from a task of the same pool, which would wait for
+     * its own task to finish.
+     *
+     * @throws
+     *     The first exception that was thrown by a task (since the last call to
+     *     thread_pool::wait), if any.
+     */
+    void wait();
+
+private:
+    struct task_queue {
+        std::mutex                        mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    /// The main loop of the worker thread with the given index.
+    void work(size_t index);
+
+    /**
+     * Pops a task from the queue of worker `index`, or steals one from another
+     * worker. Returns an empty function if all queues are empty.
+     */
+    std::function<void()> take_task(size_t index);
+
+    /// Runs a task that was taken from the queues, and counts it as finished.
+    void run(std::function<void()> task);
+
+    /// Runs queued tasks (or sleeps) until all tasks have finished.
+    void finish();
+
+    /// Sleeps on `idle` until `ready()` (which is checked under `idle_mutex`).
+    template <class Predicate>
+    void sleep_until(Predicate ready);
+
+    /// Wakes up one (or `all`) of the threads sleeping on `idle`, if any.
+    void wake(bool all);
+
+    std::vector<std::unique_ptr<task_queue>> queues;
+    std::vector<std::thread>                 threads;
+
+    // Submitting, taking and finishing tasks only update the counters below,
+    // and never take a lock of the whole pool. The counters are sequentially
+    // consistent, so that a thread that is going to sleep either sees a change
+    // of the counters, or is seen in `n_sleeping` by the thread that changed
+    // them (which then wakes it up).
+
+    /// Number of tasks in the queues (may be momentarily higher).
+    std::atomic<size_t> n_queued = 0;
+
+    /// Number of tasks that have been submitted but have not finished yet.
+    std::atomic<size_t> n_unfinished = 0;
+
+    /// The queue to which the next task from a non-worker thread is added.
+    std::atomic<size_t> next_queue = 0;
+
+    /// Number of threads that are sleeping (or going to sleep) on `idle`.
+    std::atomic<size_t> n_sleeping = 0;
+
+    std::atomic<bool> stopping = false;
+
+    /// Only guards sleeping on `idle`.
+    std::mutex idle_mutex;
+
+    /**
+     * Notified when tasks are queued, when all tasks have finished, or when
+     * the pool is stopping (see thread_pool::wake).
+     */
+    std::condition_variable idle;
+
+    /// Guards `error`.
+    std::mutex error_mutex;
+
+    /// The first exception thrown by a task, see thread_pool::wait.
+    std::exception_ptr error;
+};
+
+} // namespace fp::util
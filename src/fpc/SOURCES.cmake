@@ -1,6 +1,6 @@
 # automatically generated by `glob_sources()`
 set(
     SOURCES
-    temp.cpp
+    main.cpp
     PARENT_SCOPE
 )
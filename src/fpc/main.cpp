@@ -0,0 +1,22 @@
+#include <iostream>
+#include <stdexcept>
+
+#include <fp/diagnostic/print/to_terminal.h>
+#include <fp/driver/driver.h>
+
+using namespace fp;
+
+int main(int argc, const char* argv[]) {
+    driver::options options;
+    try {
+        options = driver::parse_arguments({argv + 1, size_t(argc - 1)});
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "fpc: " << e.what() << '\n'
+                  << "usage: fpc [--jobs N] <files...>" << std::endl;
+        return 2;
+    }
+
+    driver::result result = driver::run(options);
+    diagnostic::print::to_terminal(std::cerr, result.report);
+    return result.succeeded() ? 0 : 1;
+}
@@ -1,15 +1,34 @@
 # automatically generated by `glob_sources()`
 set(
     SOURCES
+    driver/driver.cpp
     include/test-util/assert_macro_eq.h
     include/test-util/assert_type_eq.h
+    lex/bracket_index.cpp
     lex/character_literal.cpp
+    lex/keywords.cpp
+    lex/number_literals.cpp
+    lex/retokenize.cpp
+    lex/scan.cpp
     lex/single_tokens.cpp
     lex/stray_characters.cpp
+    lex/token_cursor.cpp
+    lex/token_stream.cpp
+    lex/tokenize_parallel.cpp
     lex/unicode_characters.cpp
+    source_code.cpp
+    source_map.cpp
+    symbol_table.cpp
+    syntax/arena.cpp
+    syntax/parse.cpp
+    syntax/parse_outline.cpp
+    syntax/parse_parallel.cpp
+    syntax/reparse.cpp
     util/context_value.cpp
     util/match.cpp
+    util/small_vector.cpp
     util/table.cpp
+    util/thread_pool.cpp
     util/type_name.cpp
     PARENT_SCOPE
 )
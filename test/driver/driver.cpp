@@ -0,0 +1,83 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <fp/diagnostic/print/to_terminal.h>
+#include <fp/driver/driver.h>
+
+namespace fp::driver {
+
+static std::vector<std::unique_ptr<source_file>> make_files(size_t n) {
+    std::vector<std::unique_ptr<source_file>> files;
+    for (size_t i = 0; i < n; ++i) {
+        std::string content = "x + " + std::to_string(i);
+        // some files are much larger than others, and some contain errors
+        for (size_t j = 0; j < (i % 7) * 100; ++j) { content += " + y * 2"; }
+        if (i % 3 == 0) { content += " + 'unterminated\n"; }
+        if (i % 5 == 0) { content += " + \"unterminated\n"; }
+        files.push_back(std::make_unique<source_file>(
+            "file" + std::to_string(i) + ".fp", std::move(content)
+        ));
+    }
+    return files;
+}
+
+static std::string print_report(const diagnostic::report& report) {
+    std::ostringstream os;
+    diagnostic::print::to_terminal(os, report);
+    return os.str();
+}
+
+TEST(driver, run_merges_reports_deterministically) {
+    result sequential = run(make_files(50), 1);
+    ASSERT_EQ(sequential.files.size(), 50);
+    ASSERT_FALSE(sequential.succeeded());
+
+    size_t n_errors = 0;
+    for (size_t i = 0; i < sequential.files.size(); ++i) {
+        const file_result& file = sequential.files[i];
+        ASSERT_EQ(file.file->name, "file" + std::to_string(i) + ".fp");
+        ASSERT_TRUE(file.ast.has_value());
+        ASSERT_EQ(file.report.errors().empty(), i % 3 != 0 && i % 5 != 0);
+        n_errors += file.report.errors().size();
+    }
+    ASSERT_EQ(sequential.report.errors().size(), n_errors);
+
+    for (size_t jobs : {2, 4, 8}) {
+        result parallel = run(make_files(50), jobs);
+        ASSERT_EQ(print_report(parallel.report),
+                  print_report(sequential.report)) << jobs;
+    }
+}
+
+TEST(driver, run_reports_unreadable_files) {
+    options opts = parse_arguments(std::vector<const char*>{
+        "--jobs", "2", "does/not/exist.fp"
+    });
+    result r = run(opts);
+    ASSERT_EQ(r.files.size(), 1);
+    ASSERT_EQ(r.files[0].file, nullptr);
+    ASSERT_EQ(r.report.errors().size(), 1);
+    ASSERT_EQ(
+        r.report.errors().front().text(),
+        "cannot open `does/not/exist.fp`: No such file or directory"
+    );
+}
+
+TEST(driver, parse_arguments) {
+    options opts = parse_arguments(std::vector<const char*>{
+        "a.fp", "-j", "3", "b.fp", "--jobs=12", "c.fp"
+    });
+    ASSERT_EQ(opts.jobs, 12);
+    ASSERT_EQ(opts.files, (std::vector<std::string>{"a.fp", "b.fp", "c.fp"}));
+
+    ASSERT_EQ(parse_arguments(std::vector<const char*>{}).jobs, 0);
+
+    using args = std::vector<const char*>;
+    ASSERT_THROW(parse_arguments(args{"--jobs"}), std::invalid_argument);
+    ASSERT_THROW(parse_arguments(args{"--jobs=x"}), std::invalid_argument);
+    ASSERT_THROW(parse_arguments(args{"-j", "3x"}), std::invalid_argument);
+    ASSERT_THROW(parse_arguments(args{"--fast"}), std::invalid_argument);
+}
+
+} // namespace fp::driver
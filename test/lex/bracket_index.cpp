@@ -0,0 +1,82 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fp/lex/bracket_index.h>
+#include <fp/lex/tokenize.h>
+
+namespace fp::lex {
+
+constexpr size_t unmatched = bracket_index::unmatched;
+
+/**
+ * Returns the index of the brackets of `content`, after asserting that it's
+ * the same when it's built separately from the tokens.
+ */
+static bracket_index brackets_of(const std::string& content) {
+    source_file file("", content);
+    diagnostic::report report;
+    symbol_table symbols;
+    bracket_index brackets;
+    tokenized_list tokens = tokenize(file, report, brackets, symbols);
+
+    bracket_index expected(tokens);
+    EXPECT_EQ(brackets.size(), tokens.size()) << content;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        EXPECT_EQ(brackets[i], expected[i]) << content << " at " << i;
+    }
+    EXPECT_EQ(brackets.unmatched_brackets(), expected.unmatched_brackets());
+    return brackets;
+}
+
+TEST(lex, bracket_index_matches_brackets) {
+    // f ( a [ 1 ] , { b } ) + { }
+    // 0 1 2 3 4 5 6 7 8 9 10 11 12 13
+    bracket_index brackets = brackets_of("f(a[1], {b}) + {}");
+    const std::vector<size_t> expected = {
+        unmatched, 10, unmatched, 5, unmatched, 3, unmatched, 9, unmatched, 7,
+        1, unmatched, 13, 12
+    };
+    ASSERT_EQ(brackets.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(brackets[i], expected[i]) << i;
+    }
+    ASSERT_TRUE(brackets.unmatched_brackets().empty());
+}
+
+TEST(lex, bracket_index_unmatched_brackets) {
+    // the `(` and `[` inside the block are left unmatched
+    bracket_index block = brackets_of("{ ( [ }");
+    ASSERT_EQ(block[0], 3);
+    ASSERT_EQ(block[3], 0);
+    ASSERT_EQ(block[1], unmatched);
+    ASSERT_EQ(block.unmatched_brackets(), (std::vector<size_t>{1, 2}));
+
+    // a closing bracket without an open bracket of its kind
+    bracket_index closing = brackets_of(") { ] }");
+    ASSERT_EQ(closing[1], 3);
+    ASSERT_EQ(closing.unmatched_brackets(), (std::vector<size_t>{0, 2}));
+
+    // open brackets at the end of the input
+    bracket_index open = brackets_of("{ a; ( b )");
+    ASSERT_EQ(open[3], 5);
+    ASSERT_EQ(open.unmatched_brackets(), (std::vector<size_t>{0}));
+
+    // the braces of string interpolations are matched too
+    bracket_index string = brackets_of("\"a {b} c\" }");
+    ASSERT_EQ(string.unmatched_brackets().size(), 1);
+    ASSERT_EQ(string.unmatched_brackets().back(), string.size() - 1);
+}
+
+TEST(lex, bracket_index_deep_nesting) {
+    std::string content(100000, '(');
+    content += std::string(100000, ']');
+    content += std::string(100000, ')');
+    bracket_index brackets = brackets_of(content);
+    ASSERT_EQ(brackets[0], content.size() - 1);
+    ASSERT_EQ(brackets[99999], 200000);
+    ASSERT_EQ(brackets.unmatched_brackets().size(), 100000);
+}
+
+} // namespace fp::lex
@@ -13,4 +13,19 @@ TEST(lex, character_literal) {
 
 }
 
+TEST(lex, character_literal_escaped_backslash) {
+    // the quote after an escaped backslash terminates the literal
+    source_file file("", "'\\\\' '\\''");
+    diagnostic::report report;
+    symbol_table symbols;
+    tokenized_list tokens = tokenize(file, report, symbols);
+    if (!report.errors().empty()) {
+        diagnostic::print::to_terminal(std::cout, report);
+        FAIL();
+    }
+    ASSERT_EQ(tokens.size(), 2);
+    ASSERT_EQ(tokens[0].get_attribute<token::CHAR>(), U'\\');
+    ASSERT_EQ(tokens[1].get_attribute<token::CHAR>(), U'\'');
+}
+
 } // namespace fp::lex
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include <fp/lex/keywords.h>
+
+namespace fp::lex {
+
+static_assert(find_keyword("while") == token::WHILE);
+static_assert(!find_keyword("whilst"));
+static_assert(is_keyword(token::AND));
+static_assert(!is_keyword(token::IDENTIFIER));
+
+TEST(lex, find_keyword) {
+    for (const keyword& k : keywords) {
+        ASSERT_EQ(find_keyword(k.name), k.token) << k.name;
+        ASSERT_TRUE(is_keyword(k.token)) << k.name;
+
+        // same hash components, but not a keyword
+        std::string name(k.name);
+        name.insert(1, k.name.size() == 2 ? "_" : "");
+        name[name.size() / 2] = '$';
+        ASSERT_EQ(find_keyword(name), std::nullopt) << name;
+
+        ASSERT_EQ(find_keyword("_" + std::string(k.name)), std::nullopt);
+        ASSERT_EQ(find_keyword(std::string(k.name) + "s"), std::nullopt);
+    }
+    ASSERT_EQ(find_keyword("x"), std::nullopt);
+    ASSERT_EQ(find_keyword("IF"), std::nullopt);
+    ASSERT_EQ(find_keyword("implicitly"), std::nullopt);
+}
+
+TEST(lex, is_keyword) {
+    size_t n_keywords = 0;
+    for (size_t i = 0; i < n_tokens; ++i) {
+        n_keywords += is_keyword(token(i));
+    }
+    ASSERT_EQ(n_keywords, keywords.size());
+}
+
+} // namespace fp::lex
@@ -0,0 +1,231 @@
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include <fp/lex/tokenize.h>
+
+namespace fp::lex {
+
+/// Returns the value of the single number literal in `source_str`.
+static number_t number_value(std::string_view source_str) {
+    source_file file("", source_str);
+    diagnostic::report report;
+    symbol_table symbols;
+    tokenized_list tokens = tokenize(file, report, symbols);
+    EXPECT_TRUE(report.errors().empty()) << source_str;
+    EXPECT_EQ(tokens.size(), 1) << source_str;
+    EXPECT_EQ(tokens[0].token, token::NUMBER) << source_str;
+    EXPECT_FALSE(tokens[0].dummy) << source_str;
+    return tokens[0].get_attribute<token::NUMBER>();
+}
+
+static void assert_integer(std::string_view source_str, uint64_t expected) {
+    number_t value = number_value(source_str);
+    ASSERT_FALSE(value.is_float) << source_str;
+    ASSERT_EQ(value.integer, expected) << source_str;
+    ASSERT_EQ(value.big, nullptr) << source_str;
+}
+
+static void assert_float(std::string_view source_str, double expected) {
+    number_t value = number_value(source_str);
+    ASSERT_TRUE(value.is_float) << source_str;
+    ASSERT_EQ(value.floating, expected) << source_str;
+    ASSERT_EQ(value.big, nullptr) << source_str;
+}
+
+/**
+ * Asserts that the single number literal in `source_str` is invalid, and that
+ * the reported problem is `text`, at `section` (its last occurrence in
+ * `source_str`).
+ */
+static void assert_invalid(
+    std::string_view source_str,
+    std::string_view section,
+    std::string_view text
+) {
+    source_file file("", source_str);
+    diagnostic::report report;
+    symbol_table symbols;
+    tokenized_list tokens = tokenize(file, report, symbols);
+    ASSERT_EQ(tokens.size(), 1) << source_str;
+    ASSERT_TRUE(tokens[0].dummy) << source_str;
+    ASSERT_EQ(report.errors().size(), 1) << source_str;
+    const diagnostic::location& primary =
+        report.errors().front().locations().front();
+    ASSERT_EQ(primary.kind, diagnostic::location_kind::PRIMARY) << source_str;
+    ASSERT_EQ(primary.text, text) << source_str;
+    ASSERT_EQ(
+        primary.source_location.chars.data() - file.content.data(),
+        source_str.rfind(section)
+    ) << source_str;
+    ASSERT_EQ(primary.source_location.chars.size(), section.size())
+        << source_str;
+}
+
+/// Returns the single error reported when tokenizing `source_str`.
+static diagnostic::problem single_error(std::string_view source_str) {
+    source_file file("", source_str);
+    diagnostic::report report;
+    symbol_table symbols;
+    tokenized_list tokens = tokenize(file, report, symbols);
+    EXPECT_EQ(tokens.size(), 1) << source_str;
+    EXPECT_TRUE(tokens[0].dummy) << source_str;
+    EXPECT_EQ(report.errors().size(), 1) << source_str;
+    return report.errors().front();
+}
+
+TEST(lex, integer_literals) {
+    assert_integer("0", 0);
+    assert_integer("42", 42);
+    assert_integer("1'000'000", 1000000);
+    assert_integer("0x1F", 31);
+    assert_integer("0xdead'BEEF", 0xDEADBEEF);
+    assert_integer("0o17", 15);
+    assert_integer("0b1010", 10);
+    assert_integer("18446744073709551615", 18446744073709551615u);
+    assert_integer("0xFFFF'FFFF'FFFF'FFFF", 18446744073709551615u);
+}
+
+TEST(lex, float_literals) {
+    assert_float("1.5", 1.5);
+    assert_float("0.25", 0.25);
+    assert_float("1e3", 1000.0);
+    assert_float("1'0.2'5e1", 102.5);
+    assert_float("6.02e-23", 6.02e-23);
+    assert_float("1E+2", 100.0);
+    assert_float("0x1.8p3", 12.0);
+    assert_float("0x10p-4", 1.0);
+    assert_float("0xA.8", 10.5);
+}
+
+TEST(lex, big_number_literals) {
+    number_t integer = number_value("18446744073709551616"); // 2^64
+    ASSERT_FALSE(integer.is_float);
+    ASSERT_EQ(integer.integer, 0); // lowest 64 bits
+    ASSERT_NE(integer.big, nullptr);
+    ASSERT_EQ(integer.big->mantissa, (std::vector<uint32_t>{0, 0, 1}));
+    ASSERT_EQ(integer.big->exponent, 0);
+
+    number_t large = number_value("1'2.5e400");
+    ASSERT_TRUE(large.is_float);
+    ASSERT_EQ(large.floating, std::numeric_limits<double>::infinity());
+    ASSERT_NE(large.big, nullptr);
+    ASSERT_EQ(large.big->mantissa, std::vector<uint32_t>{125});
+    ASSERT_EQ(large.big->exponent, 399);
+    ASSERT_EQ(large.big->radix, 10);
+
+    number_t small = number_value("0x1p-2000");
+    ASSERT_TRUE(small.is_float);
+    ASSERT_EQ(small.floating, 0.0);
+    ASSERT_NE(small.big, nullptr);
+    ASSERT_EQ(small.big->mantissa, std::vector<uint32_t>{1});
+    ASSERT_EQ(small.big->exponent, -2000);
+    ASSERT_EQ(small.big->radix, 2);
+}
+
+TEST(lex, invalid_number_literals) {
+    assert_invalid("1e2.5", ".", "decimal-point in exponent");
+    assert_invalid("1.2.3", ".", "more than one decimal point in number");
+    assert_invalid("1'e5", "'", "digit-separator adjacent to exponent");
+    assert_invalid("1e+'5", "'", "digit-separator adjacent to exponent");
+    assert_invalid("1''0", "''", "adjacent digit-separators in number");
+    assert_invalid("1'.5", "'", "digit-separator adjacent to decimal-point");
+    assert_invalid("10'", "'", "digit-separator at the end of a number");
+    assert_invalid("1e", "e", "exponent has no digits");
+    assert_invalid("1e+", "e+", "exponent has no digits");
+    assert_invalid("1e5z", "z", "non-decimal digit in exponent");
+    assert_invalid("1_0", "_", "underscore in number");
+    assert_invalid("12a", "a", "non-decimal digit in decimal number");
+    assert_invalid("0b102", "2", "non-binary digit in binary number");
+    assert_invalid("0o8", "8", "non-octal digit in octal number");
+    assert_invalid("0xfg", "g", "non-hexadecimal digit in hexadecimal number");
+    assert_invalid("0x", "0x", "number has no digits");
+
+    // only the problem with the highest priority is reported
+    assert_invalid("1_2.3.4", ".", "more than one decimal point in number");
+    assert_invalid("1a_2", "_", "underscore in number");
+    assert_invalid("1e5_.", ".", "decimal-point in exponent");
+}
+
+TEST(lex, typed_number_literals) {
+    auto assert_kind = [](std::string_view source_str, number_kind kind) {
+        ASSERT_EQ(number_value(source_str).kind, kind) << source_str;
+    };
+    assert_kind("42", number_kind::INTEGER);
+    assert_kind("4.2", number_kind::FLOAT);
+    assert_kind("42e10", number_kind::FLOAT);
+    assert_kind("42`i8", number_kind::I8);
+    assert_kind("42`i16", number_kind::I16);
+    assert_kind("42`i32", number_kind::I32);
+    assert_kind("42`i64", number_kind::I64);
+    assert_kind("42`u", number_kind::U64);
+    assert_kind("42`u8", number_kind::U8);
+    assert_kind("42`u16", number_kind::U16);
+    assert_kind("42`u32", number_kind::U32);
+    assert_kind("42`u64", number_kind::U64);
+    assert_kind("42`f", number_kind::F64);
+    assert_kind("42`f32", number_kind::F32);
+    assert_kind("4.2`f64", number_kind::F64);
+    assert_kind("0xFF`u16", number_kind::U16);
+    assert_kind("0b11`i32", number_kind::I32);
+
+    // the value of integers with floating-point suffixes is a floating-point
+    number_t value = number_value("0x10`f32");
+    ASSERT_TRUE(value.is_float);
+    ASSERT_EQ(value.floating, 16.0);
+
+    assert_integer("127`i8", 127);
+    assert_integer("0xFFFF'FFFF`u32", 0xFFFFFFFF);
+    assert_integer("9'223'372'036'854'775'807`i64", INT64_MAX);
+    assert_integer("18446744073709551615`u", UINT64_MAX);
+
+    // a backtick that isn't followed by a letter is not a part of the literal
+    source_file file("", "42`1");
+    diagnostic::report report;
+    symbol_table symbols;
+    ASSERT_EQ(tokenize(file, report, symbols).size(), 3);
+}
+
+TEST(lex, invalid_typed_number_literals) {
+    auto assert_error = [](
+        std::string_view source_str,
+        std::string_view code,
+        std::string_view text
+    ) {
+        diagnostic::problem error = single_error(source_str);
+        ASSERT_EQ(error.error_code()->code, code) << source_str;
+        ASSERT_EQ(error.locations().front().text, text) << source_str;
+    };
+    assert_error("42`i7", "E0010", "unknown type suffix");
+    assert_error("42`x", "E0010", "unknown type suffix");
+    assert_error(
+        "4.2`i32", "E0010", "integer type suffix on floating-point literal"
+    );
+    assert_error(
+        "1e3`u", "E0010", "integer type suffix on floating-point literal"
+    );
+    assert_error(
+        "0b1`f32",
+        "E0008",
+        "floating-point literal in binary base is not supported"
+    );
+    assert_error("1_2`i8", "E0007", "underscore in number");
+    assert_error("128`i8", "E0011", "value is out of the range of i8");
+    assert_error("256`u8", "E0011", "value is out of the range of u8");
+    assert_error("0x1'0000`u16", "E0011", "value is out of the range of u16");
+    assert_error(
+        "0x8000'0000`i32", "E0011", "value is out of the range of i32"
+    );
+    assert_error(
+        "18446744073709551616`u64", "E0011", "value is out of the range of u64"
+    );
+    assert_error(
+        "18446744073709551616`u", "E0011", "value is out of the range of u64"
+    );
+    assert_error("1e39`f32", "E0011", "value is out of the range of f32");
+    assert_error("1e400`f", "E0011", "value is out of the range of f64");
+}
+
+} // namespace fp::lex
@@ -0,0 +1,170 @@
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fp/lex/retokenize.h>
+#include <fp/lex/tokenize.h>
+
+namespace fp::lex {
+
+/// Asserts that `t1` and `t2` are the same token, at the same offset.
+static void assert_same_tokens(
+    const tokenized_token& t1,
+    const tokenized_token& t2
+) {
+    ASSERT_EQ(t1.token, t2.token);
+    ASSERT_EQ(t1.dummy, t2.dummy) << t1.token;
+    ASSERT_EQ(t1.attribute, t2.attribute) << t1.token;
+    const auto& l1 = t1.source_location;
+    const auto& l2 = t2.source_location;
+    ASSERT_EQ(&l1.file, &l2.file) << t1.token;
+    ASSERT_EQ(l1.chars.data(), l2.chars.data()) << t1.token;
+    ASSERT_EQ(l1.chars.size(), l2.chars.size()) << t1.token;
+}
+
+/**
+ * Asserts that `tokens` are the same as the tokens of their whole file (with
+ * the symbols that they were tokenized with).
+ */
+static void assert_same_tokens(
+    const piecewise_tokens& tokens,
+    symbol_table& symbols
+) {
+    diagnostic::report report;
+    tokenized_list expanded = tokens.expand();
+    tokenized_list expected = tokenize(*tokens.file, report, symbols);
+    ASSERT_EQ(expanded.size(), expected.size()) << tokens.file->content;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        assert_same_tokens(expanded[i], expected[i]);
+    }
+}
+
+TEST(lex, retokenize_single_edit) {
+    auto file = std::make_shared<source_file>(
+        "", "a = 1; b = \"x{y}z\"; c = 'c'"
+    );
+    diagnostic::report report;
+    symbol_table symbols;
+    piecewise_tokens tokens(file, tokenize(*file, report, symbols));
+
+    source_edit edit{.offset = 14, .removed = 1, .inserted = "{\"w\"}"};
+    std::shared_ptr<const source_file> edited = file->edit(edit);
+    ASSERT_EQ(edited->content, "a = 1; b = \"x{{\"w\"}}z\"; c = 'c'");
+
+    retokenized_list r = retokenize(tokens, edited, edit, report, symbols);
+    assert_same_tokens(r.tokens, symbols);
+    size_t size = r.tokens.size();
+
+    // only the string `"x{y}z"` is re-tokenized
+    ASSERT_EQ(r.splice.begin, 6);
+    ASSERT_EQ(r.splice.previous_end, tokens.size() - 4);
+    ASSERT_EQ(r.splice.end, size - 4);
+    ASSERT_EQ(r.splice.shift, 4);
+
+    // the tokens around them are shared, and the re-tokenized ones refer to a
+    // section of the edited file
+    ASSERT_EQ(r.tokens.pieces.size(), 3);
+    ASSERT_EQ(r.tokens.pieces[0].run, tokens.pieces[0].run);
+    ASSERT_EQ(r.tokens.pieces[2].run, tokens.pieces[0].run);
+    ASSERT_EQ(r.tokens.pieces[2].offset, 4);
+    ASSERT_NE(&r.tokens.pieces[1].run->file->content, &edited->content);
+}
+
+TEST(lex, retokenize_section_lines) {
+    auto file = std::make_shared<source_file>("", "a;\nb = 1;\nc;\n");
+    diagnostic::report report;
+    symbol_table symbols;
+    piecewise_tokens tokens(file, tokenize(*file, report, symbols));
+
+    source_edit edit{.offset = 7, .removed = 1, .inserted = "23"};
+    std::shared_ptr<const source_file> edited = file->edit(edit);
+    retokenized_list r = retokenize(tokens, edited, edit, report, symbols);
+    assert_same_tokens(r.tokens, symbols);
+
+    ASSERT_EQ(r.tokens.pieces.size(), 3);
+    const piecewise_tokens::piece& retokenized = r.tokens.pieces[1];
+    const source_file& section = *retokenized.run->file;
+    ASSERT_EQ(section.content, "b = 23;\n");
+    ASSERT_EQ(section.first_offset, 3);
+    ASSERT_EQ(retokenized.offset, 3);
+    const source_location& number = retokenized.tokens()[2].source_location;
+    ASSERT_EQ(number.chars, "23");
+    ASSERT_EQ(number.offset(), 7);
+    ASSERT_EQ(number.line_number(), 2);
+    ASSERT_EQ(number.column(), 4);
+}
+
+TEST(lex, retokenize_split_code_point) {
+    // completing a UTF-8 sequence right after an identifier continues it
+    struct case_t { std::string content; source_edit edit; };
+    const std::vector<case_t> cases = {
+        {"ab\xE4\xB8+", {.offset = 4, .inserted = "\x80"}},
+        {"ab\xF0\xA0\x80+", {.offset = 5, .inserted = "\x80"}},
+        {"ab\xE4\xB8\x80+", {.offset = 4, .removed = 1}},
+        {"ab+", {.offset = 2, .inserted = "\xE4\xB8\x80"}}
+    };
+    for (const case_t& c : cases) {
+        auto file = std::make_shared<source_file>("", c.content);
+        diagnostic::report report;
+        symbol_table symbols;
+        piecewise_tokens tokens(file, tokenize(*file, report, symbols));
+        std::shared_ptr<const source_file> edited = file->edit(c.edit);
+
+        retokenized_list r =
+            retokenize(tokens, edited, c.edit, report, symbols);
+        assert_same_tokens(r.tokens, symbols);
+    }
+}
+
+TEST(lex, retokenize_matches_tokenize) {
+    const std::vector<std::string> insertions = {
+        "", " ", "\n", "x", "if", "1", "0x1.8p3", ".", "+", "=", ";", "'",
+        "'a'", "\"", "\"s\"", "{", "}", "\"a{b}c\"", "#", "# comment\n", "$",
+        "`", "`u8", "42`i8", "\u00E9", "\u4E00", "\U00020000", "\x80",
+        "\xE4", "\xB8\x80", "\xF0\xA0", "\x80\x80"
+    };
+    std::mt19937 random(1234);
+    auto uniform = [&](size_t n) {
+        return std::uniform_int_distribution<size_t>(0, n)(random);
+    };
+
+    std::shared_ptr<const source_file> file = std::make_shared<source_file>(
+        "", R"fp(
+x = "hello, {"from the {"other"} side"}!"; y = {a; b}; été = '一'
+𠀀x = é一𠀀
+# comment
+if x { 'c' } else { 0x1F + 1.5e10 }
+)fp"
+    );
+    diagnostic::report report;
+    symbol_table symbols;
+    piecewise_tokens tokens(file, tokenize(*file, report, symbols));
+
+    for (int i = 0; i < 500; ++i) {
+        diagnostic::report report;
+        size_t size = file->content.size();
+        size_t offset = uniform(size);
+        source_edit edit{
+            .offset = offset,
+            .removed = std::min(uniform(4), size - offset),
+            .inserted = insertions[uniform(insertions.size() - 1)]
+        };
+        std::shared_ptr<const source_file> edited = file->edit(edit);
+
+        retokenized_list r = retokenize(tokens, edited, edit, report, symbols);
+        assert_same_tokens(r.tokens, symbols);
+        ASSERT_LE(r.splice.begin, r.splice.end);
+        ASSERT_EQ(
+            r.tokens.size() - r.splice.end,
+            tokens.size() - r.splice.previous_end
+        );
+
+        file = std::move(edited);
+        tokens = std::move(r.tokens);
+    }
+}
+
+} // namespace fp::lex
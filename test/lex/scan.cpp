@@ -0,0 +1,69 @@
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <fp/lex/detail/scan.h>
+
+namespace fp::lex::detail {
+
+/// Checks that all kernels of `isa` agree with the scalar ones on `chars`.
+void assert_same_as_scalar(scan_isa isa, source_view chars) {
+    const scan_kernels* expected = get_scan_kernels(scan_isa::SCALAR);
+    const scan_kernels* actual = get_scan_kernels(isa);
+    if (!actual) { return; } // not supported by the running CPU
+    ASSERT_EQ(actual->whitespace(chars), expected->whitespace(chars));
+    ASSERT_EQ(actual->identifier(chars), expected->identifier(chars));
+    ASSERT_EQ(
+        actual->until_line_break(chars),
+        expected->until_line_break(chars)
+    );
+    ASSERT_EQ(actual->single_quoted(chars), expected->single_quoted(chars));
+    ASSERT_EQ(actual->double_quoted(chars), expected->double_quoted(chars));
+    ASSERT_EQ(actual->ascii(chars), expected->ascii(chars));
+}
+
+TEST(lex, scan_kernels_scalar) {
+    const scan_kernels& k = *get_scan_kernels(scan_isa::SCALAR);
+    EXPECT_EQ(k.whitespace(" \t\r\n\v\fx "), 6);
+    EXPECT_EQ(k.identifier("az_AZ09 x"), 7);
+    EXPECT_EQ(k.identifier("x\xc3\xa9"), 1);
+    EXPECT_EQ(k.until_line_break("abc\\ \r\n"), 5);
+    EXPECT_EQ(k.single_quoted("a\"{ '"), 4);
+    EXPECT_EQ(k.single_quoted("ab\\'"), 2);
+    EXPECT_EQ(k.double_quoted("a' {\""), 3);
+    EXPECT_EQ(k.double_quoted(""), 0);
+    EXPECT_EQ(k.whitespace("    "), 4);
+    EXPECT_EQ(k.ascii("a\x7f \xc3\xa9"), 3);
+    EXPECT_EQ(k.ascii("\x80"), 0);
+}
+
+TEST(lex, scan_kernels_match_scalar) {
+    // characters that are relevant to any of the kernels, plus some that are
+    // on the boundaries of the ranges they check
+    const std::string alphabet =
+        " \t\n\v\f\r\b\x0e\"'{\\_09azAZ/:@[`{\x7f\x80\xc3\xff";
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    for (scan_isa isa : {scan_isa::SSE2, scan_isa::AVX2}) {
+        for (size_t size = 0; size <= 100; ++size) {
+            for (size_t repeat = 0; repeat < 50; ++repeat) {
+                // a long run of a single character followed by random ones, so
+                // that runs end at all possible offsets within a vector
+                std::string chars(size, alphabet[pick(generator)]);
+                for (size_t i = 0; i < repeat % 4; ++i) {
+                    chars += alphabet[pick(generator)];
+                }
+                assert_same_as_scalar(isa, chars);
+                // the kernels must not look past the end of the view
+                assert_same_as_scalar(
+                    isa,
+                    source_view(chars).substr(0, chars.size() / 2)
+                );
+            }
+        }
+    }
+}
+
+} // namespace fp::lex::detail
@@ -9,9 +9,10 @@ template <token EXPECTED_TOKEN>
 void assert_single_token(std::string_view source_str) {
     std::string_view name = token_name(EXPECTED_TOKEN);
     diagnostic::report report;
+    symbol_table symbols;
     fp::source_file file("", source_str);
 
-    tokenized_list tokens = tokenize(file, report);
+    tokenized_list tokens = tokenize(file, report, symbols);
     if (!report.errors().empty() || !report.warnings().empty()) {
         diagnostic::print::to_terminal(std::cout, report);
         FAIL() << name;
@@ -35,10 +36,10 @@ void assert_single_token(std::string_view source_str) {
     )) << name;
 
     const auto& location = tokens[0].source_location;
-    ASSERT_EQ(file.content        , location.chars      ) << name;
-    ASSERT_EQ(file                , location.file       ) << name;
-    ASSERT_EQ(file.content.begin(), location.line       ) << name;
-    ASSERT_EQ(1u                  , location.line_number) << name;
+    ASSERT_EQ(file.content        , location.chars        ) << name;
+    ASSERT_EQ(file                , location.file         ) << name;
+    ASSERT_EQ(file.content.begin(), location.line()       ) << name;
+    ASSERT_EQ(1u                  , location.line_number()) << name;
 }
 
 TEST(lex, single_tokens) {
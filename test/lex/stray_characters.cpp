@@ -7,11 +7,12 @@ namespace fp::lex {
 
 void assert_stray_character(std::string_view source_str) {
     diagnostic::report report;
+    symbol_table symbols;
     fp::source_file file("", source_str);
 
     int16_t value = source_str[0];
 
-    tokenized_list tokens = tokenize(file, report);
+    tokenized_list tokens = tokenize(file, report, symbols);
     if (tokens.size() != 1 || tokens[0].token != token::ERROR) {
         diagnostic::print::to_terminal(std::cout, report);
         ASSERT_EQ(1u, tokens.size()) << "\n"
@@ -72,4 +73,74 @@ TEST(lex, stray_characters) {
     assert_stray_character("\177"); // DEL (delete)
 }
 
+TEST(lex, stray_character_runs) {
+    auto assert_run = [](
+        std::string_view source_str,
+        std::string_view run,
+        std::string_view text
+    ) {
+        diagnostic::report report;
+        symbol_table symbols;
+        source_file file("", source_str);
+        tokenized_list tokens = tokenize(file, report, symbols);
+        ASSERT_EQ(report.errors().size(), 1) << source_str;
+        const diagnostic::location& location =
+            report.errors().front().locations().front();
+        ASSERT_EQ(location.source_location.chars, run) << source_str;
+        ASSERT_EQ(location.text, text) << source_str;
+        size_t n_errors = 0;
+        for (const tokenized_token& t : tokens) {
+            if (t.token == token::ERROR) {
+                ++n_errors;
+                ASSERT_EQ(t.source_location.chars, run) << source_str;
+            }
+        }
+        ASSERT_EQ(n_errors, 1) << source_str;
+    };
+    assert_run("$", "$", "stray character");
+    assert_run("\1", "\1", "stray character: \\1");
+    assert_run("\177", "\177", "stray character: \\177");
+    assert_run("a $$\\` b", "$$\\`", "4 stray characters");
+    assert_run("x = \1\2\3;", "\1\2\3", "3 stray characters");
+    assert_run("$\u00A0\u2764 b", "$\u00A0\u2764", "3 stray characters");
+    assert_run(
+        "$\xFF\xFE$ b", "$\xFF\xFE$",
+        "4 stray characters and invalid UTF-8 sequences"
+    );
+    // identifiers end the run
+    assert_run("$$\u03C0", "$$", "2 stray characters");
+}
+
+TEST(lex, error_budget) {
+    std::string content;
+    for (size_t i = 0; i < 100; ++i) { content += "$ x "; }
+    source_file file("", content);
+
+    diagnostic::report report;
+    symbol_table symbols;
+    report.set_error_budget(10);
+    tokenized_list tokens = tokenize(file, report, symbols);
+    ASSERT_EQ(report.errors().size(), 11);
+    ASSERT_EQ(
+        report.errors().back().error_code(),
+        &error::E0013_too_many_errors
+    );
+    // the rest of the file (after the 10th `$`) is a single token
+    ASSERT_EQ(tokens.size(), 20);
+    ASSERT_EQ(tokens.back().token, token::ERROR);
+    ASSERT_EQ(
+        tokens.back().source_location.chars,
+        source_view(content).substr(4 * 9 + 1)
+    );
+    ASSERT_EQ(
+        report.errors().back().locations().front().source_location.offset(),
+        4 * 9 + 1
+    );
+
+    // the default budget
+    diagnostic::report default_report;
+    tokenize(file, default_report, symbols);
+    ASSERT_EQ(default_report.errors().size(), 100);
+}
+
 } // namespace fp::lex
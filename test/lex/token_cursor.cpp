@@ -0,0 +1,69 @@
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <fp/lex/token_cursor.h>
+#include <fp/lex/tokenize.h>
+
+namespace fp::lex {
+
+TEST(lex, token_cursor_matches_tokenize) {
+    fp::source_file file("", R"fp(
+# test, test, 1, 2, 3...
+'"' 'ab' ''
+"hello, {"from the other {"side of the plant"}..."}"
+0x1F 1.5e10 12z4 $ if x else y)fp" "\r\n\r" "a != b\n\"unterminated");
+
+    diagnostic::report list_report;
+    symbol_table symbols;
+    tokenized_list list = tokenize(file, list_report, symbols);
+
+    diagnostic::report cursor_report;
+    token_cursor cursor(file, cursor_report, symbols);
+    size_t i = 0;
+    for (const tokenized_token& t : cursor) {
+        ASSERT_LT(i, list.size());
+        ASSERT_EQ(t.token, list[i].token);
+        ASSERT_EQ(t.dummy, list[i].dummy);
+        ASSERT_EQ(t.attribute, list[i].attribute);
+        ASSERT_EQ(t.source_location.chars, list[i].source_location.chars);
+        ++i;
+    }
+    ASSERT_EQ(i, list.size());
+    ASSERT_EQ(cursor_report.errors().size(), list_report.errors().size());
+    ASSERT_TRUE(cursor.done());
+    ASSERT_EQ(cursor.peek(), nullptr);
+    ASSERT_THROW(cursor.next(), std::out_of_range);
+}
+
+TEST(lex, token_cursor_lookahead) {
+    fp::source_file file("", "a + b");
+    diagnostic::report report;
+    symbol_table symbols;
+    token_cursor cursor(file, report, symbols);
+    ASSERT_EQ(cursor.peek(2)->token, token::IDENTIFIER);
+    ASSERT_EQ(cursor.peek(3), nullptr);
+    ASSERT_EQ(cursor.peek(1)->token, token::ADD);
+    ASSERT_EQ(cursor.next().token, token::IDENTIFIER);
+    ASSERT_EQ(cursor.peek()->token, token::ADD);
+    ASSERT_EQ(cursor.buffered(), 2);
+}
+
+TEST(lex, token_cursor_memory_is_bounded_by_lookahead) {
+    std::string content;
+    for (int i = 0; i < 10000; ++i) { content += "x = \"{y}\" + 1; "; }
+    fp::source_file file("", content);
+    diagnostic::report report;
+    symbol_table symbols;
+    token_cursor cursor(file, report, symbols);
+    size_t tokens = 0;
+    while (cursor.peek(4)) {
+        cursor.next();
+        ++tokens;
+        ASSERT_LE(cursor.buffered(), 16);
+    }
+    ASSERT_GT(tokens, 10000);
+}
+
+} // namespace fp::lex
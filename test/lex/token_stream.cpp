@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <fp/diagnostic/print/to_terminal.h>
+#include <fp/lex/tokenize.h>
+#include <fp/lex/token_stream.h>
+
+namespace fp::lex {
+
+void assert_same_tokens(const tokenized_token& t1, const tokenized_token& t2) {
+    ASSERT_EQ(t1.token, t2.token);
+    ASSERT_EQ(t1.dummy, t2.dummy) << t1.token;
+    ASSERT_EQ(t1.attribute, t2.attribute) << t1.token;
+    const auto& l1 = t1.source_location;
+    const auto& l2 = t2.source_location;
+    ASSERT_EQ(l1.chars.begin(), l2.chars.begin()) << t1.token;
+    ASSERT_EQ(l1.chars.end()  , l2.chars.end()  ) << t1.token;
+    ASSERT_EQ(l1.file         , l2.file         ) << t1.token;
+}
+
+TEST(lex, token_stream_matches_tokenized_list) {
+    fp::source_file file("", R"fp(
+# test, test, 1, 2, 3...
+'"' 'ab' ''
+"hello, {"from the other {"side of the plant"}..."}"
+"look, {"a wild brace:" { 3 { 4 } 1 + 1 } "bla" }"
+0x1F 1.5e10 12z4 $ if x else y)fp" "\r\n\r" "a != b\n\"unterminated");
+
+    diagnostic::report list_report;
+    symbol_table symbols;
+    tokenized_list list = tokenize(file, list_report, symbols);
+
+    diagnostic::report stream_report;
+    token_stream stream = tokenize_to_stream(file, stream_report, symbols);
+
+    ASSERT_EQ(list.size(), stream.size());
+    ASSERT_EQ(list_report.errors().size(), stream_report.errors().size());
+    for (size_t i = 0; i < list.size(); ++i) {
+        ASSERT_EQ(list[i].token, stream.kind(i));
+        ASSERT_EQ(list[i].source_location.chars, stream.chars(i));
+        assert_same_tokens(list[i], stream[i]);
+    }
+
+    tokenized_list expanded = stream.expand();
+    ASSERT_EQ(list.size(), expanded.size());
+    for (size_t i = 0; i < list.size(); ++i) {
+        assert_same_tokens(list[i], expanded[i]);
+    }
+
+    token_stream compacted(file, list);
+    ASSERT_EQ(list.size(), compacted.size());
+    auto it = compacted.begin();
+    for (const auto& t : list) { assert_same_tokens(t, *it++); }
+    ASSERT_EQ(compacted.end(), it);
+}
+
+} // namespace fp::lex
@@ -0,0 +1,102 @@
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fp/diagnostic/print/to_terminal.h>
+#include <fp/lex/tokenize.h>
+
+namespace fp::lex {
+
+/// Returns the diagnostics of `report`, as printed to a terminal.
+static std::string printed(const diagnostic::report& report) {
+    std::ostringstream os;
+    diagnostic::print::to_terminal(os, report);
+    return os.str();
+}
+
+/**
+ * Asserts that tokenizing `file` in parallel (in chunks of `chunk_size`) has
+ * the same result as tokenizing it sequentially.
+ */
+static void assert_same_as_sequential(
+    const source_file& file,
+    size_t chunk_size,
+    size_t error_budget = diagnostic::report::default_error_budget
+) {
+    symbol_table sequential_symbols;
+    diagnostic::report sequential_report;
+    sequential_report.set_error_budget(error_budget);
+    tokenized_list expected =
+        tokenize(file, sequential_report, sequential_symbols);
+
+    symbol_table parallel_symbols;
+    diagnostic::report parallel_report;
+    parallel_report.set_error_budget(error_budget);
+    tokenized_list tokens = tokenize_parallel(
+        file,
+        parallel_report,
+        parallel_symbols,
+        {.jobs = 4, .min_chunk_size = chunk_size}
+    );
+
+    ASSERT_EQ(tokens.size(), expected.size()) << "chunk size " << chunk_size;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const tokenized_token& t1 = tokens[i];
+        const tokenized_token& t2 = expected[i];
+        ASSERT_EQ(t1.token, t2.token) << i;
+        ASSERT_EQ(t1.dummy, t2.dummy) << i;
+        ASSERT_EQ(t1.attribute, t2.attribute) << i;
+        const source_view& chars1 = t1.source_location.chars;
+        const source_view& chars2 = t2.source_location.chars;
+        ASSERT_EQ(chars1.data(), chars2.data()) << i;
+        ASSERT_EQ(chars1.size(), chars2.size()) << i;
+    }
+    ASSERT_EQ(parallel_symbols.size(), sequential_symbols.size());
+    ASSERT_EQ(printed(parallel_report), printed(sequential_report));
+}
+
+TEST(lex, tokenize_parallel_matches_tokenize) {
+    // lines that begin or end in the middle of strings and interpolations
+    const std::vector<std::string> lines = {
+        "x = 1 + 2.5e3; y = 0x1F`u8",
+        "s = \"hello, {name}!\"",
+        "t = \"multi-line {",
+        "    a + b; \"nested {c",
+        "    }\" } end\"",
+        "# a comment with \"quotes\" and {braces}",
+        "if x { y } else { z }",
+        "'c'; '\\n'; 'ab'; ''",
+        "\"unterminated",
+        "} } { {",
+        "$ @ ` 1_2 0b102",
+        "π = 3.14; größe = 1'000",
+        "\xE2\x82 invalid",
+        "",
+    };
+    std::mt19937 random(1234);
+    for (int trial = 0; trial < 20; ++trial) {
+        std::string content;
+        for (int i = 0; i < 200; ++i) {
+            content += lines[random() % lines.size()];
+            content += random() % 4 == 0 ? "\r\n" : "\n";
+        }
+        source_file file("", content);
+        for (size_t chunk_size : {1, 7, 64, 1000}) {
+            assert_same_as_sequential(file, chunk_size);
+            assert_same_as_sequential(file, chunk_size, 50);
+        }
+    }
+}
+
+TEST(lex, tokenize_parallel_small_source) {
+    // sources smaller than two chunks are tokenized sequentially
+    source_file file("", "a = 1");
+    assert_same_as_sequential(file, 1 << 20);
+    source_file empty("", "");
+    assert_same_as_sequential(empty, 1);
+}
+
+} // namespace fp::lex
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <fp/error_codes.h>
 #include <fp/diagnostic/print/to_terminal.h>
 #include <fp/lex/tokenize.h>
 
@@ -8,9 +9,10 @@ namespace fp::lex {
 TEST(lex, unicode_characters_not_supported) {
     for (char unicode_char = -128; unicode_char != 0; ++unicode_char) {
         diagnostic::report report;
+        symbol_table symbols;
         fp::source_file file("", std::string_view(&unicode_char, 1));
 
-        tokenized_list tokens = tokenize(file, report);
+        tokenized_list tokens = tokenize(file, report, symbols);
         if (tokens.size() != 1 || tokens[0].token != token::ERROR) {
             diagnostic::print::to_terminal(std::cout, report);
             ASSERT_EQ(1u, tokens.size()) << "\n"
@@ -29,4 +31,122 @@ TEST(lex, unicode_characters_not_supported) {
     }
 }
 
+/// Returns the value of the single character literal in `source_str`.
+static char_t char_value(std::string_view source_str) {
+    source_file file("", std::string(source_str));
+    diagnostic::report report;
+    symbol_table symbols;
+    tokenized_list tokens = tokenize(file, report, symbols);
+    EXPECT_TRUE(report.errors().empty()) << source_str;
+    EXPECT_EQ(tokens.size(), 1) << source_str;
+    return tokens[0].get_attribute<token::CHAR>();
+}
+
+/// Returns the text of the single error reported for `source_str`.
+static std::string single_error(std::string_view source_str) {
+    source_file file("", std::string(source_str));
+    diagnostic::report report;
+    symbol_table symbols;
+    tokenize(file, report, symbols);
+    EXPECT_EQ(report.errors().size(), 1) << source_str;
+    if (report.errors().empty()) { return ""; }
+    return report.errors().front().locations().front().text;
+}
+
+TEST(lex, unicode_identifiers) {
+    symbol_table symbols;
+    auto assert_identifier = [&](std::string_view source_str) {
+        source_file file("", std::string(source_str));
+        diagnostic::report report;
+        tokenized_list tokens = tokenize(file, report, symbols);
+        ASSERT_TRUE(report.errors().empty()) << source_str;
+        ASSERT_EQ(tokens.size(), 1) << source_str;
+        ASSERT_EQ(tokens[0].token, token::IDENTIFIER) << source_str;
+        ASSERT_EQ(
+            symbols[tokens[0].get_attribute<token::IDENTIFIER>()],
+            source_str
+        );
+    };
+    assert_identifier("π");
+    assert_identifier("größe");
+    assert_identifier("αβγ");
+    assert_identifier("日本語");
+    assert_identifier("café_2");
+    assert_identifier("Ωmega");
+
+    // combining marks (XID_Continue) cannot begin an identifier
+    source_file file("", "a\u0301 + e\u0301");
+    diagnostic::report report;
+    tokenized_list tokens = tokenize(file, report, symbols);
+    ASSERT_TRUE(report.errors().empty());
+    ASSERT_EQ(tokens.size(), 3);
+    ASSERT_EQ(tokens[0].source_location.chars, "a\u0301");
+
+    ASSERT_EQ(single_error("\u0301"), "stray character: U+0301");
+    ASSERT_EQ(single_error("a \u00A0"), "stray character: U+00A0");
+    ASSERT_EQ(single_error("❤"), "stray character: U+2764");
+}
+
+TEST(lex, invalid_utf8) {
+    auto assert_invalid = [](std::string_view source_str, size_t tokens) {
+        source_file file("", std::string(source_str));
+        diagnostic::report report;
+        symbol_table symbols;
+        ASSERT_EQ(tokenize(file, report, symbols).size(), tokens) << source_str;
+        ASSERT_FALSE(report.errors().empty()) << source_str;
+        for (const auto& error : report.errors()) {
+            ASSERT_EQ(error.error_code(), &error::E0012_invalid_utf8);
+        }
+    };
+    // consecutive invalid sequences are a single token (and error)
+    assert_invalid("\xC0\xAF", 1);         // overlong
+    assert_invalid("\xED\xA0\x80", 1);     // surrogate
+    assert_invalid("\xF4\x90\x80\x80", 1); // above U+10FFFF
+    assert_invalid("\xE2\x82", 1);         // truncated (one maximal subpart)
+    assert_invalid("\xE2\x82x", 2);
+    assert_invalid("\x80", 1);
+    assert_invalid("\x80 \x80", 2);
+
+    ASSERT_EQ(single_error("\xE2\x82"), "invalid UTF-8 sequence");
+    ASSERT_EQ(single_error("\xC0\xAF"), "2 invalid UTF-8 sequences");
+
+    // comments are not decoded, but they are still validated
+    assert_invalid("# \xC0\xAF é\n", 1);
+    assert_invalid("# \x80 é \xE2\x82\n", 1);
+    ASSERT_EQ(single_error("# é\xE2\x82"), "invalid UTF-8 sequence");
+    ASSERT_EQ(single_error("# \xC0\xAFé"), "2 invalid UTF-8 sequences");
+}
+
+TEST(lex, unicode_character_and_string_literals) {
+    ASSERT_EQ(char_value("'é'"), U'é');
+    ASSERT_EQ(char_value("'❤'"), U'❤');
+    ASSERT_EQ(char_value("'𝄞'"), U'𝄞');
+    ASSERT_EQ(char_value("'\\u{41}'"), U'A');
+    ASSERT_EQ(char_value("'\\u{1F600}'"), U'\U0001F600');
+    ASSERT_EQ(char_value("'\\u{10FFFF}'"), U'\U0010FFFF');
+
+    symbol_table symbols;
+    auto string_value = [&](std::string_view source_str) {
+        source_file file("", std::string(source_str));
+        diagnostic::report report;
+        tokenized_list tokens = tokenize(file, report, symbols);
+        EXPECT_TRUE(report.errors().empty()) << source_str;
+        EXPECT_EQ(tokens.size(), 3) << source_str;
+        return std::string(symbols[tokens[1].get_attribute<token::STRING>()]);
+    };
+    ASSERT_EQ(string_value("\"héllo, wörld\""), "héllo, wörld");
+    ASSERT_EQ(string_value("\"\\u{48}\\u{E9}\\u{2764}\""), "Hé❤");
+    ASSERT_EQ(string_value("\"\\u{1F600}!\""), "\U0001F600!");
+
+    ASSERT_EQ(single_error("'\\u41'"), "expected `{` after `\\u`");
+    ASSERT_EQ(single_error("'\\u{}'"), "missing code point digits");
+    ASSERT_EQ(single_error("'\\u{D800}'"), "invalid code point");
+    ASSERT_EQ(single_error("'\\u{110000}'"), "invalid code point");
+    ASSERT_EQ(single_error("'\\u{1234567}'"), "invalid code point");
+    ASSERT_EQ(
+        single_error("'\\u{41'"),
+        "expected `}` after the code point's digits"
+    );
+}
+
 } // namespace fp::lex
@@ -0,0 +1,145 @@
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <system_error>
+
+#include <gtest/gtest.h>
+
+#include <fp/source_code.h>
+
+namespace fp {
+
+TEST(source_code, line_offsets) {
+    // long enough lines to cross 16 byte boundaries
+    std::string content =
+        "first line\n"
+        "a somewhat longer second line\r\n"
+        "\r"
+        "\r\n"
+        "line ending with a CR at the end of 16 byte blocks\r\n"
+        "last line without a line break";
+    source_file file("", content);
+
+    std::vector<uint32_t> expected = {0};
+    for (size_t i = 0; i < content.size(); ++i) {
+        if (content[i] == '\r' && content[i + 1] == '\n') { continue; }
+        if (content[i] == '\n' || content[i] == '\r') {
+            expected.push_back(uint32_t(i + 1));
+        }
+    }
+    ASSERT_EQ(6u, expected.size());
+    ASSERT_EQ(expected, file.line_offsets());
+
+    for (size_t i = 0; i < content.size(); ++i) {
+        auto it = file.content.begin() + i;
+        size_t n = file.line_number(it);
+        ASSERT_LE(file.line_begin(n), it) << i;
+        if (n < expected.size()) {
+            ASSERT_LT(it, file.line_begin(n + 1)) << i;
+        }
+    }
+
+    ASSERT_EQ("first line", source_view(file.line_begin(1), file.line_end(1)));
+    ASSERT_EQ(
+        "a somewhat longer second line",
+        source_view(file.line_begin(2), file.line_end(2))
+    );
+    ASSERT_EQ("", source_view(file.line_begin(3), file.line_end(3)));
+    ASSERT_EQ("", source_view(file.line_begin(4), file.line_end(4)));
+    ASSERT_EQ(
+        "last line without a line break",
+        source_view(file.line_begin(6), file.line_end(6))
+    );
+}
+
+TEST(source_code, source_location_lines_are_resolved_lazily) {
+    source_file file("", "one\ntwo three\nfour");
+    source_location location {
+        .chars = file.content.substr(8, 5),
+        .file = file
+    };
+    ASSERT_EQ("three", location.chars);
+    ASSERT_EQ(8u, location.offset());
+    ASSERT_EQ(2u, location.line_number());
+    ASSERT_EQ(4u, location.column());
+    ASSERT_EQ(file.content.begin() + 4, location.line());
+
+    source_location end = location.slice_end();
+    ASSERT_EQ(13u, end.offset());
+    ASSERT_EQ(0u, end.chars.size());
+    ASSERT_EQ(2u, end.line_number());
+}
+
+TEST(source_code, section) {
+    // the lines "two three\nfour" of "one\ntwo three\nfour"
+    source_file section("", std::string("two three\nfour"), 4, 2);
+    source_location location {
+        .chars = section.content.substr(4, 5),
+        .file = section
+    };
+    ASSERT_EQ("three", location.chars);
+    ASSERT_EQ(8u, location.offset());
+    ASSERT_EQ(2u, location.line_number());
+    ASSERT_EQ(4u, location.column());
+
+    ASSERT_EQ(3u, section.line_number(section.content.end() - 1));
+    ASSERT_EQ(
+        "two three",
+        source_view(section.line_begin(2), section.line_end(2))
+    );
+    ASSERT_EQ(
+        "four",
+        source_view(section.line_begin(3), section.line_end(3))
+    );
+}
+
+TEST(source_code, map) {
+    // one file ends right at a page boundary, so its padding is outside of
+    // the pages of the file
+    for (size_t size : {0, 10, 4096, 10000}) {
+        std::string path = testing::TempDir() + "fp_source_code_map.fp";
+        std::string content(size, 'x');
+        for (size_t i = 0; i < size; i += 100) { content[i] = '\n'; }
+        std::ofstream(path, std::ios::binary) << content;
+
+        auto file = source_file::map(path);
+        ASSERT_EQ(file->name, path);
+        ASSERT_EQ(file->content, content);
+        ASSERT_TRUE(file->padded());
+        for (size_t i = 0; i < source_file::padding; ++i) {
+            ASSERT_EQ(file->content.data()[size + i], '\0') << size;
+        }
+        ASSERT_EQ(file->line_offsets().size(), (size + 99) / 100 + 1);
+        std::remove(path.c_str());
+    }
+    ASSERT_THROW(source_file::map("does/not/exist.fp"), std::system_error);
+}
+
+TEST(source_code, map_error_code) {
+    // the error code is the one of the failed call, not of the cleanup after it
+    try {
+        source_file::map("does/not/exist.fp");
+        FAIL();
+    } catch (const std::system_error& e) {
+        ASSERT_EQ(e.code().value(), ENOENT);
+    }
+    try {
+        // a directory can be opened, but not mapped
+        source_file::map(testing::TempDir());
+        FAIL();
+    } catch (const std::system_error& e) {
+        ASSERT_EQ(e.code().value(), ENODEV);
+    }
+}
+
+TEST(source_code, owned_content_is_padded) {
+    source_file owned("owned", std::string("abc"));
+    ASSERT_EQ(owned.content, "abc");
+    ASSERT_TRUE(owned.padded());
+    for (size_t i = 0; i < source_file::padding; ++i) {
+        ASSERT_EQ(owned.content.data()[3 + i], '\0');
+    }
+    ASSERT_FALSE(source_file("view", "abc").padded());
+}
+
+} // namespace fp
@@ -0,0 +1,92 @@
+#include <memory>
+#include <sstream>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include <fp/diagnostic/print/to_terminal.h>
+#include <fp/source_map.h>
+
+namespace fp {
+
+/// Returns the location of the `size` characters of `file` at `offset`.
+static source_location at(const source_file& file, size_t offset, size_t size) {
+    return {.chars = file.content.substr(offset, size), .file = file};
+}
+
+TEST(source_map, to_original) {
+    source_file a("a.fp", "let x = 1\nlet y = 2\n");
+    source_file b("b.fp", "print(x + y)\n");
+    // generated: "x = 1; x + y; y = 2"
+    source_file generated("", "x = 1; x + y; y = 2");
+    source_map map;
+    map.add(0, 5, a, 4);
+    map.add(7, 5, b, 6);
+    map.add(14, 1, a, 14);
+    map.add(15, 4, a, 15); // merged into the previous segment
+    ASSERT_EQ(map.size(), 3);
+
+    auto assert_maps_to = [&](
+        size_t offset,
+        size_t size,
+        const source_file& file,
+        size_t original_offset,
+        std::string_view chars
+    ) {
+        auto original = map.to_original(at(generated, offset, size));
+        ASSERT_TRUE(original.has_value()) << offset;
+        ASSERT_EQ(&original->file, &file) << offset;
+        ASSERT_EQ(original->offset(), original_offset) << offset;
+        ASSERT_EQ(original->chars, chars) << offset;
+    };
+    assert_maps_to(4, 1, a, 8, "1");
+    assert_maps_to(7, 5, b, 6, "x + y");
+    assert_maps_to(14, 5, a, 14, "y = 2");
+
+    // truncated at the end of the segment
+    assert_maps_to(2, 10, a, 6, "= 1");
+
+    // the end of a segment (only for empty locations) and unmapped characters
+    assert_maps_to(5, 0, a, 9, "");
+    assert_maps_to(19, 0, a, 19, "");
+    ASSERT_FALSE(map.to_original(at(generated, 5, 1)).has_value());
+    ASSERT_FALSE(map.to_original(at(generated, 13, 1)).has_value());
+}
+
+TEST(source_map, to_original_is_empty_without_segments) {
+    source_file generated("", "x");
+    ASSERT_FALSE(source_map().to_original(at(generated, 0, 1)).has_value());
+}
+
+TEST(source_map, diagnostics_point_at_the_original_file) {
+    source_file templ("template.fp", "greeting = \"hello, {name}\"\n");
+    auto intermediate = std::make_unique<source_file>(
+        "intermediate.fp", "# generated\nname = $\n"
+    );
+    auto map = std::make_unique<source_map>();
+    map->add(12, 9, templ, 18);
+    intermediate->set_origin(std::move(map));
+
+    source_file generated("generated.fp", "name = $\nbar = 1\n");
+    map = std::make_unique<source_map>();
+    map->add(0, 9, *intermediate, 12);
+    generated.set_origin(std::move(map));
+
+    diagnostic::report report;
+    report.add(diagnostic::error(&error::E0001_stray_character))
+        .add_primary(at(generated, 7, 1), "here")
+        .add_supplement(at(generated, 9, 3), "unmapped");
+    std::ostringstream os;
+    diagnostic::print::to_terminal(os, report);
+    std::string printed = os.str();
+
+    // mapped through the intermediate file to the template
+    ASSERT_NE(printed.find("template.fp"), std::string::npos) << printed;
+    ASSERT_NE(printed.find("hello, {name}"), std::string::npos) << printed;
+    ASSERT_EQ(printed.find("intermediate.fp"), std::string::npos) << printed;
+    // locations without an original location stay in the generated file
+    ASSERT_NE(printed.find("generated.fp"), std::string::npos) << printed;
+    ASSERT_NE(printed.find("= 1"), std::string::npos) << printed;
+}
+
+} // namespace fp
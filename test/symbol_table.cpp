@@ -0,0 +1,73 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fp/symbol_table.h>
+#include <fp/lex/tokenize.h>
+
+namespace fp {
+
+TEST(symbol_table, interned_strings_have_dense_ids) {
+    symbol_table symbols;
+    symbol_id x = symbols.intern("x");
+    symbol_id y = symbols.intern(std::string("y"));
+    ASSERT_EQ(x.index, 0);
+    ASSERT_EQ(y.index, 1);
+    ASSERT_EQ(symbols.intern("x"), x);
+    ASSERT_EQ(symbols.intern(""), symbol_id{2});
+    ASSERT_EQ(symbols.size(), 3);
+    ASSERT_EQ(symbols[x], "x");
+    ASSERT_EQ(symbols[y], "y");
+}
+
+TEST(symbol_table, many_strings) {
+    // enough strings to span many segments of IDs and all of the shards
+    symbol_table symbols;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        ASSERT_EQ(symbols.intern("s" + std::to_string(i)), symbol_id{i});
+    }
+    ASSERT_EQ(symbols.size(), 10000);
+    for (uint32_t i = 0; i < 10000; ++i) {
+        ASSERT_EQ(symbols[symbol_id{i}], "s" + std::to_string(i));
+        ASSERT_EQ(symbols.intern("s" + std::to_string(i)), symbol_id{i});
+    }
+}
+
+TEST(symbol_table, concurrent_interning) {
+    symbol_table symbols;
+    std::vector<std::vector<symbol_id>> ids(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < ids.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 1000; ++i) {
+                ids[t].push_back(symbols.intern(std::to_string(i)));
+            }
+        });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+
+    ASSERT_EQ(symbols.size(), 1000);
+    for (size_t t = 1; t < ids.size(); ++t) { ASSERT_EQ(ids[t], ids[0]); }
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(symbols[ids[0][i]], std::to_string(i));
+    }
+}
+
+TEST(symbol_table, tokenizer_interns_identifiers_and_strings) {
+    source_file file("", R"(foo "a\tb" foo "a{foo}\tb")");
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+    ASSERT_TRUE(report.errors().empty());
+
+    symbol_id foo = tokens[0].get_attribute<lex::token::IDENTIFIER>();
+    symbol_id str = tokens[2].get_attribute<lex::token::STRING>();
+    ASSERT_EQ(symbols[foo], "foo");
+    ASSERT_EQ(symbols[str], "a\tb");
+    ASSERT_EQ(tokens[4].get_attribute<lex::token::IDENTIFIER>(), foo);
+    ASSERT_EQ(symbols.size(), 4); // foo, "a\tb", "a", "\tb"
+}
+
+} // namespace fp
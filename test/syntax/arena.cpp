@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fp/syntax/ast/arena.h>
+
+namespace fp::syntax::ast {
+
+TEST(syntax, arena_allocations_are_aligned_and_stable) {
+    arena a;
+    std::vector<uint64_t*> numbers;
+    for (uint64_t i = 0; i < 10000; ++i) {
+        a.make<char>('x'); // misaligns the next allocation
+        numbers.push_back(a.make<uint64_t>(i));
+    }
+    for (uint64_t i = 0; i < numbers.size(); ++i) {
+        auto address = reinterpret_cast<uintptr_t>(numbers[i]);
+        ASSERT_EQ(address % alignof(uint64_t), 0);
+        ASSERT_EQ(*numbers[i], i);
+    }
+
+    // objects stay in place when the arena is moved
+    arena moved = std::move(a);
+    ASSERT_EQ(*numbers[42], 42);
+
+    // larger than any chunk
+    std::vector<int> large(1024 * 1024, 7);
+    std::span<const int> copy = moved.copy<int>(large);
+    ASSERT_NE(copy.data(), large.data());
+    ASSERT_TRUE(std::equal(copy.begin(), copy.end(), large.begin()));
+    ASSERT_GE(moved.allocated_bytes(), large.size() * sizeof(int));
+    ASSERT_TRUE(moved.copy<int>({}).empty());
+}
+
+TEST(syntax, arena_adopt) {
+    arena a;
+    arena b;
+    int* x = a.make<int>(1);
+    int* y = b.make<int>(2);
+    size_t allocated = a.allocated_bytes() + b.allocated_bytes();
+    a.adopt(std::move(b));
+    ASSERT_EQ(a.allocated_bytes(), allocated);
+    ASSERT_EQ(b.allocated_bytes(), 0);
+
+    // the adopted objects live as long as the adopting arena
+    arena c;
+    c.adopt(std::move(a));
+    ASSERT_EQ(*x, 1);
+    ASSERT_EQ(*y, 2);
+    ASSERT_EQ(*c.make<int>(3), 3);
+    ASSERT_EQ(c.allocated_bytes(), allocated);
+}
+
+TEST(syntax, arena_keep) {
+    auto counter = std::make_shared<int>(0);
+    {
+        arena a;
+        std::vector<std::shared_ptr<int>>* kept = a.keep(
+            std::make_unique<std::vector<std::shared_ptr<int>>>(3, counter)
+        );
+        ASSERT_EQ(kept->size(), 3);
+        ASSERT_EQ(counter.use_count(), 4);
+
+        // the kept objects are adopted along with the allocated ones (even by
+        // an arena without allocations, which keeps its own objects)
+        arena b;
+        b.keep(std::make_unique<std::shared_ptr<int>>(counter));
+        b.adopt(std::move(a));
+        ASSERT_EQ(counter.use_count(), 5);
+        arena c;
+        c.make<int>(1);
+        c.adopt(std::move(b));
+        ASSERT_EQ(counter.use_count(), 5);
+    }
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
+} // namespace fp::syntax::ast
@@ -0,0 +1,181 @@
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <fp/error_codes.h>
+#include <fp/lex/tokenize.h>
+#include <fp/syntax/parse.h>
+
+namespace fp::syntax {
+
+/// Returns the node of type `NodeType` that `node` refers to.
+template <class NodeType>
+const NodeType& get(const ast::node& node) {
+    return node.visit(
+        [](const NodeType& n) -> const NodeType& { return n; },
+        [](const auto&) -> const NodeType& {
+            throw std::bad_variant_access();
+        }
+    );
+}
+
+TEST(syntax, parse_into_arena) {
+    source_file file("", "-a + b * c++ = {x; y; 'z'}");
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+    ast::arena arena;
+    ast::node root = parse(tokens, arena, report);
+    ASSERT_TRUE(report.errors().empty());
+    ASSERT_GT(arena.allocated_bytes(), 0);
+
+    const auto& assign = get<ast::binary_op>(root);
+    ASSERT_EQ(assign.op(), lex::token::ASSIGN);
+    ASSERT_EQ(assign.source_location().chars, file.content);
+
+    const auto& add = get<ast::binary_op>(assign.lhs);
+    ASSERT_EQ(add.op(), lex::token::ADD);
+    ASSERT_TRUE(add.lhs.is<ast::prefix_op>());
+    ASSERT_TRUE(get<ast::binary_op>(add.rhs).rhs.is<ast::postfix_op>());
+
+    const auto& block = get<ast::block>(assign.rhs);
+    ASSERT_EQ(block.nodes.size(), 3);
+    ASSERT_EQ(block.separators.size(), 2);
+    ASSERT_EQ(get<ast::identifier>(block.nodes[1]).chars, "y");
+    ASSERT_EQ(get<ast::char_>(block.nodes[2]).value, U'z');
+    ASSERT_EQ(block.opening_brace->token, lex::token::L_BRACE);
+    ASSERT_EQ(block.closing_brace->token, lex::token::R_BRACE);
+}
+
+TEST(syntax, parse_if_at_end_of_input) {
+    // the missing condition and body have no source location
+    for (const char* content : {"if", "x = if", "if x"}) {
+        source_file file("", content);
+        diagnostic::report report;
+        symbol_table symbols;
+        lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+        ast::arena arena;
+        parse(tokens, arena, report);
+        ASSERT_FALSE(report.errors().empty()) << content;
+    }
+}
+
+TEST(syntax, parse_unterminated_block) {
+    for (const char* content : {"{a;", "{a", "x = {", "(a; {b"}) {
+        source_file file("", content);
+        diagnostic::report report;
+        symbol_table symbols;
+        lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+        ast::arena arena;
+        parse(tokens, arena, report);
+        ASSERT_FALSE(report.errors().empty()) << content;
+    }
+}
+
+/// Returns the number of errors reported when parsing `content`.
+static size_t count_errors(const std::string& content) {
+    source_file file("", content);
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+    ast::arena arena;
+    parse(tokens, arena, report);
+    return report.errors().size();
+}
+
+TEST(syntax, parse_error_recovery) {
+    // a single error for each erroneous statement, after which parsing
+    // continues from the next separator or closing bracket
+    ASSERT_EQ(count_errors("a b c d; e; f"), 1);
+    ASSERT_EQ(count_errors("f(x, y) + 1; g"), 1);
+    ASSERT_EQ(count_errors("a; }; b; c = d; }"), 2);
+    ASSERT_EQ(count_errors("{a b}; c"), 1);
+    ASSERT_EQ(count_errors("x = {a; ) b; c}; y"), 1);
+    ASSERT_EQ(count_errors("x = {a; b c}; y = {d; e}"), 1);
+    ASSERT_EQ(count_errors("a = ; b = -; c"), 2);
+    ASSERT_EQ(count_errors("{}"), 1);
+
+    source_file file("", "a = {b; c d (e}; f]; g");
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+    ast::arena arena;
+    ast::node root = parse(tokens, arena, report);
+    ASSERT_EQ(report.errors().size(), 2);
+    const auto& statements = get<ast::top_level_block>(root);
+    ASSERT_EQ(statements.nodes.size(), 3);
+    // the skipped parenthesis doesn't hide the brace that closes the block
+    const auto& block =
+        get<ast::block>(get<ast::binary_op>(statements.nodes[0]).rhs);
+    ASSERT_EQ(block.nodes.size(), 2);
+    ASSERT_EQ(get<ast::infix_error>(block.nodes[1]).lhs.tokens().size(), 1);
+    const auto& unmatched = get<ast::infix_error>(statements.nodes[1]);
+    ASSERT_EQ(unmatched.lhs.tokens().size(), 1);
+    ASSERT_EQ(get<ast::identifier>(statements.nodes[2]).chars, "g");
+}
+
+TEST(syntax, parse_error_recovery_is_proportional_to_errors) {
+    // each statement has many invalid tokens, but only one error
+    std::string invalid_tokens;
+    for (int i = 0; i < 1000; ++i) { invalid_tokens += "a = b c d e f g;\n"; }
+    ASSERT_EQ(count_errors(invalid_tokens), 1000);
+
+    // an unmatched closing brace doesn't affect the statements after it
+    std::string unmatched_brace = "x = {a; b}};\n";
+    for (int i = 0; i < 1000; ++i) { unmatched_brace += "y = {c; d};\n"; }
+    ASSERT_EQ(count_errors(unmatched_brace), 1);
+}
+
+/// Returns `content` nested in `depth` blocks and prefix operators.
+static std::string nested(const std::string& content, size_t depth) {
+    std::string result;
+    for (size_t i = 0; i < depth; ++i) { result += "{x; -"; }
+    result += content;
+    for (size_t i = 0; i < depth; ++i) { result += "}"; }
+    return result;
+}
+
+TEST(syntax, parse_too_deep) {
+    // far deeper than the stack of a recursive parser would allow
+    source_file file("", nested("a", 100000) + "; b");
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+    ast::arena arena;
+    ast::node root = parse(tokens, arena, report);
+    ASSERT_EQ(report.errors().size(), 1);
+    ASSERT_EQ(
+        report.errors().front().error_code(),
+        &error::E0014_nesting_too_deep
+    );
+    ASSERT_TRUE(root.is<ast::error>());
+    ASSERT_EQ(root.source_location().chars, file.content);
+}
+
+TEST(syntax, parse_max_nesting_depth) {
+    // each block and each prefix operator is one level
+    source_file file("", nested("a", 5));
+    for (size_t depth : {10, 11, 1000}) {
+        diagnostic::report report;
+        symbol_table symbols;
+        lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+        ast::arena arena;
+        ast::node root =
+            parse(tokens, arena, report, {.max_nesting_depth = depth});
+        ASSERT_TRUE(report.errors().empty()) << depth;
+        ASSERT_TRUE(root.is<ast::block>()) << depth;
+    }
+    for (size_t depth : {0, 1, 9}) {
+        diagnostic::report report;
+        symbol_table symbols;
+        lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+        ast::arena arena;
+        ast::node root =
+            parse(tokens, arena, report, {.max_nesting_depth = depth});
+        ASSERT_EQ(report.errors().size(), 1) << depth;
+        ASSERT_TRUE(root.is<ast::error>()) << depth;
+    }
+}
+
+} // namespace fp::syntax
@@ -0,0 +1,284 @@
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fp/lex/bracket_index.h>
+#include <fp/lex/retokenize.h>
+#include <fp/lex/tokenize.h>
+#include <fp/syntax/parse.h>
+#include <fp/syntax/ast/print/to_terminal.h>
+
+namespace fp::syntax {
+
+static std::string to_string(const ast::node& node) {
+    std::ostringstream os;
+    ast::print::to_terminal(os, node);
+    return os.str();
+}
+
+/**
+ * Returns the structure of the AST of `node`, in which all the deferred blocks
+ * are parsed and expanded.
+ */
+static std::string expanded(const ast::node& node) {
+    auto sequence = [](std::span<const ast::node> nodes) {
+        std::string result;
+        for (const ast::node& n : nodes) { result += expanded(n) + ";"; }
+        return result;
+    };
+    auto chars = [](const auto& n) {
+        return std::string(n.source_location().chars);
+    };
+    return node.visit(
+        [&](const ast::binary_op& n) {
+            std::string op(n.op_source_location().chars);
+            return "(" + expanded(n.lhs) + op + expanded(n.rhs) + ")";
+        },
+        [&](const ast::block& n) { return "{" + sequence(n.nodes) + "}"; },
+        [&](const ast::deferred_block& n) { return expanded(n.parse()); },
+        [&](const ast::if_& n) {
+            return "if(" + expanded(n.condition) + ")" + expanded(n.body);
+        },
+        [&](const ast::infix_error& n) {
+            return "infix_error(" + expanded(n.lhs) + ")";
+        },
+        [&](const ast::postfix_op& n) {
+            std::string op(n.op_source_location().chars);
+            return "(" + expanded(n.lhs) + op + ")";
+        },
+        [&](const ast::prefix_op& n) {
+            std::string op(n.op_source_location().chars);
+            return "(" + op + expanded(n.rhs) + ")";
+        },
+        [&](const ast::top_level_block& n) { return sequence(n.nodes); },
+        [&](const ast::error& n) { return "error(" + chars(n) + ")"; },
+        [&](const auto& n) { return chars(n); }
+    );
+}
+
+/// Returns the top-level deferred blocks of `root` (the RHS of assignments).
+static std::vector<const ast::deferred_block*> deferred_blocks(
+    const ast::node& root
+) {
+    std::vector<const ast::deferred_block*> blocks;
+    root.visit(
+        [&](const ast::top_level_block& n) {
+            for (const ast::node& statement : n.nodes) {
+                statement.visit(
+                    [&](const ast::binary_op& op) {
+                        op.rhs.visit(
+                            [&](const ast::deferred_block& block) {
+                                blocks.push_back(&block);
+                            },
+                            [](const auto&) {}
+                        );
+                    },
+                    [](const auto&) {}
+                );
+            }
+        },
+        [](const auto&) {}
+    );
+    return blocks;
+}
+
+static const std::string well_formed =
+    "a = {b; c = {d; e}; f}; g = -{h; i};\n"
+    "j = {{k; l}; {m; n = {o; p}}}; u = {v; w};";
+
+TEST(syntax, parse_outline_matches_parse) {
+    source_file file("", well_formed);
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::bracket_index brackets;
+    lex::tokenized_list tokens =
+        lex::tokenize(file, report, brackets, symbols);
+
+    ast::arena expected_arena;
+    ast::node expected = parse(tokens, expected_arena, report);
+    ASSERT_TRUE(report.errors().empty());
+
+    // with and without an index of the brackets
+    const std::vector<const lex::bracket_index*> indices = {&brackets, nullptr};
+    for (const lex::bracket_index* index : indices) {
+        diagnostic::report outline_report;
+        ast::arena arena;
+        ast::node root = parse(
+            tokens,
+            arena,
+            outline_report,
+            {.outline = true, .brackets = index}
+        );
+        ASSERT_EQ(deferred_blocks(root).size(), 3);
+        ASSERT_NE(to_string(root), to_string(expected));
+        ASSERT_EQ(expanded(root), expanded(expected));
+        ASSERT_TRUE(outline_report.errors().empty());
+
+        // the deferred blocks are parsed only once
+        for (const ast::deferred_block* block : deferred_blocks(root)) {
+            ASSERT_EQ(block->parse(), block->parse());
+        }
+    }
+
+    diagnostic::report parallel_report;
+    ast::arena parallel_arena;
+    ast::node parallel_root = parse_parallel(
+        tokens,
+        parallel_arena,
+        parallel_report,
+        {.jobs = 2, .min_segment_size = 8},
+        {.outline = true}
+    );
+    ASSERT_EQ(expanded(parallel_root), expanded(expected));
+}
+
+TEST(syntax, parse_outline_malformed_blocks) {
+    source_file file("", "a = {b; +}; c = {d; e");
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+    ast::arena arena;
+    ast::node root = parse(tokens, arena, report, {.outline = true});
+
+    // the unmatched brace is parsed right away, but the problems of the
+    // deferred block are only reported once it's parsed
+    size_t n_errors = report.errors().size();
+    ASSERT_EQ(n_errors, 1);
+    std::vector<const ast::deferred_block*> blocks = deferred_blocks(root);
+    ASSERT_EQ(blocks.size(), 1);
+    blocks[0]->parse();
+    ASSERT_GT(report.errors().size(), n_errors);
+
+    // a block that is nested too deeply only skips the rest of the block
+    source_file deep_file("", "a = {b; {c; {d; {e; f}}}}; g");
+    lex::tokenized_list deep_tokens = lex::tokenize(deep_file, report, symbols);
+    ast::arena deep_arena;
+    ast::node deep_root = parse(
+        deep_tokens,
+        deep_arena,
+        report,
+        {.max_nesting_depth = 4, .outline = true}
+    );
+    ASSERT_EQ(expanded(deep_root), "(a={b;{c;{d;error({e; f});};};});g;");
+}
+
+TEST(syntax, parse_outline_concurrently) {
+    std::string content;
+    for (int i = 0; i < 100; ++i) {
+        content += "x = {a; b = {c; d * e}; f = {g; {h; i}}};\n";
+    }
+    source_file file("", content);
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+
+    ast::arena expected_arena;
+    ast::node expected = parse(tokens, expected_arena, report);
+
+    ast::arena arena;
+    ast::node root = parse(tokens, arena, report, {.outline = true});
+    std::vector<const ast::deferred_block*> blocks = deferred_blocks(root);
+    ASSERT_EQ(blocks.size(), 100);
+
+    // all the threads get the same node of each block
+    std::vector<std::vector<ast::node>> parsed(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < parsed.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (const ast::deferred_block* block : blocks) {
+                parsed[t].push_back(block->parse());
+            }
+        });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+    for (size_t t = 1; t < parsed.size(); ++t) {
+        ASSERT_EQ(parsed[t], parsed[0]);
+    }
+    ASSERT_EQ(expanded(root), expanded(expected));
+    ASSERT_TRUE(report.errors().empty());
+}
+
+/// Returns the expanded statements of `ast` (see `expanded`).
+static std::string expanded(const piecewise_ast& ast) {
+    std::string result;
+    for (const ast::node& n : ast.statements()) { result += expanded(n) + ";"; }
+    return result;
+}
+
+/// Returns the top-level deferred blocks of `ast` (like `deferred_blocks`).
+static std::vector<const ast::deferred_block*> deferred_blocks(
+    const piecewise_ast& ast
+) {
+    std::vector<const ast::deferred_block*> blocks;
+    for (const ast::node& statement : ast.statements()) {
+        statement.visit(
+            [&](const ast::binary_op& op) {
+                op.rhs.visit(
+                    [&](const ast::deferred_block& block) {
+                        blocks.push_back(&block);
+                    },
+                    [](const auto&) {}
+                );
+            },
+            [](const auto&) {}
+        );
+    }
+    return blocks;
+}
+
+TEST(syntax, reparse_outline) {
+    auto file = std::make_shared<source_file>("", well_formed);
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::piecewise_tokens tokens(file, lex::tokenize(*file, report, symbols));
+    piecewise_ast ast = parse(tokens, report, {.outline = true});
+
+    source_edit edit{.offset = well_formed.find("g = "), .inserted = "k; "};
+    std::shared_ptr<const source_file> edited = file->edit(edit);
+    lex::retokenized_list r =
+        lex::retokenize(tokens, edited, edit, report, symbols);
+
+    lex::tokenized_list expected_tokens = r.tokens.expand();
+    ast::arena expected_arena;
+    ast::node expected = parse(expected_tokens, expected_arena, report);
+
+    // the reused deferred blocks stay deferred, or everything is parsed again
+    for (bool outline : {true, false}) {
+        piecewise_ast edited_ast = reparse(
+            ast, r, report, {.outline = outline}
+        );
+        ASSERT_EQ(deferred_blocks(edited_ast).size(), outline ? 3 : 0);
+        ASSERT_EQ(expanded(edited_ast), expanded(expected));
+    }
+    ASSERT_TRUE(report.errors().empty());
+}
+
+TEST(syntax, reparse_outline_leaves_it_unchanged) {
+    std::string content = "a = {b; c d}; c = {d; e}";
+    auto file = std::make_shared<source_file>("", content);
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::piecewise_tokens tokens(file, lex::tokenize(*file, report, symbols));
+    piecewise_ast ast = parse(tokens, report, {.outline = true});
+    size_t allocated = ast.pieces[0].arena->allocated_bytes();
+
+    source_edit edit{.offset = content.find("c = "), .inserted = "f; "};
+    std::shared_ptr<const source_file> edited = file->edit(edit);
+    lex::retokenized_list r =
+        lex::retokenize(tokens, edited, edit, report, symbols);
+
+    // a full reparse of an outline parses the deferred blocks into its own
+    // arena and report, rather than into those of the outline
+    diagnostic::report edited_report;
+    piecewise_ast edited_ast = reparse(ast, r, edited_report);
+    ASSERT_TRUE(report.errors().empty());
+    ASSERT_EQ(ast.pieces[0].arena->allocated_bytes(), allocated);
+    ASSERT_EQ(edited_report.errors().size(), 1);
+    ASSERT_TRUE(deferred_blocks(edited_ast).empty());
+    ASSERT_EQ(expanded(edited_ast), "(a={b;infix_error(c);});f;(c={d;e;});");
+}
+
+} // namespace fp::syntax
@@ -0,0 +1,105 @@
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fp/diagnostic/print/to_terminal.h>
+#include <fp/lex/tokenize.h>
+#include <fp/syntax/parse.h>
+#include <fp/syntax/ast/print/to_terminal.h>
+
+namespace fp::syntax {
+
+static std::string to_string(const ast::node& node) {
+    std::ostringstream os;
+    ast::print::to_terminal(os, node);
+    return os.str();
+}
+
+/// Returns the diagnostics of `report`, as printed to a terminal.
+static std::string printed(const diagnostic::report& report) {
+    std::ostringstream os;
+    diagnostic::print::to_terminal(os, report);
+    return os.str();
+}
+
+/**
+ * Asserts that parsing `file` in parallel (in segments of `segment_size`
+ * tokens) has the same result as parsing it sequentially.
+ */
+static void assert_same_as_sequential(
+    const source_file& file,
+    size_t segment_size,
+    const parsing_options& options = {}
+) {
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+
+    diagnostic::report sequential_report;
+    ast::arena sequential_arena;
+    ast::node expected =
+        parse(tokens, sequential_arena, sequential_report, options);
+
+    diagnostic::report parallel_report;
+    ast::arena arena;
+    ast::node root = parse_parallel(
+        tokens,
+        arena,
+        parallel_report,
+        {.jobs = 4, .min_segment_size = segment_size},
+        options
+    );
+    ASSERT_EQ(to_string(root), to_string(expected))
+        << "segment size " << segment_size;
+    ASSERT_EQ(printed(parallel_report), printed(sequential_report));
+}
+
+TEST(syntax, parse_parallel_matches_parse) {
+    // statements that span several lines, and unmatched brackets that change
+    // the nesting of the statements after them
+    const std::vector<std::string> lines = {
+        "a = 1; b = -c++ * 2; d = x * y;",
+        "e = {f; g - h / 2}; i ^= j << 2 | k;",
+        "l = {m;",
+        "  n = {o; p}; q",
+        "};",
+        "if x { y };",
+        "r = if; s",
+        "}; t = 1;",
+        "{ u; v",
+        "( w; x ] ;",
+        "{{{{{{a}}}}}}; -{-{-{-b}}};",
+        "'c'; 1.5e3; ;;",
+        "",
+    };
+    std::mt19937 random(2468);
+    for (int trial = 0; trial < 20; ++trial) {
+        std::string content;
+        for (int i = 0; i < 100; ++i) {
+            content += lines[random() % lines.size()];
+            content += "\n";
+        }
+        source_file file("", content);
+        for (size_t segment_size : {1, 3, 16, 100}) {
+            assert_same_as_sequential(file, segment_size);
+            assert_same_as_sequential(
+                file, segment_size, {.max_nesting_depth = 4}
+            );
+        }
+    }
+}
+
+TEST(syntax, parse_parallel_small_input) {
+    // inputs smaller than two segments are parsed sequentially
+    source_file file("", "a = 1; b");
+    assert_same_as_sequential(file, 1 << 16);
+    source_file empty("", "");
+    assert_same_as_sequential(empty, 1);
+    source_file single("", "a");
+    assert_same_as_sequential(single, 1);
+}
+
+} // namespace fp::syntax
@@ -0,0 +1,165 @@
+#include <memory>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fp/lex/retokenize.h>
+#include <fp/lex/tokenize.h>
+#include <fp/syntax/parse.h>
+#include <fp/syntax/ast/print/to_terminal.h>
+
+namespace fp::syntax {
+
+static std::string to_string(const ast::node& node) {
+    std::ostringstream os;
+    ast::print::to_terminal(os, node);
+    return os.str();
+}
+
+TEST(syntax, parse_top_level_statements) {
+    source_file file("", "a = 1; b; {c; d};");
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::tokenized_list tokens = lex::tokenize(file, report, symbols);
+    ast::arena arena;
+    ast::node root = parse(tokens, arena, report);
+    ASSERT_TRUE(report.errors().empty());
+    ASSERT_TRUE(root.is<ast::top_level_block>());
+    root.visit(
+        [](const ast::top_level_block& block) {
+            ASSERT_EQ(block.nodes.size(), 3);
+            ASSERT_EQ(block.separators.size(), 3);
+            ASSERT_TRUE(block.nodes[0].is<ast::binary_op>());
+            ASSERT_TRUE(block.nodes[2].is<ast::block>());
+        },
+        [](const auto&) {}
+    );
+}
+
+TEST(syntax, reparse_matches_parse) {
+    const std::vector<std::string> insertions = {
+        "", " ", "\n", "x", "1", "'c'", "+", "*", "-", "++", "= 2", ";", "; y;",
+        "{", "}", "(", ")", "[", "]", "\"", "{x}", "# c", "#", "//"
+    };
+    std::mt19937 random(4321);
+    auto uniform = [&](size_t n) {
+        return std::uniform_int_distribution<size_t>(0, n)(random);
+    };
+
+    std::string content;
+    for (int i = 0; i < 10; ++i) {
+        content += "a = 1; b = -c++ * 2; d = x * y; e; j = 'j'; k = m + n;\n";
+        content += "f = {g; h = (i + 1) * 2}; if x { y } # comment\n";
+        content += "s = \"a {b + \"c {d}\"} e\"; t = [u];\n";
+    }
+    auto base_file = std::make_shared<source_file>("", content);
+    diagnostic::report report;
+    symbol_table symbols;
+    lex::piecewise_tokens base_tokens(
+        base_file, lex::tokenize(*base_file, report, symbols)
+    );
+    piecewise_ast base_ast = parse(base_tokens, report);
+
+    // each trial applies a few consecutive edits to the same source code
+    for (int trial = 0; trial < 100; ++trial) {
+        std::shared_ptr<const source_file> file = base_file;
+        piecewise_ast ast = base_ast;
+        for (int i = 0; i < 3; ++i) {
+            diagnostic::report report;
+            size_t size = file->content.size();
+            size_t offset = uniform(size);
+            source_edit edit{
+                .offset = offset,
+                .removed = std::min(uniform(4), size - offset),
+                .inserted = insertions[uniform(insertions.size() - 1)]
+            };
+            std::shared_ptr<const source_file> edited = file->edit(edit);
+            lex::retokenized_list r = lex::retokenize(
+                ast.tokens(), edited, edit, report, symbols
+            );
+            piecewise_ast edited_ast = reparse(ast, r, report);
+
+            lex::tokenized_list expected_tokens = r.tokens.expand();
+            ast::arena expected_arena;
+            ast::node expected = parse(
+                expected_tokens, expected_arena, report
+            );
+            std::vector<ast::node> statements = edited_ast.statements();
+            std::span<const ast::node> expected_statements(&expected, 1);
+            std::span<const lex::token_iterator> expected_separators;
+            expected.visit(
+                [&](const ast::top_level_block& n) {
+                    expected_statements = n.nodes;
+                    expected_separators = n.separators;
+                },
+                [](const auto&) {}
+            );
+            ASSERT_EQ(statements.size(), expected_statements.size())
+                << edited->content;
+            for (size_t j = 0; j < statements.size(); ++j) {
+                ASSERT_EQ(
+                    to_string(statements[j]),
+                    to_string(expected_statements[j])
+                ) << edited->content;
+            }
+
+            // the separators of the shared statements are moved by the edits
+            size_t j = 0;
+            for (const piecewise_ast::piece& piece : edited_ast.pieces) {
+                for (lex::token_iterator separator : piece.separators) {
+                    ASSERT_LT(j, expected_separators.size());
+                    ASSERT_EQ(
+                        piece.tokens.offset_of(
+                            separator->source_location.chars.begin()
+                        ),
+                        expected_separators[j++]->source_location.offset()
+                    ) << edited->content;
+                }
+            }
+            ASSERT_EQ(j, expected_separators.size());
+
+            file = edited;
+            ast = std::move(edited_ast);
+        }
+    }
+}
+
+TEST(syntax, reparse_shares_statements) {
+    std::string content;
+    for (int i = 0; i < 100; ++i) { content += "a = b + c; "; }
+    auto file = std::make_shared<source_file>("", content);
+    diagnostic::report report;
+    symbol_table symbols;
+    piecewise_ast ast = parse(
+        lex::piecewise_tokens(file, lex::tokenize(*file, report, symbols)),
+        report
+    );
+
+    source_edit edit{.offset = content.size() / 2 + 4, .inserted = "-"};
+    std::shared_ptr<const source_file> edited = file->edit(edit);
+    lex::retokenized_list r = lex::retokenize(
+        ast.tokens(), edited, edit, report, symbols
+    );
+    piecewise_ast edited_ast = reparse(ast, r, report);
+    ASSERT_TRUE(report.errors().empty());
+
+    // only the edited statement is parsed again
+    ASSERT_EQ(edited_ast.pieces.size(), 3);
+    ASSERT_EQ(edited_ast.pieces[0].arena, ast.pieces[0].arena);
+    ASSERT_EQ(edited_ast.pieces[1].nodes.size(), 1);
+    ASSERT_EQ(edited_ast.pieces[2].arena, ast.pieces[0].arena);
+    ASSERT_EQ(
+        edited_ast.pieces[0].nodes.size() + edited_ast.pieces[2].nodes.size(),
+        99
+    );
+    ASSERT_EQ(
+        edited_ast.pieces[2].nodes.data(),
+        ast.pieces[0].nodes.data() + 51
+    );
+}
+
+} // namespace fp::syntax
@@ -0,0 +1,90 @@
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <fp/util/small_vector.h>
+
+namespace fp::util {
+
+TEST(util, small_vector_grows_from_inline_to_heap) {
+    small_vector<std::string, 2> v;
+    ASSERT_TRUE(v.empty());
+    ASSERT_TRUE(v.is_inline());
+    v.push_back("a");
+    v.emplace_back(3, 'b');
+    ASSERT_TRUE(v.is_inline());
+    ASSERT_EQ(v.capacity(), 2);
+    v.push_back("c");
+    ASSERT_FALSE(v.is_inline());
+    ASSERT_EQ(v.size(), 3);
+    ASSERT_EQ(v.front(), "a");
+    ASSERT_EQ(v[1], "bbb");
+    ASSERT_EQ(v.back(), "c");
+    v.pop_back();
+    v.pop_back();
+    ASSERT_EQ(v.size(), 1);
+    v.clear();
+    ASSERT_TRUE(v.empty());
+}
+
+TEST(util, small_vector_copy_and_move) {
+    for (size_t n : {1, 2, 5}) {
+        small_vector<std::string, 2> v;
+        for (size_t i = 0; i < n; ++i) { v.push_back(std::to_string(i)); }
+
+        small_vector<std::string, 2> copy = v;
+        ASSERT_EQ(copy.size(), n);
+        ASSERT_EQ(copy.back(), std::to_string(n - 1));
+
+        small_vector<std::string, 2> moved = std::move(v);
+        ASSERT_TRUE(v.empty());
+        ASSERT_TRUE(v.is_inline());
+        ASSERT_EQ(moved.size(), n);
+        ASSERT_EQ(moved.is_inline(), n <= 2);
+
+        copy = small_vector<std::string, 2>{"x"};
+        ASSERT_EQ(copy.size(), 1);
+        ASSERT_EQ(copy.front(), "x");
+        copy = moved;
+        ASSERT_EQ(copy.size(), n);
+        ASSERT_EQ(copy.front(), "0");
+    }
+}
+
+TEST(util, small_vector_push_back_of_own_element) {
+    // the element is copied before it's moved to the grown buffer
+    small_vector<std::string, 2> v{"a long string, which is not inline", "b"};
+    // from inline to heap, and from heap to heap
+    for (size_t capacity : {2, 4}) {
+        while (v.size() < capacity) { v.push_back("c"); }
+        ASSERT_EQ(v.capacity(), capacity);
+        v.push_back(v[0]);
+        ASSERT_EQ(v.back(), v[0]);
+    }
+    while (v.size() < v.capacity()) { v.push_back("c"); }
+    v.emplace_back(v[0], 2);
+    ASSERT_EQ(v.back(), "long string, which is not inline");
+}
+
+TEST(util, small_vector_of_non_assignable_elements) {
+    // like the frames of lex::detail::string_interpolation_stack
+    struct element {
+        const int value;
+        std::unique_ptr<int> owned;
+    };
+    small_vector<element, 1> v;
+    for (int i = 0; i < 10; ++i) {
+        v.push_back({i, std::make_unique<int>(i * i)});
+    }
+    small_vector<element, 1> w;
+    w = std::move(v);
+    ASSERT_EQ(w.size(), 10);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(w[i].value, i);
+        ASSERT_EQ(*w[i].owned, i * i);
+    }
+}
+
+} // namespace fp::util
@@ -0,0 +1,55 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <fp/util/thread_pool.h>
+
+namespace fp::util {
+
+TEST(util, thread_pool_runs_all_tasks) {
+    thread_pool pool(4);
+    ASSERT_EQ(pool.size(), 4);
+    std::atomic<size_t> sum = 0;
+    for (size_t i = 1; i <= 100; ++i) {
+        pool.submit([&sum, &pool, i]() {
+            // tasks submitted from a worker go to its own queue
+            pool.submit([&sum, i]() { sum += i; });
+        });
+    }
+    pool.wait();
+    ASSERT_EQ(sum, 5050);
+}
+
+TEST(util, thread_pool_wait_runs_tasks) {
+    // the only worker is blocked until another task runs, which is left to
+    // the waiting thread
+    thread_pool pool(1);
+    std::atomic<bool> started = false;
+    std::atomic<bool> unblocked = false;
+    pool.submit([&]() {
+        started = true;
+        while (!unblocked) { std::this_thread::yield(); }
+    });
+    while (!started) { std::this_thread::yield(); }
+    pool.submit([&]() { unblocked = true; });
+    pool.wait();
+    ASSERT_TRUE(unblocked);
+}
+
+TEST(util, thread_pool_rethrows_task_exceptions) {
+    thread_pool pool(2);
+    std::atomic<size_t> n = 0;
+    for (size_t i = 0; i < 10; ++i) {
+        pool.submit([&n, i]() {
+            ++n;
+            if (i == 3) { throw std::runtime_error("oops"); }
+        });
+    }
+    ASSERT_THROW(pool.wait(), std::runtime_error);
+    ASSERT_EQ(n, 10);
+    pool.wait(); // the exception is only thrown once
+}
+
+} // namespace fp::util